@@ -22,9 +22,11 @@
 #include <bitcoin/bitcoin/handlers.hpp>
 #include <bitcoin/bitcoin/version.hpp>
 #include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/block_view.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/compact.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/header_index.hpp>
 #include <bitcoin/bitcoin/chain/history.hpp>
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/input_point.hpp>
@@ -35,8 +37,12 @@
 #include <bitcoin/bitcoin/chain/point_value.hpp>
 #include <bitcoin/bitcoin/chain/points_value.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
+#include <bitcoin/bitcoin/chain/script_code_view.hpp>
+#include <bitcoin/bitcoin/chain/script_metadata.hpp>
 #include <bitcoin/bitcoin/chain/stealth.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/chain/transaction_view.hpp>
 #include <bitcoin/bitcoin/chain/witness.hpp>
 #include <bitcoin/bitcoin/config/authority.hpp>
 #include <bitcoin/bitcoin/config/base16.hpp>
@@ -75,20 +81,26 @@
 #include <bitcoin/bitcoin/log/features/metric.hpp>
 #include <bitcoin/bitcoin/log/features/rate.hpp>
 #include <bitcoin/bitcoin/log/features/timer.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/interpreter.hpp>
 #include <bitcoin/bitcoin/machine/number.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/program.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/machine/script_engine.hpp>
 #include <bitcoin/bitcoin/machine/script_pattern.hpp>
 #include <bitcoin/bitcoin/machine/script_version.hpp>
 #include <bitcoin/bitcoin/machine/sighash_algorithm.hpp>
+#include <bitcoin/bitcoin/machine/stack_element.hpp>
 #include <bitcoin/bitcoin/math/checksum.hpp>
 #include <bitcoin/bitcoin/math/crypto.hpp>
+#include <bitcoin/bitcoin/math/digest_cache.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/math/public_key_cache.hpp>
+#include <bitcoin/bitcoin/math/signature_cache.hpp>
 #include <bitcoin/bitcoin/math/stealth.hpp>
 #include <bitcoin/bitcoin/math/uint256.hpp>
 #include <bitcoin/bitcoin/message/address.hpp>
@@ -107,6 +119,7 @@
 #include <bitcoin/bitcoin/message/get_data.hpp>
 #include <bitcoin/bitcoin/message/get_headers.hpp>
 #include <bitcoin/bitcoin/message/header.hpp>
+#include <bitcoin/bitcoin/message/header_batch.hpp>
 #include <bitcoin/bitcoin/message/headers.hpp>
 #include <bitcoin/bitcoin/message/heading.hpp>
 #include <bitcoin/bitcoin/message/inventory.hpp>
@@ -153,8 +166,10 @@
 #include <bitcoin/bitcoin/utility/endian.hpp>
 #include <bitcoin/bitcoin/utility/exceptions.hpp>
 #include <bitcoin/bitcoin/utility/flush_lock.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/interprocess_lock.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/monitor.hpp>
 #include <bitcoin/bitcoin/utility/noncopyable.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
@@ -168,7 +183,9 @@
 #include <bitcoin/bitcoin/utility/sequencer.hpp>
 #include <bitcoin/bitcoin/utility/sequential_lock.hpp>
 #include <bitcoin/bitcoin/utility/serializer.hpp>
+#include <bitcoin/bitcoin/utility/sliding_window.hpp>
 #include <bitcoin/bitcoin/utility/socket.hpp>
+#include <bitcoin/bitcoin/utility/span_hasher.hpp>
 #include <bitcoin/bitcoin/utility/string.hpp>
 #include <bitcoin/bitcoin/utility/subscriber.hpp>
 #include <bitcoin/bitcoin/utility/synchronizer.hpp>
@@ -25,7 +25,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <boost/optional.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/header.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
@@ -34,6 +33,8 @@
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/asio.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -68,6 +69,12 @@ public:
         asio::time_point start_push;
         asio::time_point end_push;
         float cache_efficiency;
+
+        // Time spent in each of the independent check() stages.
+        asio::duration check_forward_reference;
+        asio::duration check_double_spend;
+        asio::duration check_merkle_root;
+        asio::duration check_transactions;
     };
 
     // Constructors.
@@ -98,10 +105,16 @@ public:
     static block factory_from_data(std::istream& stream, bool witness=false);
     static block factory_from_data(reader& source, bool witness=false);
 
+    /// Deserializing into an existing instance reuses the storage of its
+    /// transactions, inputs, outputs and scripts, so one block instance may
+    /// be recycled across blocks. Storage is released on failure or destruct.
     bool from_data(const data_chunk& data, bool witness=false);
     bool from_data(std::istream& stream, bool witness=false);
     bool from_data(reader& source, bool witness=false);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool witness=false);
+
     bool is_valid() const;
 
     // Serialization.
@@ -110,6 +123,9 @@ public:
     data_chunk to_data(bool witness=false) const;
     void to_data(std::ostream& stream, bool witness=false) const;
     void to_data(writer& sink, bool witness=false) const;
+
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool witness=false) const;
     hash_list to_hashes(bool witness=false) const;
 
     // Properties (size, accessors, cache).
@@ -174,6 +190,11 @@ public:
 
     code check() const;
     code check_transactions() const;
+
+    /// Parallel check, the independent stages run across the dispatcher.
+    /// Returns the same code as the serial overload (first failure in order).
+    /// This blocks the calling thread, which must not belong to the pool.
+    code check(dispatcher& dispatch) const;
     code accept(bool transactions=true) const;
     code accept(const chain_state& state, bool transactions=true) const;
     code accept_transactions(const chain_state& state) const;
@@ -181,26 +202,38 @@ public:
     code connect(const chain_state& state) const;
     code connect_transactions(const chain_state& state) const;
 
+    /// Parallel connect, input scripts are verified across the dispatcher.
+    /// Returns the same code as the serial overloads (first failure in order).
+    /// This blocks the calling thread, which must not belong to the pool.
+    code connect(dispatcher& dispatch) const;
+    code connect(const chain_state& state, dispatcher& dispatch) const;
+    code connect_transactions(const chain_state& state,
+        dispatcher& dispatch) const;
+
     // THIS IS FOR LIBRARY USE ONLY, DO NOT CREATE A DEPENDENCY ON IT.
     mutable validation validation;
 
 protected:
     void reset();
+    void recycle();
     size_t non_coinbase_input_count() const;
+    code check_structure() const;
+    code check_stage(size_t stage) const;
 
 private:
     chain::header header_;
     transaction::list transactions_;
 
-    // These share a mutext as they are not expected to contend.
-    mutable boost::optional<bool> segregated_;
-    mutable boost::optional<size_t> total_inputs_;
-    mutable boost::optional<size_t> base_size_;
-    mutable boost::optional<size_t> total_size_;
-    mutable upgrade_mutex mutex_;
+    // These are published once, so reads need no lock.
+    mutable lazy<bool> segregated_;
+    mutable lazy<size_t> total_inputs_;
+    mutable lazy<size_t> base_size_;
+    mutable lazy<size_t> total_size_;
 };
 
 } // namespace chain
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/chain/block.ipp>
+
 #endif
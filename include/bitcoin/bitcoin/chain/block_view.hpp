@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_VIEW_HPP
+#define LIBBITCOIN_CHAIN_BLOCK_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/transaction_view.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/**
+ * A read-only view of a wire serialized block. The view does not own the
+ * bytes, which must outlive it. Only the header and transaction count are
+ * read on construction, transactions are located or mapped on request.
+ */
+class BC_API block_view
+{
+public:
+    typedef std::vector<size_t> offsets;
+
+    block_view(data_slice data);
+
+    /// True if the header and transaction count are present.
+    bool is_valid() const;
+
+    data_slice data() const;
+    data_slice header_data() const;
+    size_t transaction_count() const;
+
+    /// The block (header) hash, hashed in place.
+    hash_digest hash() const;
+
+    /// The offset of each transaction from the start of the block.
+    /// This does not map inputs or outputs. Empty if any is invalid.
+    offsets transaction_offsets() const;
+
+    /// Map all transactions, empty if any is invalid.
+    transaction_view::list transactions() const;
+
+    /// Explicit conversions to the owning types (witness as from_data).
+    header to_header() const;
+    block to_block(bool witness=false) const;
+
+private:
+    const uint8_t* begin_;
+    const uint8_t* end_;
+    const uint8_t* transactions_;
+    size_t count_;
+    bool valid_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
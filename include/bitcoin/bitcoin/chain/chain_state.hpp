@@ -21,14 +21,18 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <istream>
 #include <memory>
-#include <deque>
 #include <bitcoin/bitcoin/config/checkpoint.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+#include <bitcoin/bitcoin/utility/sliding_window.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
 
 namespace libbitcoin { namespace chain {
 
@@ -37,9 +41,11 @@ class header;
 
 class BC_API chain_state {
 public:
-    typedef std::deque<uint32_t> bitss;
-    typedef std::deque<uint32_t> versions;
-    typedef std::deque<uint32_t> timestamps;
+    // Windows share storage between parent and child states.
+    typedef sliding_window<uint32_t> bitss;
+    typedef sliding_window<uint32_t> versions;
+    typedef sliding_window<uint32_t> timestamps;
+    typedef sliding_window<uint256_t> works;
     typedef struct { size_t count; size_t high; } range;
 
     typedef std::shared_ptr<chain_state> ptr;
@@ -103,9 +109,20 @@ public:
         hash_digest bip9_bit1_hash;
 
         /// Values must be ordered by height with high (block - 1) last.
-        struct {
+        class bits_window {
+        public:
             uint32_t self;
             bitss ordered;
+
+            /// The cumulative proof of ordered (modulo 2^256), aligned with
+            /// it. This is derived on chain state construction.
+            works const& cumulative() const {
+                return cumulative_;
+            }
+
+        private:
+            friend class chain_state;
+            works cumulative_;
         } bits;
 
         /// Values must be ordered by height with high (block - 1) last.
@@ -144,6 +161,26 @@ public:
 #endif //BITPRIM_CURRENCY_BCH
     );
 
+    /// Deserialization of a versioned snapshot, as written by to_data.
+    /// Returns nullptr if the snapshot is malformed, of another version, was
+    /// taken with other checkpoints, is not the state of the tip block or its
+    /// windows are not of the sizes mapped for its height and forks.
+    /// The checkpoints are referenced, so they must outlive the state.
+    static ptr factory_from_data(const data_chunk& data,
+        const checkpoints& checkpoints, const hash_digest& tip);
+    static ptr factory_from_data(std::istream& stream,
+        const checkpoints& checkpoints, const hash_digest& tip);
+    static ptr factory_from_data(reader& source,
+        const checkpoints& checkpoints, const hash_digest& tip);
+
+    /// Serialization of a snapshot, including forks, checkpoints and
+    /// activation times, from which the state can be restored without
+    /// querying ancestor headers.
+    data_chunk to_data() const;
+    void to_data(std::ostream& stream) const;
+    void to_data(writer& sink) const;
+    size_t serialized_size() const;
+
     /// Properties.
     size_t height() const;
     uint32_t enabled_forks() const;
@@ -236,6 +273,7 @@ private:
     static 
     bool is_daa_enabled(size_t height, uint32_t forks);
 
+    static data& cumulate(data& values);
     static data to_pool(chain_state const& top);
     static data to_block(chain_state const& pool, block const& block);
     static data to_header(chain_state const& parent, header const& header);
@@ -30,6 +30,7 @@
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -91,6 +92,9 @@ public:
     bool from_data(std::istream& stream, bool wire=true);
     bool from_data(reader& source, bool wire=true);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool wire=true);
+
     bool is_valid() const;
 
     // Serialization.
@@ -100,6 +104,9 @@ public:
     void to_data(std::ostream& stream, bool wire=true) const;
     void to_data(writer& sink, bool wire=true) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool wire=true) const;
+
     // Properties (size, accessors, cache).
     //-----------------------------------------------------------------------------
     static uint256_t proof(uint32_t bits);
@@ -136,6 +143,9 @@ public:
 
     hash_digest hash() const;
 
+    /// True if the hash is cached, so hash() does not compute it.
+    bool is_hashed() const;
+
 #ifdef BITPRIM_CURRENCY_LTC
     hash_digest litecoin_proof_of_work_hash() const;
 #endif //BITPRIM_CURRENCY_LTC
@@ -146,6 +156,10 @@ public:
     bool is_valid_timestamp() const;
     bool is_valid_proof_of_work(bool retarget=true) const;
 
+    /// The proof of work check of a header with the bits and pow hash.
+    static bool is_valid_proof_of_work(uint32_t bits,
+        const hash_digest& hash, bool retarget=true);
+
     code check(bool retarget=false) const;
     code accept(const chain_state& state) const;
 
@@ -160,8 +174,7 @@ protected:
     void invalidate_cache() const;
 
 private:
-    mutable upgrade_mutex mutex_;
-    mutable std::shared_ptr<hash_digest> hash_;
+    mutable lazy<hash_digest> hash_;
 
     uint32_t version_;
     hash_digest previous_block_hash_;
@@ -174,4 +187,6 @@ private:
 } // namespace chain
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/chain/header.ipp>
+
 #endif
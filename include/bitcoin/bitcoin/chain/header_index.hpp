@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_HEADER_INDEX_HPP
+#define LIBBITCOIN_CHAIN_HEADER_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// This class is not thread safe.
+/// A compact index of a header chain from genesis for header-first sync.
+/// Serialized headers, hashes and cumulative work are held in parallel arrays
+/// indexed by height, with an open addressing table from hash to height.
+class BC_API header_index
+{
+public:
+    typedef byte_array<80> header_data;
+    typedef boost::filesystem::path path;
+
+    header_index();
+
+    // Properties.
+    //-------------------------------------------------------------------------
+
+    /// The number of headers, one greater than the top height.
+    size_t size() const;
+    bool empty() const;
+
+    /// The height must be less than size.
+    const header_data& data(size_t height) const;
+    const hash_digest& hash(size_t height) const;
+    const uint256_t& work(size_t height) const;
+    header get(size_t height) const;
+
+    // Queries.
+    //-------------------------------------------------------------------------
+
+    /// Get the height of the indexed header with the hash.
+    bool get_height(size_t& out_height, const hash_digest& hash) const;
+
+    /// Get the hash of the ancestor at height of the indexed header with hash.
+    bool get_ancestor(hash_digest& out_hash, const hash_digest& hash,
+        size_t height) const;
+
+    /// The block locator of the top header (empty if there are no headers).
+    hash_list locator() const;
+
+    // Modifiers.
+    //-------------------------------------------------------------------------
+
+    /// Append a header that extends the top (any header when empty).
+    bool push(const header& header);
+    bool push(const header_data& data);
+
+    /// Remove the headers above height, such as for a reorganization.
+    void pop_above(size_t height);
+
+    void reserve(size_t count);
+    void clear();
+
+    // Persistence.
+    //-------------------------------------------------------------------------
+
+    /// Write the index to a memory mapped file, replacing any existing file.
+    /// A temporary file is written and then renamed over the target.
+    bool save(const path& file) const;
+
+    /// Replace the index with that of a memory mapped file written by save.
+    /// The hashes and work are recomputed from the headers and must match.
+    /// The index is cleared if the file is missing or malformed.
+    bool load(const path& file);
+
+private:
+    static const uint32_t empty_slot;
+
+    bool push(const header_data& data, const hash_digest& hash);
+    size_t slot(const hash_digest& hash) const;
+    void insert(uint32_t height);
+    void erase(uint32_t height);
+    void rehash(size_t slots);
+
+    // These are parallel by height.
+    std::vector<header_data> headers_;
+    std::vector<hash_digest> hashes_;
+    std::vector<uint256_t> works_;
+
+    // Linear probing slots holding height + 1 (empty_slot when unused).
+    std::vector<uint32_t> table_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -29,6 +29,7 @@
 #include <bitcoin/bitcoin/chain/witness.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -80,6 +81,9 @@ public:
     bool from_data(std::istream& stream, bool wire=true, bool witness=false);
     bool from_data(reader& source, bool wire=true, bool witness=false);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool wire=true, bool witness=false);
+
     bool is_valid() const;
 
     // Serialization.
@@ -89,6 +93,9 @@ public:
     void to_data(std::ostream& stream, bool wire=true, bool witness=false) const;
     void to_data(writer& sink, bool wire=true, bool witness=false) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool wire=true, bool witness=false) const;
+
     // Properties (size, accessors, cache).
     //-------------------------------------------------------------------------
 
@@ -143,15 +150,14 @@ public:
 
 protected:
     void reset();
+    void recycle();
     void invalidate_cache() const;
 
 private:
     typedef std::shared_ptr<wallet::payment_address::list> addresses_ptr;
 
-    addresses_ptr addresses_cache() const;
-
-    mutable upgrade_mutex mutex_;
-    mutable addresses_ptr addresses_;
+    // Copies share the published addresses.
+    mutable lazy<addresses_ptr> addresses_;
 
     output_point previous_output_;
     chain::script script_;
@@ -162,4 +168,6 @@ private:
 } // namespace chain
 } // namespace libbitcoin
 
-#endif
\ No newline at end of file
+#include <bitcoin/bitcoin/impl/chain/input.ipp>
+
+#endif
@@ -27,6 +27,7 @@
 #include <vector>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -85,6 +86,9 @@ public:
     bool from_data(std::istream& stream, bool wire=true);
     bool from_data(reader& source, bool wire=true, bool unused=false);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool wire=true, bool unused=false);
+
     bool is_valid() const;
 
     // Serialization.
@@ -94,6 +98,9 @@ public:
     void to_data(std::ostream& stream, bool wire=true) const;
     void to_data(writer& sink, bool wire=true, bool unused=false) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool wire=true, bool unused=false) const;
+
     // Properties (size, accessors, cache).
     //-------------------------------------------------------------------------
 
@@ -131,15 +138,14 @@ public:
 
 protected:
     void reset();
+    void recycle();
     void invalidate_cache() const;
 
 private:
     typedef std::shared_ptr<wallet::payment_address::list> addresses_ptr;
 
-    addresses_ptr addresses_cache() const;
-
-    mutable upgrade_mutex mutex_;
-    mutable addresses_ptr addresses_;
+    // Copies share the published addresses.
+    mutable lazy<addresses_ptr> addresses_;
 
     uint64_t value_;
     chain::script script_;
@@ -148,4 +154,6 @@ private:
 } // namespace chain
 } // namespace libbitcoin
 
-#endif
\ No newline at end of file
+#include <bitcoin/bitcoin/impl/chain/output.ipp>
+
+#endif
@@ -77,6 +77,9 @@ public:
     bool from_data(std::istream& stream, bool wire=true);
     bool from_data(reader& source, bool wire=true);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool wire=true);
+
     bool is_valid() const;
 
     // Serialization.
@@ -86,6 +89,9 @@ public:
     void to_data(std::ostream& stream, bool wire=true) const;
     void to_data(writer& sink, bool wire=true) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool wire=true) const;
+
     // Iteration (limited to store serialization).
     //-------------------------------------------------------------------------
 
@@ -168,4 +174,6 @@ struct tuple_size<bc::chain::point>
 
 } // namespace std
 
+#include <bitcoin/bitcoin/impl/chain/point.ipp>
+
 #endif
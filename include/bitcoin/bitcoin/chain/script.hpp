@@ -24,15 +24,20 @@
 #include <istream>
 #include <memory>
 #include <string>
+#include <bitcoin/bitcoin/chain/script_code_view.hpp>
+#include <bitcoin/bitcoin/chain/script_metadata.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/signature_cache.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
 #include <bitcoin/bitcoin/machine/script_pattern.hpp>
 #include <bitcoin/bitcoin/machine/script_version.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -87,6 +92,9 @@ public:
     bool from_data(std::istream& stream, bool prefix);
     bool from_data(reader& source, bool prefix);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool prefix);
+
     /// Deserialization invalidates the iterator.
     void from_operations(operation::list&& ops);
     void from_operations(const operation::list& ops);
@@ -105,6 +113,9 @@ public:
     void to_data(std::ostream& stream, bool prefix) const;
     void to_data(writer& sink, bool prefix) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool prefix) const;
+
     std::string to_string(uint32_t active_forks) const;
 
     // Iteration.
@@ -125,20 +136,40 @@ public:
     size_t serialized_size(bool prefix) const;
     const operation::list& operations() const;
 
+    /// The operations compiled for the bytecode engine.
+    const machine::bytecode& bytecode() const;
+
     // Signing.
     //-------------------------------------------------------------------------
 
+    /// The script code may be given as a script or as a view of one.
     static hash_digest generate_signature_hash(const transaction& tx,
-        uint32_t input_index, const script& script_code, uint8_t sighash_type,
-        script_version version=script_version::unversioned,
+        uint32_t input_index, const script_code_view& script_code,
+        uint8_t sighash_type, script_version version=script_version::unversioned,
         uint64_t value=max_uint64);
 
     static bool check_signature(const ec_signature& signature,
         uint8_t sighash_type, const data_chunk& public_key,
-        const script& script_code, const transaction& tx, uint32_t input_index,
+        const script_code_view& script_code, const transaction& tx,
+        uint32_t input_index, script_version version=script_version::unversioned,
+        uint64_t value=max_uint64);
+
+    /// Install a cache of verified signatures consulted by check_signature.
+    /// The cache is not owned, it must outlive installation (nullptr clears).
+    static void set_signature_cache(signature_cache* cache);
+
+    /// Queue the EC verification of a signature check unless it is cached.
+    /// Returns false if the check fails without verification (empty key).
+    static bool defer_signature(ec_verification::list& batch,
+        const ec_signature& signature, uint8_t sighash_type,
+        const data_chunk& public_key, const script_code_view& script_code,
+        const transaction& tx, uint32_t input_index,
         script_version version=script_version::unversioned,
         uint64_t value=max_uint64);
 
+    /// Verify queued signature checks, caching them if all are valid.
+    static bool verify_deferred(const ec_verification::list& batch);
+
     static bool create_endorsement(endorsement& out, const ec_secret& secret,
         const script& prevout_script, const transaction& tx,
         uint32_t input_index, uint8_t sighash_type,
@@ -193,6 +224,12 @@ public:
     // Utilities (non-static).
     //-------------------------------------------------------------------------
 
+    /// Patterns, sigops and flags, computed once and retained by copies.
+    const script_metadata& metadata() const;
+
+    /// The hash, public key or witness program of a pay pattern (or empty).
+    data_slice payload() const;
+
     /// Common pattern detection.
     data_chunk witness_program() const;
     script_version version() const;
@@ -216,12 +253,28 @@ public:
         const witness& input_witness, const script& prevout_script,
         uint64_t value);
 
+    /// Verify a p2pkh, p2pk or p2sh multisig spend without program evaluation.
+    /// Returns false if not such a template, in which case out is not set.
+    static bool verify_template(code& out, const transaction& tx,
+        uint32_t input_index, uint32_t forks, const script& input_script,
+        const witness& input_witness, const script& prevout_script);
+
+    /// Verify by program evaluation, regardless of template.
+    static code verify_program(const transaction& tx, uint32_t input_index,
+        uint32_t forks, const script& input_script,
+        const witness& input_witness, const script& prevout_script,
+        uint64_t value);
+
 protected:
     // So that input and output may call reset from their own.
     friend class input;
     friend class output;
 
+    // So that the script code may view the script bytes.
+    friend class script_code_view;
+
     void reset();
+    void recycle();
     bool is_pay_to_witness(uint32_t forks) const;
     bool is_pay_to_script_hash(uint32_t forks) const;
 
@@ -230,23 +283,33 @@ private:
     static data_chunk operations_to_data(const operation::list& ops);
     static hash_digest generate_unversioned_signature_hash(
         const transaction& tx, uint32_t input_index,
-        const script& script_code, uint8_t sighash_type);
+        const script_code_view& script_code, uint8_t sighash_type);
     static hash_digest generate_version_0_signature_hash(const transaction& tx,
-        uint32_t input_index, const script& script_code, uint64_t value,
-        uint8_t sighash_type);
+        uint32_t input_index, const script_code_view& script_code,
+        uint64_t value, uint8_t sighash_type);
 
-    void find_and_delete_(const data_chunk& endorsement);
+    static code verify_check_sig(const endorsement& endorsement,
+        const data_chunk& public_key, const script_code_view& script_code,
+        const transaction& tx, uint32_t input_index, uint32_t forks);
+    static code verify_check_multisig(const operation::list& input_ops,
+        const operation::list& embedded_ops,
+        const script_code_view& script_code, const transaction& tx,
+        uint32_t input_index, uint32_t forks);
+
+    bool contains_push(const data_chunk& value) const;
 
     data_chunk bytes_;
     bool valid_;
 
-    // These are protected by mutex.
-    mutable bool cached_;
-    mutable operation::list operations_;
-    mutable upgrade_mutex mutex_;
+    // These are published once, so reads need no lock.
+    mutable lazy<operation::list> operations_;
+    mutable lazy<machine::bytecode::ptr> bytecode_;
+    mutable lazy<script_metadata> metadata_;
 };
 
 } // namespace chain
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/chain/script.ipp>
+
 #endif
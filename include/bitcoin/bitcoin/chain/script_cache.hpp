@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SCRIPT_CACHE_HPP
+#define LIBBITCOIN_CHAIN_SCRIPT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/digest_cache.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+class transaction;
+
+/// This class is thread safe.
+/// A bounded set of inputs that have passed script::verify. Entries are salted
+/// hashes of the transaction witness hash, input index, active forks and the
+/// cached previous output (script and value), so a change to any of these,
+/// including a rule change, cannot produce a stale pass.
+class BC_API script_cache
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<script_cache> ptr;
+
+    static const size_t default_memory = 16 * 1024 * 1024;
+    static const size_t default_shards = 16;
+
+    /// Memory is the budget in bytes for stored entries (lower bounded).
+    script_cache(size_t memory=default_memory, size_t shards=default_shards);
+
+    /// True if the input has passed verification under the forks.
+    /// The previous output cache of the input must be populated.
+    bool contains(const transaction& tx, uint32_t input_index,
+        uint32_t forks) const;
+
+    /// Record an input that has passed verification under the forks.
+    void store(const transaction& tx, uint32_t input_index, uint32_t forks);
+
+    /// Remove all entries and reset counters.
+    void clear();
+
+    /// The number of entries the cache can hold.
+    size_t capacity() const;
+
+    /// The number of contains() calls that found the input.
+    size_t hits() const;
+
+    /// The number of contains() calls that did not find the input.
+    size_t misses() const;
+
+private:
+    hash_digest to_key(const transaction& tx, uint32_t input_index,
+        uint32_t forks) const;
+
+    hash_digest salt_;
+    digest_cache entries_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
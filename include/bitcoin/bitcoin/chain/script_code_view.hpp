@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SCRIPT_CODE_VIEW_HPP
+#define LIBBITCOIN_CHAIN_SCRIPT_CODE_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+class script;
+
+/**
+ * A read-only view of the script code of a signature check, the script from
+ * the last executed code separator. The view does not own the script, which
+ * must outlive it. Deleted endorsements are applied to a shared copy only if
+ * found, and code separators are skipped in serialization, so in the common
+ * case the script bytes are hashed in place. Code separators are counted on
+ * first use (which is not thread safe).
+ */
+class BC_API script_code_view
+{
+public:
+    /// An empty script code.
+    script_code_view();
+
+    /// View the script from a byte offset, which must be an op boundary.
+    script_code_view(const script& script, size_t offset=0);
+
+    /// View script bytes (without size prefix).
+    script_code_view(data_slice bytes);
+
+    /// Delete endorsements from the script code (consensus find_and_delete).
+    void find_and_delete(data_slice endorsement);
+    void find_and_delete(const data_stack& endorsements);
+
+    /// The script code bytes (including code separators).
+    data_slice data() const;
+
+    /// The number of code separator operations in the script code.
+    size_t separators() const;
+
+    // Serialization.
+    //-------------------------------------------------------------------------
+
+    /// Code separators are omitted unless separators is set.
+    data_chunk to_data(bool prefix, bool separators=true) const;
+    void to_data(writer& sink, bool prefix, bool separators=true) const;
+    size_t serialized_size(bool prefix, bool separators=true) const;
+
+private:
+    static const size_t uncounted;
+
+    const uint8_t* begin_;
+    const uint8_t* end_;
+    mutable size_t separators_;
+
+    // Shared by copies, set only once endorsements are found and deleted.
+    std::shared_ptr<const data_chunk> deleted_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
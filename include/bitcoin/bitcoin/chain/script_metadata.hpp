@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SCRIPT_METADATA_HPP
+#define LIBBITCOIN_CHAIN_SCRIPT_METADATA_HPP
+
+#include <cstdint>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/machine/script_pattern.hpp>
+#include <bitcoin/bitcoin/machine/script_version.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Properties of a script derived from its operations, computed once.
+struct script_metadata
+{
+    machine::script_pattern output_pattern =
+        machine::script_pattern::non_standard;
+    machine::script_pattern input_pattern =
+        machine::script_pattern::non_standard;
+
+    /// The witness program version, unversioned if not a witness program.
+    machine::script_version version = machine::script_version::unversioned;
+
+    /// Signature operations, multisig counted as 20 or by its key count.
+    uint32_t sigops = 0;
+    uint32_t accurate_sigops = 0;
+
+    /// Accurate sigops of the script in the last push of a relaxed push
+    /// script (the bip16 embedded script), otherwise zero.
+    uint32_t embedded_sigops = 0;
+
+    /// The hash, public key or witness program of a pay pattern, as a range
+    /// of the script bytes (without prefix), size zero if there is none.
+    uint32_t payload_offset = 0;
+    uint32_t payload_size = 0;
+
+    bool push_only = false;
+    bool relaxed_push = false;
+    bool unspendable = false;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -25,17 +25,18 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <boost/optional.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/thread.hpp>
 #include <bitcoin/bitcoin/utility/writer.hpp>
@@ -43,6 +44,8 @@
 namespace libbitcoin {
 namespace chain {
 
+class sighash_context;
+
 class BC_API transaction
 {
 public:
@@ -107,6 +110,9 @@ public:
     bool from_data(std::istream& stream, bool wire=true, bool witness=false, bool unconfirmed=false);
     bool from_data(reader& source, bool wire=true, bool witness=false, bool unconfirmed=false);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool wire=true, bool witness=false, bool unconfirmed=false);
+
     bool is_valid() const;
 
     // Serialization.
@@ -116,6 +122,9 @@ public:
     void to_data(std::ostream& stream, bool wire=true, bool witness=false, bool unconfirmed=false) const;
     void to_data(writer& sink, bool wire=true, bool witness=false, bool unconfirmed=false) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool wire=true, bool witness=false, bool unconfirmed=false) const;
+
     // Properties (size, accessors, cache).
     //-----------------------------------------------------------------------------
 
@@ -192,17 +201,41 @@ public:
     code connect(const chain_state& state) const;
     code connect_input(const chain_state& state, size_t input_index) const;
 
+    /// Install a cache of verified inputs consulted by connect_input.
+    /// The cache is not owned, it must outlive installation (nullptr clears).
+    static void set_script_cache(script_cache* cache);
+
     // THIS IS FOR LIBRARY USE ONLY, DO NOT CREATE A DEPENDENCY ON IT.
     mutable validation validation;
 
     bool is_standard() const;
 
 protected:
+    // So that script may share the unversioned signature hash state.
+    friend class script;
+
     void reset();
+    void recycle();
     void invalidate_cache() const;
+    hash_digest to_hash(bool witness) const;
     bool all_inputs_final() const;
+    std::shared_ptr<const sighash_context> unversioned_context() const;
 
 private:
+    template <typename Source, typename Put>
+    static bool read(Source& source, std::vector<Put>& puts, bool wire,
+        bool witness);
+
+    template <typename Sink, typename Put>
+    static void write(Sink& sink, const std::vector<Put>& puts, bool wire,
+        bool witness);
+
+    template <typename Source>
+    static void read_witnesses(Source& source, input::list& inputs);
+
+    template <typename Sink>
+    static void write_witnesses(Sink& sink, const input::list& inputs);
+
     uint32_t version_;
     uint32_t locktime_;
     input::list inputs_;
@@ -218,23 +251,21 @@ private:
     uint32_t cached_sigops_;
     bool cached_is_standard_;
 
-    // These share a mutex as they are not expected to conflict.
-    // These share a mutex as they are not expected to contend.
-    mutable hash_ptr hash_;
-    mutable hash_ptr witness_hash_;
-    mutable hash_ptr outputs_hash_;
-    mutable hash_ptr inpoints_hash_;
-    mutable hash_ptr sequences_hash_;
-    mutable upgrade_mutex hash_mutex_;
-
-    // These share a mutex as they are not expected to contend.
-    mutable boost::optional<uint64_t> total_input_value_;
-    mutable boost::optional<uint64_t> total_output_value_;
-    mutable boost::optional<bool> segregated_;
-    mutable upgrade_mutex mutex_;
+    // These are published once, so reads need no lock.
+    mutable lazy<hash_digest> hash_;
+    mutable lazy<hash_digest> witness_hash_;
+    mutable lazy<hash_digest> outputs_hash_;
+    mutable lazy<hash_digest> inpoints_hash_;
+    mutable lazy<hash_digest> sequences_hash_;
+    mutable lazy<std::shared_ptr<const sighash_context>> sighash_context_;
+    mutable lazy<uint64_t> total_input_value_;
+    mutable lazy<uint64_t> total_output_value_;
+    mutable lazy<bool> segregated_;
 };
 
 } // namespace chain
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/chain/transaction.ipp>
+
 #endif
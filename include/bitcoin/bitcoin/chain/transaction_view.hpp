@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_TRANSACTION_VIEW_HPP
+#define LIBBITCOIN_CHAIN_TRANSACTION_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/lazy.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/**
+ * A read-only view of a wire serialized transaction. The view does not own
+ * the bytes, which must outlive it. Only the transaction bounds are located
+ * on construction, inputs and outputs are mapped once on first access (which
+ * is thread safe). No script or witness bytes are copied.
+ */
+class BC_API transaction_view
+{
+public:
+    typedef std::vector<transaction_view> list;
+
+    /// An input of the viewed transaction.
+    struct input_view
+    {
+        typedef std::vector<input_view> list;
+
+        /// The previous output point (hash and index, 36 bytes).
+        data_slice previous_output;
+
+        /// The input script, without its size prefix.
+        data_slice script;
+
+        uint32_t sequence;
+
+        /// The serialized witness stack, empty if not segregated.
+        data_slice witness;
+
+        hash_digest previous_output_hash() const;
+        uint32_t previous_output_index() const;
+    };
+
+    /// An output of the viewed transaction.
+    struct output_view
+    {
+        typedef std::vector<output_view> list;
+
+        uint64_t value;
+
+        /// The output script, without its size prefix.
+        data_slice script;
+    };
+
+    /// Map the transaction at the start of data, which may extend beyond it.
+    transaction_view(data_slice data);
+
+    /// The size of the transaction at the start of data, zero if invalid.
+    static size_t serialized_size(data_slice data);
+
+    bool is_valid() const;
+    bool is_segregated() const;
+
+    /// The bytes of the transaction (only).
+    data_slice data() const;
+    size_t serialized_size() const;
+
+    uint32_t version() const;
+    uint32_t locktime() const;
+    const input_view::list& inputs() const;
+    const output_view::list& outputs() const;
+
+    /// The transaction hash (excludes witness), hashed in place.
+    hash_digest hash() const;
+
+    /// Explicit conversion to the owning type (witness as from_data).
+    transaction to_transaction(bool witness=false) const;
+
+private:
+    struct puts
+    {
+        input_view::list inputs;
+        output_view::list outputs;
+    };
+
+    const puts& map_puts() const;
+
+    const uint8_t* begin_;
+    const uint8_t* end_;
+    const uint8_t* body_;
+    const uint8_t* body_end_;
+    bool valid_;
+    bool segregated_;
+    uint32_t version_;
+    uint32_t locktime_;
+    mutable lazy<puts> puts_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -76,6 +76,9 @@ public:
     bool from_data(std::istream& stream, bool prefix);
     bool from_data(reader& source, bool prefix);
 
+    template <typename Reader, typename = IF_READER(Reader)>
+    bool from_data(Reader& source, bool prefix);
+
     /// The witness deserialized ccording to count and size prefixing.
     bool is_valid() const;
 
@@ -86,6 +89,9 @@ public:
     void to_data(std::ostream& stream, bool prefix) const;
     void to_data(writer& sink, bool prefix) const;
 
+    template <typename Writer, typename = IF_WRITER(Writer)>
+    void to_data(Writer& sink, bool prefix) const;
+
     std::string to_string() const;
 
     // Iteration.
@@ -140,4 +146,6 @@ private:
 } // namespace chain
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/chain/witness.ipp>
+
 #endif
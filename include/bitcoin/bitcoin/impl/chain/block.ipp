@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_BLOCK_IPP
+#define LIBBITCOIN_CHAIN_BLOCK_IPP
+
+#include <algorithm>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/utility/asio.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+// Full block deserialization is always canonical encoding.
+template <typename Reader, typename>
+bool block::from_data(Reader& source, bool witness)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    validation.start_deserialize = asio::steady_clock::now();
+    recycle();
+
+    if (!header_.from_data(source, true))
+        return false;
+
+    const auto count = source.read_size_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (count > get_max_block_size())
+        source.invalidate();
+    else
+        transactions_.resize(count);
+
+    // Order is required, explicit loop allows early termination.
+    for (auto& tx: transactions_)
+        if (!tx.from_data(source, true, witness))
+            break;
+
+    // TODO: optimize by having reader skip witness data.
+    if (!witness)
+        strip_witness();
+
+    if (!source)
+        reset();
+
+    validation.end_deserialize = asio::steady_clock::now();
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+// Full block serialization is always canonical encoding.
+template <typename Writer, typename>
+void block::to_data(Writer& sink, bool witness) const
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    header_.to_data(sink, true);
+    sink.write_size_little_endian(transactions_.size());
+    const auto to = [&sink, witness](const transaction& tx)
+    {
+        tx.to_data(sink, true, witness);
+    };
+
+    std::for_each(transactions_.begin(), transactions_.end(), to);
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_HEADER_IPP
+#define LIBBITCOIN_CHAIN_HEADER_IPP
+
+#include <cstdint>
+#include <bitcoin/bitcoin/utility/span_hasher.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+template <typename Reader, typename>
+bool header::from_data(Reader& source, bool wire)
+{
+    ////reset();
+    const span_hasher<Reader> hasher(source);
+
+    version_ = source.read_4_bytes_little_endian();
+    previous_block_hash_ = source.read_hash();
+    merkle_ = source.read_hash();
+    timestamp_ = source.read_4_bytes_little_endian();
+    bits_ = source.read_4_bytes_little_endian();
+    nonce_ = source.read_4_bytes_little_endian();
+
+    if (!wire)
+        validation.median_time_past = source.read_4_bytes_little_endian();
+
+    // The wire bytes are the hash preimage, hashed in place where possible.
+    hash_digest digest;
+
+    if (wire && hasher.hash(digest))
+        hash_.store(digest);
+    else
+        hash_.reset();
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+template <typename Writer, typename>
+void header::to_data(Writer& sink, bool wire) const
+{
+    sink.write_4_bytes_little_endian(version_);
+    sink.write_hash(previous_block_hash_);
+    sink.write_hash(merkle_);
+    sink.write_4_bytes_little_endian(timestamp_);
+    sink.write_4_bytes_little_endian(bits_);
+    sink.write_4_bytes_little_endian(nonce_);
+
+    if (!wire)
+        sink.write_4_bytes_little_endian(validation.median_time_past);
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
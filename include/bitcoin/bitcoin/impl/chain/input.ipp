@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_INPUT_IPP
+#define LIBBITCOIN_CHAIN_INPUT_IPP
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+template <typename Reader, typename>
+bool input::from_data(Reader& source, bool wire, bool witness)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#else
+    // Always write witness to store so that we know how to read it.
+    witness |= !wire;
+#endif
+
+    // Retain script storage, as this may be a recycled instance.
+    recycle();
+
+    if (!previous_output_.from_data(source, wire))
+        return false;
+
+    script_.from_data(source, true);
+
+    // Transaction from_data handles the discontiguous wire witness decoding.
+    if (witness && !wire)
+        witness_.from_data(source, true);
+
+    sequence_ = source.read_4_bytes_little_endian();
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+template <typename Writer, typename>
+void input::to_data(Writer& sink, bool wire, bool witness) const
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#else
+    // Always write witness to store so that we know how to read it.
+    witness |= !wire;
+#endif
+
+    previous_output_.to_data(sink, wire);
+    script_.to_data(sink, true);
+
+    // Transaction to_data handles the discontiguous wire witness encoding.
+    if (witness && !wire)
+        witness_.to_data(sink, true);
+
+    sink.write_4_bytes_little_endian(sequence_);
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_OUTPUT_IPP
+#define LIBBITCOIN_CHAIN_OUTPUT_IPP
+
+#include <cstdint>
+#include <bitcoin/bitcoin/math/limits.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+template <typename Reader, typename>
+bool output::from_data(Reader& source, bool wire, bool)
+{
+    // Retain script storage, as this may be a recycled instance.
+    recycle();
+
+    if (!wire)
+        validation.spender_height = source.read_4_bytes_little_endian();
+
+    value_ = source.read_8_bytes_little_endian();
+    script_.from_data(source, true);
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+template <typename Writer, typename>
+void output::to_data(Writer& sink, bool wire, bool) const
+{
+    if (!wire)
+    {
+        auto height32 = safe_unsigned<uint32_t>(validation.spender_height);
+        sink.write_4_bytes_little_endian(height32);
+    }
+
+    sink.write_8_bytes_little_endian(value_);
+    script_.to_data(sink, true);
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
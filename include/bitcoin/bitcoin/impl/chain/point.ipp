@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_POINT_IPP
+#define LIBBITCOIN_CHAIN_POINT_IPP
+
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+template <typename Reader, typename>
+bool point::from_data(Reader& source, bool wire)
+{
+    reset();
+
+    valid_ = true;
+    hash_ = source.read_hash();
+
+    if (wire)
+    {
+        index_ = source.read_4_bytes_little_endian();
+    }
+    else
+    {
+        index_ = source.read_2_bytes_little_endian();
+
+        if (index_ == max_uint16)
+            index_ = null_index;
+    }
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+template <typename Writer, typename>
+void point::to_data(Writer& sink, bool wire) const
+{
+    sink.write_hash(hash_);
+
+    if (wire)
+    {
+        sink.write_4_bytes_little_endian(index_);
+    }
+    else
+    {
+        BITCOIN_ASSERT(index_ == null_index || index_ < max_uint16);
+        sink.write_2_bytes_little_endian(static_cast<uint16_t>(index_));
+    }
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
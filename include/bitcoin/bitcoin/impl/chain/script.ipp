@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SCRIPT_IPP
+#define LIBBITCOIN_CHAIN_SCRIPT_IPP
+
+#include <bitcoin/bitcoin/constants.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+// Concurrent read/write is not supported, so no critical section.
+template <typename Reader, typename>
+bool script::from_data(Reader& source, bool prefix)
+{
+    // Retain storage, as this may be a recycled instance.
+    recycle();
+    valid_ = true;
+
+    if (prefix)
+    {
+        const auto size = source.read_size_little_endian();
+
+        // The max_script_size constant limits evaluation, but not all scripts
+        // evaluate, so use max_block_size to guard memory allocation here.
+        if (size > get_max_block_size())
+            source.invalidate();
+        else
+            source.read_bytes(bytes_, size);
+    }
+    else
+    {
+        bytes_ = source.read_bytes();
+    }
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+template <typename Writer, typename>
+void script::to_data(Writer& sink, bool prefix) const
+{
+    // TODO: optimize by always storing the prefixed serialization.
+    if (prefix)
+        sink.write_variable_little_endian(serialized_size(false));
+
+    sink.write_bytes(bytes_);
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_TRANSACTION_IPP
+#define LIBBITCOIN_CHAIN_TRANSACTION_IPP
+
+#include <algorithm>
+#include <vector>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/utility/span_hasher.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Utilities.
+//-----------------------------------------------------------------------------
+
+// Read a length-prefixed collection of inputs or outputs from the source.
+template <typename Source, typename Put>
+bool transaction::read(Source& source, std::vector<Put>& puts, bool wire,
+    bool witness)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+
+    auto result = true;
+    const auto count = source.read_size_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (count > get_max_block_size())
+        source.invalidate();
+    else
+        puts.resize(count);
+
+    const auto deserialize = [&](Put& put)
+    {
+        result = result && put.from_data(source, wire, witness);
+#ifndef NDBEUG
+        put.script().operations();
+#endif
+    };
+
+    std::for_each(puts.begin(), puts.end(), deserialize);
+    return result;
+}
+
+// Write a length-prefixed collection of inputs or outputs to the sink.
+template <typename Sink, typename Put>
+void transaction::write(Sink& sink, const std::vector<Put>& puts, bool wire,
+    bool witness)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    sink.write_variable_little_endian(puts.size());
+
+    const auto serialize = [&](const Put& put)
+    {
+        put.to_data(sink, wire, witness);
+    };
+
+    std::for_each(puts.begin(), puts.end(), serialize);
+}
+
+// Input list must be pre-populated as it determines witness count.
+template <typename Source>
+void transaction::read_witnesses(Source& source, input::list& inputs)
+{
+    const auto deserialize = [&](input& input)
+    {
+        input.witness().from_data(source, true);
+    };
+
+    std::for_each(inputs.begin(), inputs.end(), deserialize);
+}
+
+// Witness count is not written as it is inferred from input count.
+template <typename Sink>
+void transaction::write_witnesses(Sink& sink, const input::list& inputs)
+{
+    const auto serialize = [&sink](const input& input)
+    {
+        input.witness().to_data(sink, true);
+    };
+
+    std::for_each(inputs.begin(), inputs.end(), serialize);
+}
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+// Witness is not used by outputs, just for template normalization.
+template <typename Reader, typename>
+bool transaction::from_data(Reader& source, bool wire, bool witness, bool unconfirmed)
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    recycle();
+    const span_hasher<Reader> hasher(source);
+    auto segregated = false;
+
+    if (wire)
+    {
+        // Wire (satoshi protocol) deserialization.
+        version_ = source.read_4_bytes_little_endian();
+        read(source, inputs_, wire, witness);
+#ifdef BITPRIM_CURRENCY_BCH
+        const auto marker = false;
+#else
+        // Detect witness as no inputs (marker) and expected flag (bip144).
+        const auto marker = inputs_.size() == witness_marker &&
+            source.peek_byte() == witness_flag;
+#endif
+
+        // This is always enabled so caller should validate with is_segregated.
+        if (marker)
+        {
+            segregated = true;
+
+            // Skip over the peeked witness flag.
+            source.skip(1);
+            read(source, inputs_, wire, witness);
+            read(source, outputs_, wire, witness);
+            read_witnesses(source, inputs_);
+        }
+        else
+        {
+            read(source, outputs_, wire, witness);
+        }
+
+        locktime_ = source.read_4_bytes_little_endian();
+    }
+    else
+    {
+        // Database (outputs forward) serialization.
+        // Witness data is managed internal to inputs.
+        read(source, outputs_, wire, witness);
+        read(source, inputs_, wire, witness);
+        const auto locktime = source.read_variable_little_endian();
+        const auto version = source.read_variable_little_endian();
+
+        if (locktime > max_uint32 || version > max_uint32)
+            source.invalidate();
+
+        locktime_ = static_cast<uint32_t>(locktime);
+        version_ = static_cast<uint32_t>(version);
+        if(unconfirmed)
+        {
+            const auto sigops = source.read_4_bytes_little_endian();
+            cached_sigops_ = static_cast<uint32_t>(sigops);
+            const auto fees = source.read_8_bytes_little_endian();
+            cached_fees_ = static_cast<uint64_t>(fees);
+            const auto is_standard = source.read_byte();
+            cached_is_standard_ = static_cast<bool>(is_standard);
+        }
+
+    }
+
+    // TODO: optimize by having reader skip witness data.
+    if (!witness)
+        strip_witness();
+
+    // The wire bytes are the txid preimage unless they include witnesses or
+    // a non-minimal size encoding (which would not reserialize as read).
+    hash_digest digest;
+    if (!source)
+        reset();
+    else if (wire && !segregated &&
+        hasher.hash(digest, serialized_size(true, false)))
+        hash_.store(digest);
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+// Witness is not used by outputs, just for template normalization.
+template <typename Writer, typename>
+void transaction::to_data(Writer& sink, bool wire, bool witness, bool unconfirmed) const
+{
+#ifdef BITPRIM_CURRENCY_BCH
+    witness = false;
+#endif
+    if (wire)
+    {
+        // Witness handling must be disabled for non-segregated txs.
+        witness &= is_segregated();
+
+        // Wire (satoshi protocol) serialization.
+        sink.write_4_bytes_little_endian(version_);
+
+        if (witness)
+        {
+            sink.write_byte(witness_marker);
+            sink.write_byte(witness_flag);
+            write(sink, inputs_, wire, witness);
+            write(sink, outputs_, wire, witness);
+            write_witnesses(sink, inputs_);
+        }
+        else
+        {
+            write(sink, inputs_, wire, witness);
+            write(sink, outputs_, wire, witness);
+        }
+
+        sink.write_4_bytes_little_endian(locktime_);
+    }
+    else
+    {
+        // Database (outputs forward) serialization.
+        // Witness data is managed internal to inputs.
+        write(sink, outputs_, wire, witness);
+        write(sink, inputs_, wire, witness);
+        sink.write_variable_little_endian(locktime_);
+        sink.write_variable_little_endian(version_);
+        if(unconfirmed)
+        {
+            sink.write_4_bytes_little_endian(signature_operations());
+            sink.write_8_bytes_little_endian(fees());
+            sink.write_byte(is_standard());
+        }
+    }
+
+
+
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_WITNESS_IPP
+#define LIBBITCOIN_CHAIN_WITNESS_IPP
+
+#include <algorithm>
+#include <bitcoin/bitcoin/constants.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Deserialization.
+//-----------------------------------------------------------------------------
+
+// Prefixed data assumed valid here though caller may confirm with is_valid.
+template <typename Reader, typename>
+bool witness::from_data(Reader& source, bool prefix)
+{
+    reset();
+    valid_ = true;
+
+    const auto read_element = [](Reader& source)
+    {
+        // Tokens encoded as variable integer prefixed byte array (bip144).
+        const auto size = source.read_size_little_endian();
+
+        // The max_script_size and max_push_data_size constants limit
+        // evaluation, but not all stacks evaluate, so use max_block_weight
+        // to guard memory allocation here.
+        if (size > max_block_weight)
+        {
+            source.invalidate();
+            return data_chunk{};
+        }
+
+        return source.read_bytes(size);
+    };
+
+    // TODO: optimize store serialization to avoid loop, reading data directly.
+    if (prefix)
+    {
+        // Witness prefix is an element count, not byte length (unlike script).
+        // On wire each witness is prefixed with number of elements (bip144).
+        for (auto count = source.read_size_little_endian(); count > 0; --count)
+             stack_.push_back(read_element(source));
+    }
+    else
+    {
+        while (!source.is_exhausted())
+            stack_.push_back(read_element(source));
+    }
+
+    if (!source)
+        reset();
+
+    return source;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+template <typename Writer, typename>
+void witness::to_data(Writer& sink, bool prefix) const
+{
+    // Witness prefix is an element count, not byte length (unlike script).
+    if (prefix)
+        sink.write_size_little_endian(stack_.size());
+
+    const auto serialize = [&sink](const data_chunk& element)
+    {
+        // Tokens encoded as variable integer prefixed byte array (bip144).
+        sink.write_size_little_endian(element.size());
+        sink.write_bytes(element);
+    };
+
+    // TODO: optimize store serialization to avoid loop, writing data directly.
+    std::for_each(stack_.begin(), stack_.end(), serialize);
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
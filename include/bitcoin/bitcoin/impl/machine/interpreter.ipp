@@ -603,7 +603,7 @@ inline interpreter::result interpreter::op_ripemd160(program& program)
     if (program.empty())
         return error::op_ripemd160;
 
-    program.push_move(ripemd160_hash_chunk(program.pop()));
+    program.push_move(ripemd160_hash(program.pop()));
     return error::success;
 }
 
@@ -612,7 +612,7 @@ inline interpreter::result interpreter::op_sha1(program& program)
     if (program.empty())
         return error::op_sha1;
 
-    program.push_move(sha1_hash_chunk(program.pop()));
+    program.push_move(sha1_hash(program.pop()));
     return error::success;
 }
 
@@ -621,7 +621,7 @@ inline interpreter::result interpreter::op_sha256(program& program)
     if (program.empty())
         return error::op_sha256;
 
-    program.push_move(sha256_hash_chunk(program.pop()));
+    program.push_move(sha256_hash(program.pop()));
     return error::success;
 }
 
@@ -630,7 +630,7 @@ inline interpreter::result interpreter::op_hash160(program& program)
     if (program.empty())
         return error::op_hash160;
 
-    program.push_move(ripemd160_hash_chunk(sha256_hash(program.pop())));
+    program.push_move(ripemd160_hash(sha256_hash(program.pop())));
     return error::success;
 }
 
@@ -639,7 +639,7 @@ inline interpreter::result interpreter::op_hash256(program& program)
     if (program.empty())
         return error::op_hash256;
 
-    program.push_move(sha256_hash_chunk(sha256_hash(program.pop())));
+    program.push_move(sha256_hash(sha256_hash(program.pop())));
     return error::success;
 }
 
@@ -651,6 +651,13 @@ inline interpreter::result interpreter::op_codeseparator(program& program,
 }
 
 inline interpreter::result interpreter::op_check_sig_verify(program& program)
+{
+    // A failed check fails the script, so verification may be deferred.
+    return op_check_sig_verify(program, true);
+}
+
+inline interpreter::result interpreter::op_check_sig_verify(program& program,
+    bool deferrable)
 {
     if (program.size() < 2)
         return error::op_check_sig_verify1;
@@ -664,12 +671,12 @@ inline interpreter::result interpreter::op_check_sig_verify(program& program)
     const auto public_key = program.pop();
     auto endorsement = program.pop();
 
-    // Create a subscript with endorsements stripped (sort of).
-    chain::script script_code(program.subscript());
+    // View the subscript with endorsements stripped (sort of).
+    auto script_code = program.script_code();
 
     // BIP143: find and delete of the signature is not applied for v0.
     if (!(bip143 && program.version() == script_version::zero))
-        script_code.find_and_delete({ endorsement });
+        script_code.find_and_delete(endorsement);
 
     // BIP62: An empty endorsement is not considered lax encoding.
     if (!parse_endorsement(sighash, distinguished, std::move(endorsement)))
@@ -683,6 +690,14 @@ inline interpreter::result interpreter::op_check_sig_verify(program& program)
     // Version condition preserves independence of bip141 and bip143.
     auto version = bip143 ? program.version() : script_version::unversioned;
 
+    const auto deferred = program.deferred();
+
+    if (deferrable && deferred != nullptr)
+        return chain::script::defer_signature(*deferred, signature, sighash,
+            public_key, script_code, program.transaction(),
+                program.input_index(), version, program.value()) ?
+                    error::success : error::incorrect_signature;
+
     return chain::script::check_signature(signature, sighash, public_key,
         script_code, program.transaction(), program.input_index(),
             version, program.value()) ? error::success :
@@ -691,7 +706,8 @@ inline interpreter::result interpreter::op_check_sig_verify(program& program)
 
 inline interpreter::result interpreter::op_check_sig(program& program)
 {
-    const auto verified = op_check_sig_verify(program);
+    // The result is pushed to the stack, so verification cannot be deferred.
+    const auto verified = op_check_sig_verify(program, false);
 
     // BIP62: only lax encoding fails the operation.
     if (verified == error::invalid_signature_lax_encoding)
@@ -744,8 +760,8 @@ inline interpreter::result interpreter::op_check_multisig_verify(
     auto bip66 = chain::script::is_enabled(program.forks(), bip66_rule);
     auto bip143 = chain::script::is_enabled(program.forks(), bip143_rule);
 
-    // Before looping create subscript with endorsements stripped (sort of).
-    chain::script script_code(program.subscript());
+    // Before looping view subscript with endorsements stripped (sort of).
+    auto script_code = program.script_code();
 
     // BIP143: find and delete of the signature is not applied for v0.
     if (!(bip143 && program.version() == script_version::zero))
@@ -34,9 +34,9 @@ static const uint64_t negative_bit = number::negative_mask;
 static const uint64_t unsigned_max_int64 = bc::max_int64;
 static const uint64_t absolute_min_int64 = bc::min_int64;
 
-inline bool is_negative(const data_chunk& data)
+inline bool is_negative(data_slice data)
 {
-    return (data.back() & number::negative_mask) != 0;
+    return (data.data()[data.size() - 1] & number::negative_mask) != 0;
 }
 
 inline number::number()
@@ -53,7 +53,7 @@ inline number::number(int64_t value)
 //-----------------------------------------------------------------------------
 
 // The data is interpreted as little-endian.
-inline bool number::set_data(const data_chunk& data, size_t max_size)
+inline bool number::set_data(data_slice data, size_t max_size)
 {
     if (data.size() > max_size)
         return false;
@@ -65,7 +65,7 @@ inline bool number::set_data(const data_chunk& data, size_t max_size)
 
     // This is "from little endian" with a variable buffer.
     for (size_t i = 0; i != data.size(); ++i)
-        value_ |= static_cast<int64_t>(data[i]) << (8 * i);
+        value_ |= static_cast<int64_t>(data.data()[i]) << (8 * i);
 
     if (is_negative(data))
     {
@@ -22,7 +22,9 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <numeric>
 #include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/script_code_view.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/machine/number.hpp>
@@ -68,6 +70,16 @@ inline const chain::transaction& program::transaction() const
     return transaction_;
 }
 
+inline void program::set_deferred(ec_verification::list* batch)
+{
+    deferred_ = batch;
+}
+
+inline ec_verification::list* program::deferred() const
+{
+    return deferred_;
+}
+
 // Program registers.
 //-----------------------------------------------------------------------------
 
@@ -100,9 +112,14 @@ inline bool operation_overflow(size_t count)
 }
 
 inline bool program::increment_operation_count(const operation& op)
+{
+    return increment_operation_count(op.code());
+}
+
+inline bool program::increment_operation_count(opcode code)
 {
     // Addition is safe due to script size validation.
-    if (operation::is_counted(op.code()))
+    if (operation::is_counted(code))
         ++operation_count_;
 
     return !operation_overflow(operation_count_);
@@ -121,6 +138,14 @@ inline bool program::increment_operation_count(int32_t public_keys)
     return !operation_overflow(operation_count_);
 }
 
+// Count the operations of a branch jumped over by the bytecode engine.
+inline bool program::skip_operations(size_t counted)
+{
+    // Addition is safe due to script size validation.
+    operation_count_ += counted;
+    return !operation_overflow(operation_count_);
+}
+
 inline bool program::set_jump_register(const operation& op, int32_t offset)
 {
     if (script_.empty())
@@ -131,18 +156,28 @@ inline bool program::set_jump_register(const operation& op, int32_t offset)
         return &operation == &op;
     };
 
-    // This is not efficient but is simplifying and subscript is rarely used.
-    // Otherwise we must track the program counter through each evaluation.
-    jump_ = std::find_if(script_.begin(), script_.end(), finder);
+    // Code separators execute in script order, so search on from the last.
+    const auto separator = std::find_if(jump_, script_.end(), finder);
 
-    if (jump_ == script_.end())
+    if (separator == script_.end())
         return false;
 
     // This does not require guard because op_codeseparator can only increment.
     // Even if the opcode is last in the sequnce the increment is valid (end).
     BITCOIN_ASSERT_MSG(offset == 1, "unguarded jump offset");
 
-    jump_ += offset;
+    const auto jump = separator + offset;
+
+    // The script code is viewed from the byte offset of the jump register,
+    // advanced over only the operations passed since the last jump.
+    const auto op_size = [](size_t total, const operation& op)
+    {
+        return total + op.serialized_size();
+    };
+
+    jump_offset_ = std::accumulate(jump_, jump, jump_offset_, op_size);
+    jump_ = jump;
+    script_code_ = chain::script_code_view(script_, jump_offset_);
     return true;
 }
 
@@ -171,10 +206,10 @@ inline void program::push_copy(const value_type& item)
 //-----------------------------------------------------------------------------
 
 // This must be guarded.
-inline data_chunk program::pop()
+inline program::value_type program::pop()
 {
     BITCOIN_ASSERT(!empty());
-    const auto value = primary_.back();
+    auto value = std::move(primary_.back());
     primary_.pop_back();
     return value;
 }
@@ -253,8 +288,8 @@ inline void program::swap(size_t index_left, size_t index_right)
 {
     // TODO: refactor to allow DRY without const_cast here.
     std::swap(
-        const_cast<data_stack::value_type&>(item(index_left)),
-        const_cast<data_stack::value_type&>(item(index_right)));
+        const_cast<value_type&>(item(index_left)),
+        const_cast<value_type&>(item(index_right)));
 }
 
 // pop1/pop2/.../pop[pos-1]/pop[pos]/push[pos-1]/.../push2/push1
@@ -320,7 +355,7 @@ inline bool program::if_(const operation& op) const
     return op.is_conditional() || succeeded();
 }
 
-inline const data_stack::value_type& program::item(size_t index) /*const*/
+inline const program::value_type& program::item(size_t index) /*const*/
 {
     return *position(index);
 }
@@ -348,6 +383,12 @@ inline operation::list program::subscript() const
     return ops;
 }
 
+// The subscript as a view of the script, shared by its signature checks.
+inline const chain::script_code_view& program::script_code() const
+{
+    return script_code_;
+}
+
 inline size_t program::size() const
 {
     return primary_.size();
@@ -370,7 +411,7 @@ inline void program::push_alternate(value_type&& value)
 inline program::value_type program::pop_alternate()
 {
     BITCOIN_ASSERT(!alternate_.empty());
-    const auto value = alternate_.back();
+    auto value = std::move(alternate_.back());
     alternate_.pop_back();
     return value;
 }
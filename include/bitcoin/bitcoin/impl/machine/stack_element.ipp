@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_STACK_ELEMENT_IPP
+#define LIBBITCOIN_MACHINE_STACK_ELEMENT_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+inline stack_element::stack_element()
+  : size_(0)
+{
+}
+
+inline stack_element::stack_element(stack_element&& other)
+  : size_(other.size_), extended_(std::move(other.extended_))
+{
+    if (is_inline())
+        std::memcpy(inline_, other.inline_, size_);
+
+    other.size_ = 0;
+}
+
+inline stack_element::stack_element(const stack_element& other)
+  : size_(0)
+{
+    assign(other.begin(), other.end());
+}
+
+// A large item takes ownership of the buffer, so it is not copied.
+inline stack_element::stack_element(data_chunk&& data)
+  : size_(static_cast<uint32_t>(data.size()))
+{
+    if (is_inline())
+        assign(data.data(), data.data() + data.size());
+    else
+        extended_ = std::move(data);
+}
+
+inline stack_element::stack_element(const data_chunk& data)
+  : size_(0)
+{
+    assign(data.data(), data.data() + data.size());
+}
+
+inline stack_element::stack_element(const uint8_t* first,
+    const uint8_t* last)
+  : size_(0)
+{
+    assign(first, last);
+}
+
+inline stack_element::stack_element(std::initializer_list<uint8_t> data)
+  : size_(0)
+{
+    assign(data.begin(), data.end());
+}
+
+template <size_t Size>
+stack_element::stack_element(const byte_array<Size>& data)
+  : size_(0)
+{
+    assign(data.data(), data.data() + Size);
+}
+
+// Operators.
+//-----------------------------------------------------------------------------
+
+inline stack_element& stack_element::operator=(stack_element&& other)
+{
+    if (this == &other)
+        return *this;
+
+    size_ = other.size_;
+    extended_ = std::move(other.extended_);
+
+    if (is_inline())
+        std::memcpy(inline_, other.inline_, size_);
+
+    other.size_ = 0;
+    return *this;
+}
+
+inline stack_element& stack_element::operator=(const stack_element& other)
+{
+    if (this != &other)
+        assign(other.begin(), other.end());
+
+    return *this;
+}
+
+inline bool stack_element::operator==(const stack_element& other) const
+{
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+inline bool stack_element::operator!=(const stack_element& other) const
+{
+    return !(*this == other);
+}
+
+inline stack_element::operator data_chunk() const
+{
+    return is_inline() ? data_chunk(begin(), end()) : extended_;
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+inline bool stack_element::empty() const
+{
+    return size_ == 0;
+}
+
+inline size_t stack_element::size() const
+{
+    return size_;
+}
+
+inline const uint8_t* stack_element::data() const
+{
+    return is_inline() ? inline_ : extended_.data();
+}
+
+inline stack_element::const_iterator stack_element::begin() const
+{
+    return data();
+}
+
+inline stack_element::const_iterator stack_element::end() const
+{
+    return data() + size_;
+}
+
+// This must be guarded.
+inline uint8_t stack_element::back() const
+{
+    BITCOIN_ASSERT(!empty());
+    return data()[size_ - 1];
+}
+
+inline uint8_t stack_element::operator[](size_t index) const
+{
+    BITCOIN_ASSERT(index < size_);
+    return data()[index];
+}
+
+// private
+inline void stack_element::assign(const uint8_t* first, const uint8_t* last)
+{
+    size_ = static_cast<uint32_t>(std::distance(first, last));
+
+    if (is_inline())
+    {
+        // An empty range may be null, which memcpy does not permit.
+        if (size_ != 0)
+            std::memcpy(inline_, first, size_);
+
+        extended_.clear();
+    }
+    else
+    {
+        extended_.assign(first, last);
+    }
+}
+
+// private
+inline bool stack_element::is_inline() const
+{
+    return size_ <= inline_size;
+}
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,400 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_UINT256_IPP
+#define LIBBITCOIN_UINT256_IPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libbitcoin {
+
+inline uint256_t::uint256_t(const byte_array<32>& little_endian)
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+    {
+        uint64_t value = 0;
+
+        for (size_t byte = 8; byte > 0; --byte)
+            value = (value << 8) | little_endian[limb * 8 + byte - 1];
+
+        limbs_[limb] = value;
+    }
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+inline size_t uint256_t::bit_length() const
+{
+    for (size_t limb = 4; limb > 0; --limb)
+    {
+        auto value = limbs_[limb - 1];
+
+        if (value == 0)
+            continue;
+
+#ifdef __GNUC__
+        const size_t bits = 64 - __builtin_clzll(value);
+#else
+        size_t bits = 0;
+        for (; value != 0; value >>= 1)
+            ++bits;
+#endif
+
+        return (limb - 1) * 64 + bits;
+    }
+
+    return 0;
+}
+
+inline size_t uint256_t::byte_length() const
+{
+    return (bit_length() + 7) / 8;
+}
+
+inline byte_array<32> uint256_t::hash() const
+{
+    byte_array<32> out;
+
+    for (size_t limb = 0; limb < 4; ++limb)
+        for (size_t byte = 0; byte < 8; ++byte)
+            out[limb * 8 + byte] = static_cast<uint8_t>(
+                limbs_[limb] >> (8 * byte));
+
+    return out;
+}
+
+inline int uint256_t::compare(const uint256_t& other) const
+{
+    for (size_t limb = 4; limb > 0; --limb)
+        if (limbs_[limb - 1] != other.limbs_[limb - 1])
+            return limbs_[limb - 1] < other.limbs_[limb - 1] ? -1 : 1;
+
+    return 0;
+}
+
+inline uint256_t::operator bool() const
+{
+    return (limbs_[0] | limbs_[1] | limbs_[2] | limbs_[3]) != 0;
+}
+
+// Operators.
+//-----------------------------------------------------------------------------
+
+inline uint256_t uint256_t::operator~() const
+{
+    return{ ~limbs_[0], ~limbs_[1], ~limbs_[2], ~limbs_[3] };
+}
+
+inline uint256_t uint256_t::operator-() const
+{
+    return ++(~*this);
+}
+
+inline uint256_t& uint256_t::operator++()
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+        if (++limbs_[limb] != 0)
+            break;
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator--()
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+        if (limbs_[limb]-- != 0)
+            break;
+
+    return *this;
+}
+
+inline uint256_t uint256_t::operator++(int)
+{
+    const auto copy = *this;
+    ++(*this);
+    return copy;
+}
+
+inline uint256_t uint256_t::operator--(int)
+{
+    const auto copy = *this;
+    --(*this);
+    return copy;
+}
+
+inline uint256_t& uint256_t::operator+=(const uint256_t& other)
+{
+    uint64_t carry = 0;
+
+    for (size_t limb = 0; limb < 4; ++limb)
+    {
+        const auto sum = limbs_[limb] + other.limbs_[limb];
+        const auto total = sum + carry;
+        carry = (sum < limbs_[limb] || total < sum) ? 1 : 0;
+        limbs_[limb] = total;
+    }
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator-=(const uint256_t& other)
+{
+    uint64_t borrow = 0;
+
+    for (size_t limb = 0; limb < 4; ++limb)
+    {
+        const auto left = limbs_[limb];
+        const auto right = other.limbs_[limb];
+        const auto difference = left - right;
+        limbs_[limb] = difference - borrow;
+        borrow = (left < right || difference < borrow) ? 1 : 0;
+    }
+
+    return *this;
+}
+
+inline uint64_t uint256_t::multiply(uint64_t left, uint64_t right,
+    uint64_t& high)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+    const auto product = static_cast<uint128>(left) * right;
+    high = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+#else
+    const auto left_low = left & 0xffffffff;
+    const auto left_high = left >> 32;
+    const auto right_low = right & 0xffffffff;
+    const auto right_high = right >> 32;
+
+    const auto low_low = left_low * right_low;
+    const auto high_low = left_high * right_low;
+    const auto low_high = left_low * right_high;
+    const auto middle = (low_low >> 32) + (high_low & 0xffffffff) + low_high;
+
+    high = left_high * right_high + (high_low >> 32) + (middle >> 32);
+    return (middle << 32) | (low_low & 0xffffffff);
+#endif
+}
+
+inline uint256_t& uint256_t::operator*=(const uint256_t& other)
+{
+    uint64_t product[4] = { 0, 0, 0, 0 };
+
+    for (size_t left = 0; left < 4; ++left)
+    {
+        if (limbs_[left] == 0)
+            continue;
+
+        uint64_t carry = 0;
+
+        // Products at or above 2^256 are discarded (modular arithmetic).
+        for (size_t right = 0; left + right < 4; ++right)
+        {
+            uint64_t high;
+            auto low = multiply(limbs_[left], other.limbs_[right], high);
+            low += carry;
+            high += (low < carry) ? 1 : 0;
+            product[left + right] += low;
+            high += (product[left + right] < low) ? 1 : 0;
+            carry = high;
+        }
+    }
+
+    for (size_t limb = 0; limb < 4; ++limb)
+        limbs_[limb] = product[limb];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator/=(const uint256_t& other)
+{
+    uint256_t remainder;
+    divide(*this, remainder, *this, other);
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator%=(const uint256_t& other)
+{
+    uint256_t quotient;
+    divide(quotient, *this, *this, other);
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator&=(const uint256_t& other)
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+        limbs_[limb] &= other.limbs_[limb];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator|=(const uint256_t& other)
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+        limbs_[limb] |= other.limbs_[limb];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator^=(const uint256_t& other)
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+        limbs_[limb] ^= other.limbs_[limb];
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator<<=(uint32_t shift)
+{
+    const size_t limbs = shift / 64;
+    const auto bits = shift % 64;
+
+    // Descending, so each source limb is read before it is overwritten.
+    for (size_t limb = 4; limb > 0; --limb)
+    {
+        const auto target = limb - 1;
+        uint64_t value = 0;
+
+        if (shift < 256 && target >= limbs)
+        {
+            value = limbs_[target - limbs] << bits;
+
+            if (bits != 0 && target > limbs)
+                value |= limbs_[target - limbs - 1] >> (64 - bits);
+        }
+
+        limbs_[target] = value;
+    }
+
+    return *this;
+}
+
+inline uint256_t& uint256_t::operator>>=(uint32_t shift)
+{
+    const size_t limbs = shift / 64;
+    const auto bits = shift % 64;
+
+    // Ascending, so each source limb is read before it is overwritten.
+    for (size_t target = 0; target < 4; ++target)
+    {
+        uint64_t value = 0;
+
+        if (shift < 256 && target + limbs < 4)
+        {
+            value = limbs_[target + limbs] >> bits;
+
+            if (bits != 0 && target + limbs + 1 < 4)
+                value |= limbs_[target + limbs + 1] << (64 - bits);
+        }
+
+        limbs_[target] = value;
+    }
+
+    return *this;
+}
+
+// Non-member operators.
+//-----------------------------------------------------------------------------
+
+inline uint256_t operator+(uint256_t left, const uint256_t& right)
+{
+    return left += right;
+}
+
+inline uint256_t operator-(uint256_t left, const uint256_t& right)
+{
+    return left -= right;
+}
+
+inline uint256_t operator*(uint256_t left, const uint256_t& right)
+{
+    return left *= right;
+}
+
+inline uint256_t operator/(uint256_t left, const uint256_t& right)
+{
+    return left /= right;
+}
+
+inline uint256_t operator%(uint256_t left, const uint256_t& right)
+{
+    return left %= right;
+}
+
+inline uint256_t operator&(uint256_t left, const uint256_t& right)
+{
+    return left &= right;
+}
+
+inline uint256_t operator|(uint256_t left, const uint256_t& right)
+{
+    return left |= right;
+}
+
+inline uint256_t operator^(uint256_t left, const uint256_t& right)
+{
+    return left ^= right;
+}
+
+inline uint256_t operator<<(uint256_t left, uint32_t shift)
+{
+    return left <<= shift;
+}
+
+inline uint256_t operator>>(uint256_t left, uint32_t shift)
+{
+    return left >>= shift;
+}
+
+inline bool operator==(const uint256_t& left, const uint256_t& right)
+{
+    return left[0] == right[0] && left[1] == right[1] &&
+        left[2] == right[2] && left[3] == right[3];
+}
+
+inline bool operator!=(const uint256_t& left, const uint256_t& right)
+{
+    return !(left == right);
+}
+
+inline bool operator<(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) < 0;
+}
+
+inline bool operator>(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) > 0;
+}
+
+inline bool operator<=(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) <= 0;
+}
+
+inline bool operator>=(const uint256_t& left, const uint256_t& right)
+{
+    return left.compare(right) >= 0;
+}
+
+} // namespace libbitcoin
+
+#endif
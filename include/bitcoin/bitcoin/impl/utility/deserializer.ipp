@@ -257,6 +257,26 @@ data_chunk deserializer<Iterator, CheckSafe>::read_bytes(size_t size)
     return out;
 }
 
+// Output size is guaranteed.
+// This is a memory exhaustion risk if caller does not control size.
+template <typename Iterator, bool CheckSafe>
+void deserializer<Iterator, CheckSafe>::read_bytes(data_chunk& out,
+    size_t size)
+{
+    if (!safe(size))
+        invalidate();
+
+    if (!valid_ || size == 0)
+    {
+        out.assign(size, 0);
+        return;
+    }
+
+    const auto begin = iterator_;
+    iterator_ += size;
+    out.assign(begin, begin + size);
+}
+
 template <typename Iterator, bool CheckSafe>
 std::string deserializer<Iterator, CheckSafe>::read_string()
 {
@@ -307,6 +327,12 @@ void deserializer<Iterator, CheckSafe>::skip(size_t size)
     iterator_ += size;
 }
 
+template <typename Iterator, bool CheckSafe>
+Iterator deserializer<Iterator, CheckSafe>::position() const
+{
+    return iterator_;
+}
+
 template <typename Iterator, bool CheckSafe>
 template <unsigned Size>
 byte_array<Size> deserializer<Iterator, CheckSafe>::read_forward()
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_HASH_WRITER_IPP
+#define LIBBITCOIN_HASH_WRITER_IPP
+
+#include <algorithm>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+template <unsigned Size>
+void hash_writer::write_forward(const byte_array<Size>& value)
+{
+    write_bytes(value.data(), value.size());
+}
+
+template <unsigned Size>
+void hash_writer::write_reverse(const byte_array<Size>& value)
+{
+    byte_array<Size> reversed;
+    std::reverse_copy(value.begin(), value.end(), reversed.begin());
+    write_bytes(reversed.data(), reversed.size());
+}
+
+template <typename Integer>
+void hash_writer::write_big_endian(Integer value)
+{
+    const auto bytes = to_big_endian(value);
+    write_bytes(bytes.data(), bytes.size());
+}
+
+template <typename Integer>
+void hash_writer::write_little_endian(Integer value)
+{
+    const auto bytes = to_little_endian(value);
+    write_bytes(bytes.data(), bytes.size());
+}
+
+} // libbitcoin
+
+#endif
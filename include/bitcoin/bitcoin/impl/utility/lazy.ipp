@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_LAZY_IPP
+#define LIBBITCOIN_LAZY_IPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+namespace libbitcoin {
+
+template <typename Type>
+lazy<Type>::lazy()
+  : state_(empty), value_{}
+{
+}
+
+template <typename Type>
+lazy<Type>::lazy(const lazy& other)
+  : state_(empty), value_{}
+{
+    if (other.cached())
+        store(other.value_);
+}
+
+template <typename Type>
+lazy<Type>& lazy<Type>::operator=(const lazy& other)
+{
+    if (other.cached())
+        store(other.value_);
+    else
+        reset();
+
+    return *this;
+}
+
+template <typename Type>
+bool lazy<Type>::cached() const
+{
+    return state_.load(std::memory_order_acquire) == ready;
+}
+
+template <typename Type>
+template <typename Compute>
+const Type& lazy<Type>::get(Compute compute) const
+{
+    auto current = state_.load(std::memory_order_acquire);
+
+    while (current != ready)
+    {
+        // Another reader has claimed the value, wait for it to publish or
+        // to release its claim (if its computation threw).
+        if (current == busy)
+        {
+            std::this_thread::yield();
+            current = state_.load(std::memory_order_acquire);
+            continue;
+        }
+
+        // Claim the value, populate it and then publish it.
+        if (!state_.compare_exchange_weak(current, busy,
+            std::memory_order_acquire))
+            continue;
+
+        try
+        {
+            compute(value_);
+        }
+        catch (...)
+        {
+            state_.store(empty, std::memory_order_release);
+            throw;
+        }
+
+        state_.store(ready, std::memory_order_release);
+        break;
+    }
+
+    return value_;
+}
+
+template <typename Type>
+void lazy<Type>::store(const Type& value)
+{
+    value_ = value;
+    state_.store(ready, std::memory_order_release);
+}
+
+template <typename Type>
+void lazy<Type>::store(Type&& value)
+{
+    value_ = std::move(value);
+    state_.store(ready, std::memory_order_release);
+}
+
+template <typename Type>
+void lazy<Type>::reset()
+{
+    state_.store(empty, std::memory_order_relaxed);
+}
+
+template <typename Type>
+void lazy<Type>::clear()
+{
+    value_ = Type{};
+    state_.store(empty, std::memory_order_relaxed);
+}
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SLIDING_WINDOW_IPP
+#define LIBBITCOIN_SLIDING_WINDOW_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <bitcoin/bitcoin/compat.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+// Relocation copies the window, so it is given room for as many appends
+// again. This amortizes the copy to about one value per append.
+static BC_CONSTEXPR size_t sliding_window_minimum = 16;
+
+template <typename Type>
+sliding_window<Type>::storage::storage(size_t capacity)
+  : values(capacity), claimed(0)
+{
+}
+
+template <typename Type>
+sliding_window<Type>::sliding_window()
+  : storage_(nullptr), first_(0), size_(0)
+{
+}
+
+template <typename Type>
+sliding_window<Type>::sliding_window(std::initializer_list<Type> values)
+  : sliding_window()
+{
+    relocate(2 * values.size());
+    std::copy(values.begin(), values.end(), storage_->values.begin());
+    storage_->claimed = values.size();
+    size_ = values.size();
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+template <typename Type>
+size_t sliding_window<Type>::size() const
+{
+    return size_;
+}
+
+template <typename Type>
+bool sliding_window<Type>::empty() const
+{
+    return size_ == 0;
+}
+
+// Constant access.
+//-----------------------------------------------------------------------------
+
+template <typename Type>
+Type* sliding_window<Type>::data() const
+{
+    return storage_ ? storage_->values.data() + first_ : nullptr;
+}
+
+template <typename Type>
+const Type& sliding_window<Type>::front() const
+{
+    BITCOIN_ASSERT(!empty());
+    return *data();
+}
+
+template <typename Type>
+const Type& sliding_window<Type>::back() const
+{
+    BITCOIN_ASSERT(!empty());
+    return data()[size_ - 1];
+}
+
+template <typename Type>
+const Type& sliding_window<Type>::operator[](size_t index) const
+{
+    BITCOIN_ASSERT(index < size_);
+    return data()[index];
+}
+
+template <typename Type>
+typename sliding_window<Type>::const_iterator
+sliding_window<Type>::begin() const
+{
+    return data();
+}
+
+template <typename Type>
+typename sliding_window<Type>::const_iterator
+sliding_window<Type>::end() const
+{
+    return data() + size_;
+}
+
+template <typename Type>
+typename sliding_window<Type>::const_reverse_iterator
+sliding_window<Type>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename Type>
+typename sliding_window<Type>::const_reverse_iterator
+sliding_window<Type>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+// Mutable access.
+//-----------------------------------------------------------------------------
+
+template <typename Type>
+Type& sliding_window<Type>::operator[](size_t index)
+{
+    BITCOIN_ASSERT(index < size_);
+    detach();
+    return data()[index];
+}
+
+template <typename Type>
+typename sliding_window<Type>::iterator sliding_window<Type>::begin()
+{
+    detach();
+    return data();
+}
+
+template <typename Type>
+typename sliding_window<Type>::iterator sliding_window<Type>::end()
+{
+    detach();
+    return data() + size_;
+}
+
+template <typename Type>
+typename sliding_window<Type>::reverse_iterator sliding_window<Type>::rbegin()
+{
+    return reverse_iterator(end());
+}
+
+template <typename Type>
+typename sliding_window<Type>::reverse_iterator sliding_window<Type>::rend()
+{
+    return reverse_iterator(begin());
+}
+
+// Mutation.
+//-----------------------------------------------------------------------------
+
+template <typename Type>
+void sliding_window<Type>::push_back(const Type& value)
+{
+    auto position = first_ + size_;
+
+    // Claim the next position if no other copy has, otherwise relocate.
+    if (!storage_ || position == storage_->values.size() ||
+        !storage_->claimed.compare_exchange_strong(position, position + 1))
+    {
+        relocate(2 * (size_ + 1));
+        ++storage_->claimed;
+    }
+
+    storage_->values[first_ + size_] = value;
+    ++size_;
+}
+
+template <typename Type>
+void sliding_window<Type>::pop_front()
+{
+    BITCOIN_ASSERT(!empty());
+    ++first_;
+    --size_;
+}
+
+template <typename Type>
+void sliding_window<Type>::resize(size_t size)
+{
+    relocate(size);
+    storage_->claimed = size;
+
+    // Values exposed by growth are reset, as with a deque.
+    std::fill(storage_->values.begin() + std::min(size, size_),
+        storage_->values.begin() + size, Type());
+
+    size_ = size;
+}
+
+template <typename Type>
+void sliding_window<Type>::clear()
+{
+    storage_.reset();
+    first_ = 0;
+    size_ = 0;
+}
+
+// Sharing.
+//-----------------------------------------------------------------------------
+
+template <typename Type>
+void sliding_window<Type>::detach()
+{
+    if (storage_ && storage_.use_count() > 1)
+        relocate(2 * size_);
+}
+
+// Copy the window to the front of new storage, not claiming the extra space.
+template <typename Type>
+void sliding_window<Type>::relocate(size_t capacity)
+{
+    const auto source = storage_;
+    const auto count = std::min(size_, capacity);
+    capacity = std::max(capacity, sliding_window_minimum);
+    storage_ = std::make_shared<storage>(capacity);
+
+    if (source)
+        std::copy_n(source->values.begin() + first_, count,
+            storage_->values.begin());
+
+    storage_->claimed = count;
+    first_ = 0;
+}
+
+} // namespace libbitcoin
+
+#endif
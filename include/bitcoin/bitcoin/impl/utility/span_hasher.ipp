@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SPAN_HASHER_IPP
+#define LIBBITCOIN_SPAN_HASHER_IPP
+
+#include <cstddef>
+#include <iterator>
+#include <bitcoin/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+
+template <typename Reader>
+span_hasher<Reader>::span_hasher(const Reader&)
+{
+}
+
+template <typename Reader>
+bool span_hasher<Reader>::hash(hash_digest&) const
+{
+    return false;
+}
+
+template <typename Reader>
+bool span_hasher<Reader>::hash(hash_digest&, size_t) const
+{
+    return false;
+}
+
+template <typename Iterator, bool CheckSafe>
+span_hasher<deserializer<Iterator, CheckSafe>>::span_hasher(
+    const deserializer_type& source)
+  : source_(source), begin_(source.position())
+{
+}
+
+template <typename Iterator, bool CheckSafe>
+bool span_hasher<deserializer<Iterator, CheckSafe>>::hash(
+    hash_digest& out) const
+{
+    return hash(out, 0, is_contiguous_iterator<Iterator>());
+}
+
+template <typename Iterator, bool CheckSafe>
+bool span_hasher<deserializer<Iterator, CheckSafe>>::hash(
+    hash_digest& out, size_t size) const
+{
+    return size != 0 && hash(out, size, is_contiguous_iterator<Iterator>());
+}
+
+template <typename Iterator, bool CheckSafe>
+bool span_hasher<deserializer<Iterator, CheckSafe>>::hash(hash_digest& out,
+    size_t size, std::true_type) const
+{
+    const auto end = source_.position();
+
+    if (!source_ || end == begin_)
+        return false;
+
+    const auto first = &(*begin_);
+    const auto read = static_cast<size_t>(std::distance(begin_, end));
+
+    if (size != 0 && read != size)
+        return false;
+
+    out = bitcoin_hash({ first, first + read });
+    return true;
+}
+
+template <typename Iterator, bool CheckSafe>
+bool span_hasher<deserializer<Iterator, CheckSafe>>::hash(hash_digest&,
+    size_t, std::false_type) const
+{
+    return false;
+}
+
+} // namespace libbitcoin
+
+#endif
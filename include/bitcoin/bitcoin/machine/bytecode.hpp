@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_BYTECODE_HPP
+#define LIBBITCOIN_MACHINE_BYTECODE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+class script;
+
+} // namespace chain
+
+namespace machine {
+
+class program;
+
+/// A script compiled for the bytecode engine, built once per script.
+/// There is one instruction per script operation, each carrying its handler
+/// (direct threading), the offset of its push data in the script bytes and,
+/// for if/notif/else, the index of the matching else/endif.
+class BC_API bytecode
+{
+public:
+    typedef std::shared_ptr<const bytecode> ptr;
+    typedef error::error_code_t result;
+    typedef result (*handler)(program& program, const bytecode& code,
+        size_t index);
+
+    /// The target of a conditional without a matching else/endif.
+    static const uint32_t no_target;
+
+    struct instruction
+    {
+        handler run;
+        opcode code;
+        bool conditional;
+
+        /// The static failure of the operation (oversized or disabled).
+        result fault;
+
+        /// The push data within the script bytes.
+        uint32_t offset;
+        uint32_t size;
+
+        /// The matching else/endif of a conditional.
+        uint32_t target;
+
+        /// Counted and faulted instructions preceding this one.
+        uint32_t counted;
+        uint32_t faulted;
+    };
+
+    typedef std::vector<instruction> list;
+
+    /// Compile the script, which must not change while this is in use.
+    bytecode(const chain::script& script);
+
+    const list& instructions() const;
+    const instruction& operator[](size_t index) const;
+    size_t size() const;
+
+    /// The push data of the instruction.
+    const uint8_t* data(const instruction& instruction) const;
+
+private:
+    data_chunk bytes_;
+    list instructions_;
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
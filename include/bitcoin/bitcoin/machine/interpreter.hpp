@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/program.hpp>
@@ -104,6 +105,7 @@ public:
     static result op_hash256(program& program);
     static result op_codeseparator(program& program, const operation& op);
     static result op_check_sig_verify(program& program);
+    static result op_check_sig_verify(program& program, bool deferrable);
     static result op_check_sig(program& program);
     static result op_check_multisig_verify(program& program);
     static result op_check_multisig(program& program);
@@ -113,6 +115,9 @@ public:
     /// Run program script.
     static code run(program& program);
 
+    /// Run program script from its compiled bytecode.
+    static code run(const bytecode& code, program& program);
+
     /// Run individual operations (idependent of the script).
     /// For best performance use script runner for a sequence of operations.
     static code run(const operation& op, program& program);
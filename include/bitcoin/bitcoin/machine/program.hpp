@@ -21,13 +21,17 @@
 
 #include <cstdint>
 #include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/script_code_view.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/machine/number.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/machine/script_engine.hpp>
 #include <bitcoin/bitcoin/machine/script_version.hpp>
+#include <bitcoin/bitcoin/machine/stack_element.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 
 namespace libbitcoin {
@@ -36,14 +40,14 @@ namespace machine {
 class BC_API program
 {
 public:
-    typedef data_stack::value_type value_type;
+    typedef stack_element value_type;
     typedef operation::iterator op_iterator;
 
     // Older libstdc++ does not allow erase with const iterator.
     // This is a bug that requires we up the minimum compiler version.
     // So presently stack_iterator is a non-const iterator.
-    ////typedef data_stack::const_iterator stack_iterator;
-    typedef data_stack::iterator stack_iterator;
+    ////typedef stack_element::list::const_iterator stack_iterator;
+    typedef stack_element::list::iterator stack_iterator;
 
     /// Create an instance that does not expect to verify signatures.
     /// This is useful for script utilities but not with input validation.
@@ -70,6 +74,9 @@ public:
     /// Create using copied tx, input, forks, value and moved stack (p2sh run).
     program(const chain::script& script, program&& other, bool move);
 
+    /// Stack storage is returned to a per-thread pool for reuse.
+    ~program();
+
     /// Constant registers.
     bool is_valid() const;
     uint32_t forks() const;
@@ -78,6 +85,17 @@ public:
     script_version version() const;
     const chain::transaction& transaction() const;
 
+    /// Signature checks that fail the script on failure may be queued to the
+    /// batch rather than verified in place (nullptr, the default, disables).
+    /// The batch is shared by programs created from this one.
+    void set_deferred(ec_verification::list* batch);
+    ec_verification::list* deferred() const;
+
+    /// Select the engine run by evaluate() for all programs (interpreted by
+    /// default). The compiled engine builds the bytecode once per script.
+    static void set_engine(script_engine engine);
+    static script_engine engine();
+
     /// Program registers.
     op_iterator begin() const;
     op_iterator jump() const;
@@ -88,7 +106,9 @@ public:
     code evaluate();
     code evaluate(const operation& op);
     bool increment_operation_count(const operation& op);
+    bool increment_operation_count(opcode code);
     bool increment_operation_count(int32_t public_keys);
+    bool skip_operations(size_t counted);
     bool set_jump_register(const operation& op, int32_t offset);
 
     // Primary stack.
@@ -100,7 +120,7 @@ public:
     void push_copy(const value_type& item);
 
     /// Primary pop.
-    data_chunk pop();
+    value_type pop();
     bool pop(int32_t& out_value);
     bool pop(number& out_number, size_t maxiumum_size=max_number_size);
     bool pop_binary(number& first, number& second);
@@ -124,6 +144,7 @@ public:
     bool top(number& out_number, size_t maxiumum_size=max_number_size) /*const*/;
     stack_iterator position(size_t index) /*const*/;
     operation::list subscript() const;
+    const chain::script_code_view& script_code() const;
     size_t size() const;
 
     // Alternate stack.
@@ -147,6 +168,7 @@ private:
     typedef std::vector<bool> bool_stack;
 
     void reserve_stacks();
+    void release_stacks();
     bool stack_to_bool(bool clean) const;
 
     const chain::script& script_;
@@ -155,12 +177,15 @@ private:
     const uint32_t forks_;
     const uint64_t value_;
 
+    ec_verification::list* deferred_;
     script_version version_;
     size_t negative_count_;
     size_t operation_count_;
     op_iterator jump_;
-    data_stack primary_;
-    data_stack alternate_;
+    size_t jump_offset_;
+    chain::script_code_view script_code_;
+    stack_element::list primary_;
+    stack_element::list alternate_;
     bool_stack condition_;
 };
 
@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_SCRIPT_ENGINE_HPP
+#define LIBBITCOIN_MACHINE_SCRIPT_ENGINE_HPP
+
+namespace libbitcoin {
+namespace machine {
+
+/// Script execution engines (see program::set_engine).
+enum class script_engine
+{
+    /// Interpret the parsed operations of the script.
+    interpreted,
+
+    /// Run the bytecode compiled once per script.
+    compiled
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MACHINE_STACK_ELEMENT_HPP
+#define LIBBITCOIN_MACHINE_STACK_ELEMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+/// A script stack item. Items up to the size of a single byte push, which
+/// includes endorsements, public keys and hashes, are stored inline.
+class BC_API stack_element
+{
+public:
+    typedef uint8_t value_type;
+    typedef const uint8_t* const_iterator;
+    typedef std::vector<stack_element> list;
+
+    static BC_CONSTEXPR size_t inline_size = 75;
+
+    // Constructors.
+    //-------------------------------------------------------------------------
+
+    stack_element();
+
+    stack_element(stack_element&& other);
+    stack_element(const stack_element& other);
+
+    stack_element(data_chunk&& data);
+    stack_element(const data_chunk& data);
+    stack_element(const uint8_t* first, const uint8_t* last);
+    stack_element(std::initializer_list<uint8_t> data);
+
+    template <size_t Size>
+    stack_element(const byte_array<Size>& data);
+
+    // Operators.
+    //-------------------------------------------------------------------------
+
+    stack_element& operator=(stack_element&& other);
+    stack_element& operator=(const stack_element& other);
+
+    bool operator==(const stack_element& other) const;
+    bool operator!=(const stack_element& other) const;
+
+    /// Implicit for use with data_chunk interfaces (this copies).
+    operator data_chunk() const;
+
+    // Properties.
+    //-------------------------------------------------------------------------
+
+    bool empty() const;
+    size_t size() const;
+    const uint8_t* data() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    uint8_t back() const;
+    uint8_t operator[](size_t index) const;
+
+private:
+    void assign(const uint8_t* first, const uint8_t* last);
+    bool is_inline() const;
+
+    uint32_t size_;
+    uint8_t inline_[inline_size];
+    data_chunk extended_;
+};
+
+} // namespace machine
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/machine/stack_element.ipp>
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_DIGEST_CACHE_HPP
+#define LIBBITCOIN_DIGEST_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A bounded set of uniformly distributed digests (such as salted hashes).
+/// The set is split into independently locked shards, each a four-way set
+/// associative table with replacement chosen by the digest, so memory use is
+/// fixed at construction. The null_hash digest cannot be stored.
+class BC_API digest_cache
+  : noncopyable
+{
+public:
+    /// Memory is the budget in bytes for stored digests (lower bounded).
+    digest_cache(size_t memory, size_t shards);
+
+    /// True if the digest has been stored (counts a hit or a miss).
+    bool contains(const hash_digest& digest) const;
+
+    /// Store the digest, possibly evicting another.
+    void store(const hash_digest& digest);
+
+    /// Remove all digests and reset counters.
+    void clear();
+
+    /// The number of digests the cache can hold.
+    size_t capacity() const;
+
+    /// The number of contains() calls that found the digest.
+    size_t hits() const;
+
+    /// The number of contains() calls that did not find the digest.
+    size_t misses() const;
+
+private:
+    static const size_t ways = 4;
+
+    struct shard
+    {
+        std::vector<hash_digest> entries;
+        mutable shared_mutex mutex;
+    };
+
+    shard& to_shard(const hash_digest& digest) const;
+    size_t to_set(const hash_digest& digest) const;
+
+    const size_t sets_;
+    const size_t shard_count_;
+    const std::unique_ptr<shard[]> shards_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+};
+
+} // namespace libbitcoin
+
+#endif
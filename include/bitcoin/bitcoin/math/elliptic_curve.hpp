@@ -20,6 +20,7 @@
 #define LIBBITCOIN_ELLIPTIC_CURVE_HPP
 
 #include <cstddef>
+#include <vector>
 #include <bitcoin/bitcoin/compat.hpp>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
@@ -27,6 +28,9 @@
 
 namespace libbitcoin {
 
+class dispatcher;
+class public_key_cache;
+
 /// The sign byte value for an even (y-valued) key.
 static BC_CONSTEXPR uint8_t ec_even_sign = 2;
 
@@ -64,6 +68,16 @@ struct BC_API recoverable_signature
     uint8_t recovery_id;
 };
 
+/// An EC signature to be verified against a potential point (batching):
+struct BC_API ec_verification
+{
+    typedef std::vector<ec_verification> list;
+
+    data_chunk point;
+    hash_digest hash;
+    ec_signature signature;
+};
+
 static BC_CONSTEXPR ec_compressed null_compressed_point =
 {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -172,6 +186,10 @@ BC_API bool encode_signature(der_signature& out, const ec_signature& signature);
 BC_API bool sign(ec_signature& out, const ec_secret& secret,
     const hash_digest& hash);
 
+/// Install a cache of parsed public keys consulted by the verify functions.
+/// The cache is not owned, it must outlive installation (nullptr clears).
+BC_API void set_public_key_cache(public_key_cache* cache);
+
 /// Verify an EC signature using a compressed point.
 BC_API bool verify_signature(const ec_compressed& point,
     const hash_digest& hash, const ec_signature& signature);
@@ -184,6 +202,24 @@ BC_API bool verify_signature(const ec_uncompressed& point,
 BC_API bool verify_signature(data_slice point, const hash_digest& hash,
     const ec_signature& signature);
 
+// EC batch verify
+// ----------------------------------------------------------------------------
+// All points and signatures are parsed and normalized before any verification.
+
+/// Verify a batch of EC signatures, setting out[i] to the result of batch[i].
+/// Returns true if all signatures are valid.
+BC_API bool verify_signatures(std::vector<bool>& out,
+    const ec_verification::list& batch);
+
+/// Verify a batch of EC signatures, stopping at the first failure.
+/// Returns the index of the first invalid signature, or batch.size().
+BC_API size_t verify_signatures(const ec_verification::list& batch);
+
+/// Verify a batch of EC signatures across the dispatcher, as above.
+/// This blocks the calling thread, which must not belong to the pool.
+BC_API size_t verify_signatures(const ec_verification::list& batch,
+    dispatcher& dispatch);
+
 // Recoverable sign/recover
 // ----------------------------------------------------------------------------
 
@@ -23,9 +23,9 @@
 #include <string>
 #include <vector>
 #include <boost/functional/hash_fwd.hpp>
-#include <boost/multiprecision/cpp_int.hpp>
 #include <bitcoin/bitcoin/compat.hpp>
 #include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/uint256.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/utility/endian.hpp>
 
@@ -55,9 +55,6 @@ typedef std::vector<long_hash> long_hash_list;
 typedef std::vector<short_hash> short_hash_list;
 typedef std::vector<mini_hash> mini_hash_list;
 
-// Alias for boost big integer type.
-typedef boost::multiprecision::uint256_t uint256_t;
-
 // Null-valued common bitcoin hashes.
 
 BC_CONSTEXPR hash_digest null_hash
@@ -111,7 +108,7 @@ BC_CONSTEXPR mini_hash null_mini_hash
 
 inline uint256_t to_uint256(const hash_digest& hash)
 {
-    return from_little_endian<uint256_t>(hash.begin(), hash.end());
+    return uint256_t(hash);
 }
 
 /// Generate a scrypt hash to fill a byte array.
@@ -131,6 +128,11 @@ BC_API hash_digest bitcoin_hash(data_slice data);
 BC_API hash_digest litecoin_hash(data_slice data);
 #endif //BITPRIM_CURRENCY_LTC
 
+/// Generate the bitcoin hash of each consecutive input of size bytes in data,
+/// writing data.size() / size hashes to out. Batches are hashed in parallel
+/// vector lanes where supported. Out may alias data if size >= hash_size.
+BC_API void bitcoin_hashes(hash_digest* out, data_slice data, size_t size);
+
 /// Generate a bitcoin short hash.
 BC_API short_hash bitcoin_short_hash(data_slice data);
 
@@ -150,6 +152,28 @@ BC_API data_chunk sha256_hash_chunk(data_slice data);
 /// This hash function was used in electrum seed stretching (obsoleted).
 BC_API hash_digest sha256_hash(data_slice first, data_slice second);
 
+/// The sha256 compression implementations, automatic by default.
+/// Automatic combines the fastest supported single stream and vector lane
+/// implementations (sse41 and avx2 lanes apply only to bitcoin_hashes).
+enum class sha256_implementation
+{
+    automatic,
+    scalar,
+    shani,
+    sse41,
+    avx2
+};
+
+/// True if this processor supports the sha256 implementation.
+BC_API bool sha256_supported(sha256_implementation value);
+
+/// Select the sha256 implementation, false if not supported.
+/// Safe to call while hashing, intended for testing.
+BC_API bool set_sha256_implementation(sha256_implementation value);
+
+/// The sha256 implementation in use.
+BC_API sha256_implementation get_sha256_implementation();
+
 // Generate a hmac sha256 hash.
 BC_API hash_digest hmac_sha256_hash(data_slice data, data_slice key);
 
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_PUBLIC_KEY_CACHE_HPP
+#define LIBBITCOIN_PUBLIC_KEY_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+#include <bitcoin/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A bounded map of serialized public keys to their parsed (and decompressed)
+/// form, so that a recurring key is not parsed again for each verification.
+/// Storage is as digest_cache, locked shards of four-way set associative
+/// tables fixed at construction, indexed by a salted hash of the key so that
+/// a peer cannot choose colliding keys.
+class BC_API public_key_cache
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<public_key_cache> ptr;
+
+    /// The parsed key, opaque outside of the secp256k1 verification paths.
+    typedef byte_array<64> parsed_key;
+
+    static const size_t default_memory = 8 * 1024 * 1024;
+    static const size_t default_shards = 16;
+
+    /// Memory is the budget in bytes for stored entries (lower bounded).
+    public_key_cache(size_t memory=default_memory,
+        size_t shards=default_shards);
+
+    /// Set the parsed key if the serialized key has been stored (counts a
+    /// hit or a miss).
+    bool find(parsed_key& out, data_slice point) const;
+
+    /// Store the parsed form of a serialized key, possibly evicting another.
+    void store(data_slice point, const parsed_key& parsed);
+
+    /// Remove all entries and reset counters.
+    void clear();
+
+    /// The number of entries the cache can hold.
+    size_t capacity() const;
+
+    /// The number of find() calls that found the key.
+    size_t hits() const;
+
+    /// The number of find() calls that did not find the key.
+    size_t misses() const;
+
+private:
+    static const size_t ways = 4;
+
+    struct entry
+    {
+        // The size of the serialized key, zero if the entry is empty.
+        uint8_t size;
+        ec_uncompressed point;
+        parsed_key parsed;
+    };
+
+    struct shard
+    {
+        std::vector<entry> entries;
+        mutable shared_mutex mutex;
+    };
+
+    hash_digest to_digest(data_slice point) const;
+    shard& to_shard(const hash_digest& digest) const;
+    size_t to_set(const hash_digest& digest) const;
+
+    hash_digest salt_;
+    const size_t sets_;
+    const size_t shard_count_;
+    const std::unique_ptr<shard[]> shards_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SIGNATURE_CACHE_HPP
+#define LIBBITCOIN_SIGNATURE_CACHE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/digest_cache.hpp>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A bounded set of (sighash, public key, signature) tuples that have passed
+/// ECDSA verification. Entries are salted hashes of the tuple, so a peer
+/// cannot choose colliding entries. See digest_cache for storage behavior.
+class BC_API signature_cache
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<signature_cache> ptr;
+
+    static const size_t default_memory = 32 * 1024 * 1024;
+    static const size_t default_shards = 16;
+
+    /// Memory is the budget in bytes for stored entries (lower bounded).
+    signature_cache(size_t memory=default_memory,
+        size_t shards=default_shards);
+
+    /// True if the tuple has been stored (counts a hit or a miss).
+    bool contains(const hash_digest& sighash, data_slice public_key,
+        const ec_signature& signature) const;
+
+    /// Record a tuple that has passed verification.
+    void store(const hash_digest& sighash, data_slice public_key,
+        const ec_signature& signature);
+
+    /// Remove all entries and reset counters.
+    void clear();
+
+    /// The number of entries the cache can hold.
+    size_t capacity() const;
+
+    /// The number of contains() calls that found the tuple.
+    size_t hits() const;
+
+    /// The number of contains() calls that did not find the tuple.
+    size_t misses() const;
+
+private:
+    hash_digest to_key(const hash_digest& sighash, data_slice public_key,
+        const ec_signature& signature) const;
+
+    hash_digest salt_;
+    digest_cache entries_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -19,12 +19,133 @@
 #ifndef LIBBBITCOIN_UINT256_HPP
 #define LIBBBITCOIN_UINT256_HPP
 
-#include <boost/multiprecision/cpp_int.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <bitcoin/bitcoin/compat.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
 
 namespace libbitcoin {
 
+/// Unsigned 256 bit integer stored as four native 64 bit limbs, least
+/// significant first. Arithmetic is modulo 2^256 and division by zero throws
+/// std::overflow_error, as with boost::multiprecision::uint256_t.
+class BC_API uint256_t
+{
+public:
+    /// Zero.
+    BC_CONSTCTOR uint256_t()
+      : limbs_{ 0, 0, 0, 0 }
+    {
+    }
 
+    /// Implicit from any integer, negative values are sign extended.
+    template <typename Integer, typename = typename
+        std::enable_if<std::is_integral<Integer>::value>::type>
+    BC_CONSTCTOR uint256_t(Integer value)
+      : limbs_{ static_cast<uint64_t>(value), fill(value), fill(value),
+            fill(value) }
+    {
+    }
+
+    /// From limbs, least significant first.
+    BC_CONSTCTOR uint256_t(uint64_t limb0, uint64_t limb1, uint64_t limb2,
+        uint64_t limb3)
+      : limbs_{ limb0, limb1, limb2, limb3 }
+    {
+    }
+
+    /// From little endian bytes, such as a hash digest.
+    explicit uint256_t(const byte_array<32>& little_endian);
+
+    /// From decimal, or hexadecimal with a 0x prefix.
+    /// Throws std::invalid_argument if the text is not a number.
+    explicit uint256_t(const std::string& text);
+
+    /// Properties.
+    BC_CONSTFUNC uint64_t operator[](size_t index) const
+    {
+        return limbs_[index];
+    }
+
+    size_t bit_length() const;
+    size_t byte_length() const;
+    byte_array<32> hash() const;
+
+    /// Negative, zero or positive as this is less, equal or greater.
+    int compare(const uint256_t& other) const;
+
+    /// Conversions, integers receive the low order bits.
+    explicit operator bool() const;
+
+    template <typename Integer, typename = typename
+        std::enable_if<std::is_integral<Integer>::value>::type>
+    explicit operator Integer() const
+    {
+        return static_cast<Integer>(limbs_[0]);
+    }
+
+    /// Operators.
+    uint256_t operator~() const;
+    uint256_t operator-() const;
+    uint256_t& operator++();
+    uint256_t& operator--();
+    uint256_t operator++(int);
+    uint256_t operator--(int);
+    uint256_t& operator+=(const uint256_t& other);
+    uint256_t& operator-=(const uint256_t& other);
+    uint256_t& operator*=(const uint256_t& other);
+    uint256_t& operator/=(const uint256_t& other);
+    uint256_t& operator%=(const uint256_t& other);
+    uint256_t& operator&=(const uint256_t& other);
+    uint256_t& operator|=(const uint256_t& other);
+    uint256_t& operator^=(const uint256_t& other);
+    uint256_t& operator<<=(uint32_t shift);
+    uint256_t& operator>>=(uint32_t shift);
+
+    /// Quotient and remainder in one pass (Knuth algorithm D).
+    static void divide(uint256_t& quotient, uint256_t& remainder,
+        const uint256_t& dividend, const uint256_t& divisor);
+
+private:
+    template <typename Integer>
+    static BC_CONSTFUNC uint64_t fill(Integer value)
+    {
+        return std::is_signed<Integer>::value &&
+            static_cast<int64_t>(value) < 0 ? ~uint64_t(0) : 0;
+    }
+
+    static uint64_t multiply(uint64_t left, uint64_t right, uint64_t& high);
+
+    uint64_t limbs_[4];
+};
+
+uint256_t operator+(uint256_t left, const uint256_t& right);
+uint256_t operator-(uint256_t left, const uint256_t& right);
+uint256_t operator*(uint256_t left, const uint256_t& right);
+uint256_t operator/(uint256_t left, const uint256_t& right);
+uint256_t operator%(uint256_t left, const uint256_t& right);
+uint256_t operator&(uint256_t left, const uint256_t& right);
+uint256_t operator|(uint256_t left, const uint256_t& right);
+uint256_t operator^(uint256_t left, const uint256_t& right);
+uint256_t operator<<(uint256_t left, uint32_t shift);
+uint256_t operator>>(uint256_t left, uint32_t shift);
+
+bool operator==(const uint256_t& left, const uint256_t& right);
+bool operator!=(const uint256_t& left, const uint256_t& right);
+bool operator<(const uint256_t& left, const uint256_t& right);
+bool operator>(const uint256_t& left, const uint256_t& right);
+bool operator<=(const uint256_t& left, const uint256_t& right);
+bool operator>=(const uint256_t& left, const uint256_t& right);
+
+/// Writes decimal, or hexadecimal if std::hex is set on the stream.
+BC_API std::ostream& operator<<(std::ostream& stream, const uint256_t& value);
 
 } // namespace libbitcoin
 
+#include <bitcoin/bitcoin/impl/math/uint256.ipp>
+
 #endif
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_MESSAGE_HEADER_BATCH_HPP
+#define LIBBITCOIN_MESSAGE_HEADER_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/header_index.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/reader.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+/// A headers message payload parsed into contiguous serialized headers for
+/// bulk hashing and validation, without constructing chain::header objects.
+class BC_API header_batch
+{
+public:
+    typedef chain::header_index::header_data header_data;
+    typedef std::vector<header_data> list;
+
+    header_batch();
+
+    /// Parse a headers payload, hashing all headers in vector lanes.
+    bool from_data(uint32_t version, const data_chunk& data);
+    bool from_data(uint32_t version, std::istream& stream);
+    bool from_data(uint32_t version, reader& source);
+    void reset();
+
+    size_t size() const;
+    bool empty() const;
+    const list& elements() const;
+    const hash_list& hashes() const;
+
+    /// The index must be less than size.
+    chain::header get(size_t index) const;
+
+    /// The index of the first header that does not link to its predecessor
+    /// (previous for the first), fails proof of work or has a futuristic
+    /// timestamp, or size() if all pass. Proof of work is checked in parallel.
+    size_t check(const hash_digest& previous, bool retarget=true) const;
+    size_t check(const hash_digest& previous, dispatcher& dispatch,
+        bool retarget=true) const;
+
+private:
+    size_t first_unlinked(const hash_digest& previous) const;
+    bool is_valid(size_t index, uint32_t future, bool retarget) const;
+
+    list elements_;
+    hash_list hashes_;
+};
+
+} // namespace message
+} // namespace libbitcoin
+
+#endif
@@ -32,7 +32,7 @@ namespace libbitcoin {
 
 /// Reader to wrap arbitrary iterator.
 template <typename Iterator, bool CheckSafe>
-class deserializer
+class deserializer final
   : public reader/*, noncopyable*/
 {
 public:
@@ -87,6 +87,9 @@ public:
     /// Read required size buffer.
     data_chunk read_bytes(size_t size);
 
+    /// Read required size buffer, reusing the capacity of out.
+    void read_bytes(data_chunk& out, size_t size);
+
     /// Read variable length string.
     std::string read_string();
 
@@ -96,6 +99,9 @@ public:
     /// Advance iterator without reading.
     void skip(size_t size);
 
+    /// The position of the next byte to read.
+    Iterator position() const;
+
 private:
     // True if is a safe deserializer and size does not exceed remaining bytes.
     bool safe(size_t size) const;
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_HASH_WRITER_HPP
+#define LIBBITCOIN_HASH_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <bitcoin/bitcoin/compat.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/writer.hpp>
+
+// The sha256 context, defined by the implementation.
+struct SHA256CTX;
+
+namespace libbitcoin {
+
+/// Writer that feeds a sha256 state in place of storing the bytes, so that
+/// an object can be hashed without serializing it to a buffer.
+/// Copies retain the state (for hashing a common prefix once).
+class BC_API hash_writer final
+  : public writer
+{
+public:
+    hash_writer();
+    hash_writer(const hash_writer& other);
+    hash_writer(hash_writer&& other) BC_NOEXCEPT;
+    ~hash_writer();
+
+    hash_writer& operator=(const hash_writer& other);
+    hash_writer& operator=(hash_writer&& other) BC_NOEXCEPT;
+
+    template <unsigned Size>
+    void write_forward(const byte_array<Size>& value);
+
+    template <unsigned Size>
+    void write_reverse(const byte_array<Size>& value);
+
+    template <typename Integer>
+    void write_big_endian(Integer value);
+
+    template <typename Integer>
+    void write_little_endian(Integer value);
+
+    /// Context.
+    operator bool() const;
+    bool operator!() const;
+
+    /// Write hashes.
+    void write_hash(const hash_digest& value);
+    void write_short_hash(const short_hash& value);
+    void write_mini_hash(const mini_hash& value);
+
+    /// Write big endian integers.
+    void write_2_bytes_big_endian(uint16_t value);
+    void write_4_bytes_big_endian(uint32_t value);
+    void write_8_bytes_big_endian(uint64_t value);
+    void write_variable_big_endian(uint64_t value);
+    void write_size_big_endian(size_t value);
+
+    /// Write little endian integers.
+    void write_error_code(const code& ec);
+    void write_2_bytes_little_endian(uint16_t value);
+    void write_4_bytes_little_endian(uint32_t value);
+    void write_8_bytes_little_endian(uint64_t value);
+    void write_variable_little_endian(uint64_t value);
+    void write_size_little_endian(size_t value);
+
+    /// Write one byte.
+    void write_byte(uint8_t value);
+
+    /// Write all bytes.
+    void write_bytes(const data_chunk& data);
+
+    /// Write required size buffer.
+    void write_bytes(const uint8_t* data, size_t size);
+
+    /// Write variable length string.
+    void write_string(const std::string& value, size_t size);
+
+    /// Write required length string, padded with nulls.
+    void write_string(const std::string& value);
+
+    /// Hash skipped bytes as zeros, as in a zero filled buffer.
+    void skip(size_t size);
+
+    /// The sha256 hash of the bytes written, the writer is then reset.
+    hash_digest sha256_hash();
+
+    /// The bitcoin (double sha256) hash of the bytes written, then reset.
+    hash_digest bitcoin_hash();
+
+private:
+    std::unique_ptr<SHA256CTX> context_;
+};
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/hash_writer.ipp>
+
+#endif
@@ -26,7 +26,7 @@
 
 namespace libbitcoin {
 
-class BC_API istream_reader
+class BC_API istream_reader final
   : public reader
 {
 public:
@@ -80,6 +80,9 @@ public:
     /// Read required size buffer.
     data_chunk read_bytes(size_t size);
 
+    /// Read required size buffer, reusing the capacity of out.
+    void read_bytes(data_chunk& out, size_t size);
+
     /// Read variable length string.
     std::string read_string();
 
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_LAZY_HPP
+#define LIBBITCOIN_LAZY_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace libbitcoin {
+
+/// A lazily-computed member cache, published once so reads need no lock.
+/// The first reader computes the value in place, concurrent readers yield
+/// until it is published, or claim it if that computation throws. Stores and
+/// resets are not thread safe, as with any other mutation of the owning object.
+template <typename Type>
+class lazy
+{
+public:
+    lazy();
+
+    /// Copies the value only if it has been published.
+    lazy(const lazy& other);
+    lazy& operator=(const lazy& other);
+
+    /// True if the value has been published.
+    bool cached() const;
+
+    /// The published value, first populated by compute(Type&) if necessary.
+    /// The compute function is passed the storage retained by reset.
+    template <typename Compute>
+    const Type& get(Compute compute) const;
+
+    /// Publish the value (not thread safe).
+    void store(const Type& value);
+    void store(Type&& value);
+
+    /// Clear publication, the storage is retained (not thread safe).
+    void reset();
+
+    /// Clear publication and release the storage (not thread safe).
+    void clear();
+
+private:
+    enum state : uint8_t
+    {
+        empty,
+        busy,
+        ready
+    };
+
+    mutable std::atomic<uint8_t> state_;
+    mutable Type value_;
+};
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/lazy.ipp>
+
+#endif
@@ -25,7 +25,7 @@
 
 namespace libbitcoin {
 
-class BC_API ostream_writer
+class BC_API ostream_writer final
   : public writer
 {
 public:
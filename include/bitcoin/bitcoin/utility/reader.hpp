@@ -22,12 +22,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 
 namespace libbitcoin {
 
+/// Restricts a template parameter to reader implementations.
+#define IF_READER(T) \
+    typename std::enable_if<std::is_base_of<reader, T>::value>::type
+
 /// Reader interface.
 class BC_API reader
 {
@@ -68,6 +73,12 @@ public:
     /// Read required size buffer.
     virtual data_chunk read_bytes(size_t size) = 0;
 
+    /// Read required size buffer into out, overridden to reuse its capacity.
+    virtual void read_bytes(data_chunk& out, size_t size)
+    {
+        out = read_bytes(size);
+    }
+
     /// Read variable length string.
     virtual std::string read_string() = 0;
 
@@ -32,7 +32,7 @@ namespace libbitcoin {
 
 /// Writer to wrap arbitrary iterator.
 template <typename Iterator>
-class serializer
+class serializer final
   : public writer/*, noncopyable*/
 {
 public:
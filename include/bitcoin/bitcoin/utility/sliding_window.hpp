@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SLIDING_WINDOW_HPP
+#define LIBBITCOIN_SLIDING_WINDOW_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace libbitcoin {
+
+/// A double ended window over append-only storage that is shared by copies.
+/// Copying is constant time. A copy that appends at the furthest position of
+/// the storage writes in place, any other append relocates the window into
+/// new storage. Positions are never overwritten, so every copy keeps seeing
+/// its own values. This suits a chain of states that each drop the oldest
+/// value and append a newer one, as a deque would require a full copy.
+/// Appends may run concurrently on copies, other mutation is not thread safe.
+template <typename Type>
+class sliding_window
+{
+public:
+    typedef Type value_type;
+    typedef size_t size_type;
+    typedef Type& reference;
+    typedef const Type& const_reference;
+    typedef Type* iterator;
+    typedef const Type* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    sliding_window();
+    sliding_window(std::initializer_list<Type> values);
+
+    /// Properties.
+    size_t size() const;
+    bool empty() const;
+
+    /// Constant access does not copy.
+    const_reference front() const;
+    const_reference back() const;
+    const_reference operator[](size_t index) const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    /// Mutable access first relocates the window if the storage is shared.
+    reference operator[](size_t index);
+    iterator begin();
+    iterator end();
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+
+    /// Mutation.
+    void push_back(const Type& value);
+    void pop_front();
+    void resize(size_t size);
+    void clear();
+
+private:
+    struct storage
+    {
+        explicit storage(size_t capacity);
+
+        // Fixed on construction, so element addresses never change.
+        std::vector<Type> values;
+
+        // One past the furthest position claimed by any copy.
+        std::atomic<size_t> claimed;
+    };
+
+    Type* data() const;
+    void detach();
+    void relocate(size_t capacity);
+
+    std::shared_ptr<storage> storage_;
+    size_t first_;
+    size_t size_;
+};
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/sliding_window.ipp>
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SPAN_HASHER_HPP
+#define LIBBITCOIN_SPAN_HASHER_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+
+namespace libbitcoin {
+
+/// True for iterators over contiguous bytes.
+template <typename Iterator>
+struct is_contiguous_iterator
+  : std::integral_constant<bool, std::is_pointer<Iterator>::value>
+{
+};
+
+template <>
+struct is_contiguous_iterator<data_chunk::iterator>
+  : std::true_type
+{
+};
+
+template <>
+struct is_contiguous_iterator<data_chunk::const_iterator>
+  : std::true_type
+{
+};
+
+/// Bitcoin hash of the bytes a reader consumes from construction, computed
+/// in place so a deserialized object need not be reserialized to hash it.
+/// Only deserializers over contiguous bytes support this, others yield none.
+template <typename Reader>
+class span_hasher
+{
+public:
+    explicit span_hasher(const Reader& source);
+
+    /// False if unsupported, nothing was read or the reader is invalid.
+    bool hash(hash_digest& out) const;
+
+    /// As above, but also false unless exactly size bytes were read.
+    bool hash(hash_digest& out, size_t size) const;
+};
+
+template <typename Iterator, bool CheckSafe>
+class span_hasher<deserializer<Iterator, CheckSafe>>
+{
+public:
+    typedef deserializer<Iterator, CheckSafe> deserializer_type;
+
+    explicit span_hasher(const deserializer_type& source);
+
+    /// False if unsupported, nothing was read or the reader is invalid.
+    bool hash(hash_digest& out) const;
+
+    /// As above, but also false unless exactly size bytes were read.
+    bool hash(hash_digest& out, size_t size) const;
+
+private:
+    // A zero size matches any nonzero number of bytes read.
+    bool hash(hash_digest& out, size_t size, std::true_type) const;
+    bool hash(hash_digest& out, size_t size, std::false_type) const;
+
+    const deserializer_type& source_;
+    const Iterator begin_;
+};
+
+} // namespace libbitcoin
+
+#include <bitcoin/bitcoin/impl/utility/span_hasher.ipp>
+
+#endif
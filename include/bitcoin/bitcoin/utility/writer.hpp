@@ -22,12 +22,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 #include <bitcoin/bitcoin/define.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 
 namespace libbitcoin {
 
+/// Restricts a template parameter to writer implementations.
+#define IF_WRITER(T) \
+    typename std::enable_if<std::is_base_of<writer, T>::value>::type
+
 /// Writer interface.
 class BC_API writer
 {
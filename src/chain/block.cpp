@@ -19,16 +19,17 @@
 #include <bitcoin/bitcoin/chain/block.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <limits>
 #include <cfenv>
 #include <cmath>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <numeric>
 #include <type_traits>
 #include <utility>
-#include <unordered_map>
 #include <boost/range/adaptor/reversed.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/compact.hpp>
@@ -49,8 +50,11 @@
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/synchronizer.hpp>
+#include "hash_key.hpp"
 
 
 namespace libbitcoin {
@@ -261,8 +265,8 @@ bool block::from_data(const data_chunk& data, bool witness)
 #ifdef BITPRIM_CURRENCY_BCH
     witness = false;
 #endif
-    data_source istream(data);
-    return from_data(istream, witness);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, witness);
 }
 
 bool block::from_data(std::istream& stream, bool witness)
@@ -274,48 +278,33 @@ bool block::from_data(std::istream& stream, bool witness)
     return from_data(source, witness);
 }
 
-// Full block deserialization is always canonical encoding.
 bool block::from_data(reader& source, bool witness)
 {
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#endif
-    validation.start_deserialize = asio::steady_clock::now();
-    reset();
-
-    if (!header_.from_data(source, true))
-        return false;
-
-    const auto count = source.read_size_little_endian();
-
-    // Guard against potential for arbitary memory allocation.
-    if (count > get_max_block_size())
-        source.invalidate();
-    else
-        transactions_.resize(count);
-
-    // Order is required, explicit loop allows early termination.
-    for (auto& tx: transactions_)
-        if (!tx.from_data(source, true, witness))
-            break;
-
-    // TODO: optimize by having reader skip witness data.
-    if (!witness)
-        strip_witness();
-
-    if (!source)
-        reset();
-
-    validation.end_deserialize = asio::steady_clock::now();
-    return source;
+    return from_data<reader>(source, witness);
 }
 
 // private
 void block::reset()
 {
-    header_.reset();
     transactions_.clear();
     transactions_.shrink_to_fit();
+    recycle();
+}
+
+// protected
+// Transactions are retained, as deserialization resizes them and then
+// deserializes each in place, reusing the storage of prior elements.
+void block::recycle()
+{
+    header_.reset();
+
+    for (auto& tx: transactions_)
+        tx.validation = {};
+
+    segregated_.reset();
+    total_inputs_.reset();
+    base_size_.reset();
+    total_size_.reset();
 }
 
 bool block::is_valid() const
@@ -335,7 +324,7 @@ data_chunk block::to_data(bool witness) const
     const auto size = serialized_size(witness);
     data.reserve(size);
     data_sink ostream(data);
-    to_data(ostream);
+    to_data(ostream, witness);
     ostream.flush();
     BITCOIN_ASSERT(data.size() == size);
     return data;
@@ -350,20 +339,9 @@ void block::to_data(std::ostream& stream, bool witness) const
     to_data(sink, witness);
 }
 
-// Full block serialization is always canonical encoding.
 void block::to_data(writer& sink, bool witness) const
 {
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#endif
-    header_.to_data(sink, true);
-    sink.write_size_little_endian(transactions_.size());
-    const auto to = [&sink, witness](const transaction& tx)
-    {
-        tx.to_data(sink, true, witness);
-    };
-
-    std::for_each(transactions_.begin(), transactions_.end(), to);
+    to_data<writer>(sink, witness);
 }
 
 hash_list block::to_hashes(bool witness) const
@@ -392,50 +370,20 @@ size_t block::serialized_size(bool witness) const
 #ifdef BITPRIM_CURRENCY_BCH
     witness = false;
 #endif
-    size_t value;
-
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (witness && total_size_ != boost::none)
-    {
-        value = total_size_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    if (!witness && base_size_ != boost::none)
-    {
-        value = base_size_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     const auto sum = [witness](size_t total, const transaction& tx)
     {
         return safe_add(total, tx.serialized_size(true, witness));
     };
 
-    const auto& txs = transactions_;
-    value = header_.serialized_size(true) +
-        message::variable_uint_size(transactions_.size()) +
-        std::accumulate(txs.begin(), txs.end(), size_t(0), sum);
-
-    if (witness)
-        total_size_ = value;
-    else
-        base_size_ = value;
-
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
+    const auto size = [&](size_t& value)
+    {
+        const auto& txs = transactions_;
+        value = header_.serialized_size(true) +
+            message::variable_uint_size(transactions_.size()) +
+            std::accumulate(txs.begin(), txs.end(), size_t(0), sum);
+    };
 
-    return value;
+    return witness ? total_size_.get(size) : base_size_.get(size);
 }
 
 chain::header& block::header()
@@ -476,20 +424,20 @@ const transaction::list& block::transactions() const
 void block::set_transactions(const transaction::list& value)
 {
     transactions_ = value;
-    segregated_ = boost::none;
-    total_inputs_ = boost::none;
-    base_size_ = boost::none;
-    total_size_ = boost::none;
+    segregated_.reset();
+    total_inputs_.reset();
+    base_size_.reset();
+    total_size_.reset();
 }
 
 // TODO: see set_header comments.
 void block::set_transactions(transaction::list&& value)
 {
     transactions_ = std::move(value);
-    segregated_ = boost::none;
-    total_inputs_ = boost::none;
-    base_size_ = boost::none;
-    total_size_ = boost::none;
+    segregated_.reset();
+    total_inputs_.reset();
+    base_size_.reset();
+    total_size_.reset();
 }
 
 // Convenience property.
@@ -589,14 +537,9 @@ void block::strip_witness()
         transaction.strip_witness();
     };
 
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    unique_lock lock(mutex_);
-
-    segregated_ = false;
-    total_size_ = boost::none;
+    segregated_.store(false);
+    total_size_.reset();
     std::for_each(transactions_.begin(), transactions_.end(), strip);
-    ///////////////////////////////////////////////////////////////////////////
 }
 
 // Validation helpers.
@@ -652,36 +595,18 @@ size_t block::signature_operations(bool bip16, bool bip141) const
 
 size_t block::total_inputs(bool with_coinbase) const
 {
-    size_t value;
-
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (total_inputs_ != boost::none)
-    {
-        value = total_inputs_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     const auto inputs = [](size_t total, const transaction& tx)
     {
         return safe_add(total, tx.inputs().size());
     };
 
-    const auto& txs = transactions_;
-    const size_t offset = with_coinbase ? 0 : 1;
-    value = std::accumulate(txs.begin() + offset, txs.end(), size_t(0), inputs);
-    total_inputs_ = value;
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return value;
+    return total_inputs_.get([&](size_t& value)
+    {
+        const auto& txs = transactions_;
+        const size_t offset = with_coinbase ? 0 : 1;
+        value = std::accumulate(txs.begin() + offset, txs.end(), size_t(0),
+            inputs);
+    });
 }
 
 size_t block::weight() const
@@ -738,11 +663,10 @@ hash_digest block::generate_merkle_root(bool witness) const
     if (transactions_.empty())
         return null_hash;
 
-    hash_list update;
     auto merkle = to_hashes(witness);
 
-    // Initial capacity is half of the original list (clear doesn't reset).
-    update.reserve((merkle.size() + 1) / 2);
+    // Room for duplicating an odd last hash, the list only shrinks after.
+    merkle.reserve(merkle.size() + 1);
 
     while (merkle.size() > 1)
     {
@@ -750,11 +674,11 @@ hash_digest block::generate_merkle_root(bool witness) const
         if (merkle.size() % 2 != 0)
             merkle.push_back(merkle.back());
 
-        for (auto it = merkle.begin(); it != merkle.end(); it += 2)
-            update.push_back(bitcoin_hash(build_chunk({ it[0], it[1] })));
-
-        std::swap(merkle, update);
-        update.clear();
+        // Each pair is a contiguous 64 byte input, hashed in place as a batch.
+        const auto begin = merkle.front().data();
+        const auto end = begin + merkle.size() * hash_size;
+        bitcoin_hashes(merkle.data(), { begin, end }, 2 * hash_size);
+        merkle.resize(merkle.size() / 2);
     }
 
     // There is now only one item in the list.
@@ -775,21 +699,105 @@ size_t block::non_coinbase_input_count() const
     return std::accumulate(txs.begin() + 1, txs.end(), size_t(0), counter);
 }
 
+// Open addressing set of (hash, index) keys, for the block scoped duplicate
+// checks. Keys are referenced, not copied, so they must outlive the set. The
+// table is at least twice the key count, so linear probing stays short, and
+// the slot is selected by a salted mix of all of the hash, so that chosen
+// prevout hashes cannot force collisions.
+namespace {
+
+class point_set
+{
+public:
+    explicit point_set(size_t count)
+      : mask_(table_size(count) - 1), slots_(mask_ + 1)
+    {
+    }
+
+    // Returns false if the key was already present.
+    bool insert(const hash_digest& hash, uint32_t index)
+    {
+        for (auto position = bucket(hash, index);; position = next(position))
+        {
+            auto& slot = slots_[position];
+
+            if (slot.hash == nullptr)
+            {
+                slot.hash = &hash;
+                slot.index = index;
+                return true;
+            }
+
+            if (slot.index == index && *slot.hash == hash)
+                return false;
+        }
+    }
+
+    bool contains(const hash_digest& hash, uint32_t index) const
+    {
+        for (auto position = bucket(hash, index);; position = next(position))
+        {
+            const auto& slot = slots_[position];
+
+            if (slot.hash == nullptr)
+                return false;
+
+            if (slot.index == index && *slot.hash == hash)
+                return true;
+        }
+    }
+
+private:
+    struct slot
+    {
+        const hash_digest* hash = nullptr;
+        uint32_t index = 0;
+    };
+
+    static size_t table_size(size_t count)
+    {
+        size_t size = 16;
+        while (size < 2 * count)
+            size <<= 1;
+
+        return size;
+    }
+
+    size_t bucket(const hash_digest& hash, uint32_t index) const
+    {
+        return static_cast<size_t>(hash_key(hash, index)) & mask_;
+    }
+
+    size_t next(size_t position) const
+    {
+        return (position + 1) & mask_;
+    }
+
+    const size_t mask_;
+    std::vector<slot> slots_;
+};
+
+} // namespace
+
 //****************************************************************************
 // CONSENSUS: This is only necessary because satoshi stores and queries as it
 // validates, imposing an otherwise unnecessary partial transaction ordering.
 //*****************************************************************************
 bool block::is_forward_reference() const
 {
-    std::unordered_map<hash_digest, bool> hashes(transactions_.size());
-    const auto is_forward = [&hashes](const input& input)
+    // The set references the hashes, so they are held here (no reallocation).
+    hash_list hashes;
+    hashes.reserve(transactions_.size());
+    point_set referenced(transactions_.size());
+    const auto is_forward = [&referenced](const input& input)
     {
-        return hashes.count(input.previous_output().hash()) != 0;
+        return referenced.contains(input.previous_output().hash(), 0);
     };
 
     for (const auto& tx: reverse(transactions_))
     {
-        hashes.emplace(tx.hash(), true);
+        hashes.push_back(tx.hash());
+        referenced.insert(hashes.back(), 0);
 
         if (std::any_of(tx.inputs().begin(), tx.inputs().end(), is_forward))
             return true;
@@ -804,21 +812,17 @@ bool block::is_internal_double_spend() const
     if (transactions_.empty())
         return false;
 
-    point::list outs;
-    outs.reserve(non_coinbase_input_count());
+    point_set outs(non_coinbase_input_count());
     const auto& txs = transactions_;
 
-    // Merge the prevouts of all non-coinbase transactions into one set.
+    // Stop at the first prevout already spent by a non-coinbase transaction.
     for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx)
-    {
-        auto out = tx->previous_outputs();
-        std::move(out.begin(), out.end(), std::inserter(outs, outs.end()));
-    }
+        for (const auto& input: tx->inputs())
+            if (!outs.insert(input.previous_output().hash(),
+                input.previous_output().index()))
+                return true;
 
-    std::sort(outs.begin(), outs.end());
-    const auto distinct_end = std::unique(outs.begin(), outs.end());
-    const auto distinct = (distinct_end == outs.end());
-    return !distinct;
+    return false;
 }
 
 bool block::is_valid_merkle_root() const
@@ -893,35 +897,17 @@ bool block::is_segregated() const
 #ifdef BITPRIM_CURRENCY_BCH
     return false;
 #endif
-    bool value;
-
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (segregated_ != boost::none)
-    {
-        value = segregated_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     const auto segregated = [](const transaction& tx)
     {
         return tx.is_segregated();
     };
 
     // If no block tx has witness data the commitment is optional (bip141).
-    value = std::any_of(transactions_.begin(), transactions_.end(), segregated);
-
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return value;
+    return segregated_.get([&](bool& value)
+    {
+        value = std::any_of(transactions_.begin(), transactions_.end(),
+            segregated);
+    });
 }
 
 code block::check_transactions() const
@@ -957,14 +943,89 @@ code block::connect_transactions(const chain_state& state) const
     return error::success;
 }
 
+// Inputs are distributed over buckets by position in block order. Each bucket
+// records only its first failure, and stops once a lower position has failed,
+// so the lowest recorded position is the failure the serial loop would find.
+code block::connect_transactions(const chain_state& state,
+    dispatcher& dispatch) const
+{
+    // The calling thread connects one bucket, the pool connects the others.
+    const auto buckets = dispatch.size();
+
+    if (buckets < 2 || transactions_.size() < 2)
+        return connect_transactions(state);
+
+    std::atomic<size_t> first_failure(max_size_t);
+    std::vector<size_t> positions(buckets, max_size_t);
+    std::vector<code> results(buckets, error::success);
+
+    const auto connect_bucket = [&](size_t bucket)
+    {
+        size_t position = 0;
+
+        for (const auto& tx: transactions_)
+        {
+            const auto inputs = tx.inputs().size();
+
+            for (size_t input = 0; input < inputs; ++input, ++position)
+            {
+                if (position % buckets != bucket)
+                    continue;
+
+                // A failure earlier in block order determines the result.
+                if (position > first_failure.load())
+                    return;
+
+                const auto ec = tx.connect_input(state, input);
+
+                if (!ec)
+                    continue;
+
+                positions[bucket] = position;
+                results[bucket] = ec;
+
+                auto current = first_failure.load();
+                while (position < current &&
+                    !first_failure.compare_exchange_weak(current, position));
+
+                return;
+            }
+        }
+    };
+
+    const auto complete = std::make_shared<std::promise<void>>();
+    auto finished = complete->get_future();
+    const auto handler = [complete](const code&)
+    {
+        complete->set_value();
+    };
+
+    auto join = synchronize(handler, buckets - 1, "connect",
+        synchronizer_terminate::on_count);
+
+    for (size_t bucket = 1; bucket < buckets; ++bucket)
+    {
+        dispatch.concurrent([&connect_bucket, bucket, join]() mutable
+        {
+            connect_bucket(bucket);
+            join(error::success);
+        });
+    }
+
+    connect_bucket(0);
+    finished.wait();
+
+    const auto lowest = std::min_element(positions.begin(), positions.end());
+    return results[std::distance(positions.begin(), lowest)];
+}
+
 // Validation.
 //-----------------------------------------------------------------------------
 
 // These checks are self-contained; blockchain (and so version) independent.
-code block::check() const
+// The checks that must pass before the stages below are meaningful.
+code block::check_structure() const
 {
-    validation.start_check = asio::steady_clock::now();
-
     code ec;
 
     if ((ec = header_.check())) 
@@ -983,32 +1044,148 @@ code block::check() const
     else if (is_extra_coinbases())
         return error::extra_coinbases;
 
-    // TODO: determinable from tx pool graph.
-    else if (is_forward_reference())
-        return error::forward_reference;
+    else
+        return error::success;
+}
 
-    // This is subset of is_internal_double_spend if collisions cannot happen.
-    ////else if (!is_distinct_transaction_set())
-    ////    return error::internal_duplicate;
+// The stages are independent of each other, so may run in any order or
+// concurrently. The stage number is the order in which failures are reported.
+code block::check_stage(size_t stage) const
+{
+    const auto start = asio::steady_clock::now();
+    code ec;
 
-    // TODO: determinable from tx pool graph.
-    else if (is_internal_double_spend())
-        return error::block_internal_double_spend;
+    switch (stage)
+    {
+        // TODO: determinable from tx pool graph.
+        case 0:
+            ec = is_forward_reference() ? error::forward_reference :
+                error::success;
+            validation.check_forward_reference =
+                asio::steady_clock::now() - start;
+            break;
 
-    // TODO: relates height to tx.hash(false) (pool cache).
-    else if (!is_valid_merkle_root())
-        return error::merkle_mismatch;
+        // This is subset of is_internal_double_spend if collisions cannot
+        // happen, so is_distinct_transaction_set is not checked.
+        // TODO: determinable from tx pool graph.
+        case 1:
+            ec = is_internal_double_spend() ?
+                error::block_internal_double_spend : error::success;
+            validation.check_double_spend = asio::steady_clock::now() - start;
+            break;
 
-    // We cannot know if bip16 is enabled at this point so we disable it.
-    // This will not make a difference unless prevouts are populated, in which
-    // case they are ignored. This means that p2sh sigops are not counted here.
-    // This is a preliminary check, the final count must come from connect().
-    // Reenable once sigop caching is implemented, otherwise is deoptimization.
-    ////else if (signature_operations(false, false) > get_max_block_sigops())
-    ////    return error::block_legacy_sigop_limit;
+        // TODO: relates height to tx.hash(false) (pool cache).
+        case 2:
+            ec = is_valid_merkle_root() ? error::success :
+                error::merkle_mismatch;
+            validation.check_merkle_root = asio::steady_clock::now() - start;
+            break;
 
-    else
-        return check_transactions();
+        // We cannot know if bip16 is enabled at this point so we disable it.
+        // This will not make a difference unless prevouts are populated, in
+        // which case they are ignored. This means that p2sh sigops are not
+        // counted here. This is a preliminary check, the final count must
+        // come from connect(). Reenable once sigop caching is implemented,
+        // otherwise is deoptimization.
+        ////if (signature_operations(false, false) > get_max_block_sigops())
+        ////    return error::block_legacy_sigop_limit;
+        default:
+            ec = check_transactions();
+            validation.check_transactions = asio::steady_clock::now() - start;
+            break;
+    }
+
+    return ec;
+}
+
+static constexpr size_t check_stages = 4;
+
+code block::check() const
+{
+    validation.start_check = asio::steady_clock::now();
+
+    code ec;
+
+    if ((ec = check_structure()))
+        return ec;
+
+    for (size_t stage = 0; stage < check_stages; ++stage)
+        if ((ec = check_stage(stage)))
+            return ec;
+
+    return error::success;
+}
+
+// Each stage records its result, and a stage that has not yet started is
+// skipped once a lower stage has failed, so the lowest failed stage is the
+// failure the serial overload would find.
+code block::check(dispatcher& dispatch) const
+{
+    validation.start_check = asio::steady_clock::now();
+
+    code ec;
+
+    if ((ec = check_structure()))
+        return ec;
+
+    if (dispatch.size() < 2)
+    {
+        for (size_t stage = 0; stage < check_stages; ++stage)
+            if ((ec = check_stage(stage)))
+                return ec;
+
+        return error::success;
+    }
+
+    std::atomic<size_t> first_failure(max_size_t);
+    std::vector<code> results(check_stages, error::success);
+
+    const auto check_one = [&](size_t stage)
+    {
+        // A failure earlier in stage order determines the result.
+        if (stage > first_failure.load())
+            return;
+
+        const auto ec = check_stage(stage);
+
+        if (!ec)
+            return;
+
+        results[stage] = ec;
+
+        auto current = first_failure.load();
+        while (stage < current &&
+            !first_failure.compare_exchange_weak(current, stage));
+    };
+
+    const auto complete = std::make_shared<std::promise<void>>();
+    auto finished = complete->get_future();
+    const auto handler = [complete](const code&)
+    {
+        complete->set_value();
+    };
+
+    // The calling thread checks the first stage, the pool checks the others.
+    auto join = synchronize(handler, check_stages - 1, "check",
+        synchronizer_terminate::on_count);
+
+    for (size_t stage = 1; stage < check_stages; ++stage)
+    {
+        dispatch.concurrent([&check_one, stage, join]() mutable
+        {
+            check_one(stage);
+            join(error::success);
+        });
+    }
+
+    check_one(0);
+    finished.wait();
+
+    for (const auto& result: results)
+        if (result)
+            return result;
+
+    return error::success;
 }
 
 code block::accept(bool transactions) const
@@ -1102,5 +1279,22 @@ code block::connect(const chain_state& state) const
         return connect_transactions(state);
 }
 
+code block::connect(dispatcher& dispatch) const
+{
+    const auto state = validation.state;
+    return state ? connect(*state, dispatch) : error::operation_failed;
+}
+
+code block::connect(const chain_state& state, dispatcher& dispatch) const
+{
+    validation.start_connect = asio::steady_clock::now();
+
+    if (state.is_under_checkpoint())
+        return error::success;
+
+    else
+        return connect_transactions(state, dispatch);
+}
+
 } // namespace chain
 } // namespace libbitcoin
@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/block_view.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/chain/transaction_view.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include "view_reader.hpp"
+
+namespace libbitcoin {
+namespace chain {
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+block_view::block_view(data_slice data)
+  : begin_(data.begin()),
+    end_(data.end()),
+    transactions_(data.end()),
+    count_(0),
+    valid_(false)
+{
+    view_reader source(begin_, end_);
+    source.skip(header::satoshi_fixed_size());
+    const auto count = source.read_size_little_endian();
+
+    if (!source.is_valid())
+        return;
+
+    transactions_ = source.position();
+    count_ = count;
+    valid_ = true;
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool block_view::is_valid() const
+{
+    return valid_;
+}
+
+data_slice block_view::data() const
+{
+    return { begin_, end_ };
+}
+
+data_slice block_view::header_data() const
+{
+    return valid_ ? data_slice{ begin_, begin_ + header::satoshi_fixed_size() } :
+        data_slice{ begin_, begin_ };
+}
+
+size_t block_view::transaction_count() const
+{
+    return count_;
+}
+
+hash_digest block_view::hash() const
+{
+    return valid_ ? bitcoin_hash(header_data()) : null_hash;
+}
+
+block_view::offsets block_view::transaction_offsets() const
+{
+    offsets out;
+    out.reserve(count_);
+    auto position = transactions_;
+
+    for (size_t index = 0; index < count_; ++index)
+    {
+        const auto size = transaction_view::serialized_size({ position, end_ });
+
+        if (size == 0)
+            return{};
+
+        out.push_back(static_cast<size_t>(position - begin_));
+        position += size;
+    }
+
+    return out;
+}
+
+transaction_view::list block_view::transactions() const
+{
+    transaction_view::list out;
+    out.reserve(count_);
+    auto position = transactions_;
+
+    for (size_t index = 0; index < count_; ++index)
+    {
+        out.emplace_back(data_slice{ position, end_ });
+
+        if (!out.back().is_valid())
+            return{};
+
+        position += out.back().serialized_size();
+    }
+
+    return out;
+}
+
+// Conversions.
+//-----------------------------------------------------------------------------
+
+header block_view::to_header() const
+{
+    header out;
+    auto source = make_safe_deserializer(begin_, end_);
+    out.from_data(source, true);
+    return out;
+}
+
+block block_view::to_block(bool witness) const
+{
+    block out;
+    auto source = make_safe_deserializer(begin_, end_);
+    out.from_data(source, witness);
+    return out;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -19,6 +19,7 @@
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -33,8 +34,15 @@
 #include <bitcoin/bitcoin/math/limits.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/rule_fork.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
 #include <bitcoin/bitcoin/multi_crypto_support.hpp>
 #include <bitcoin/bitcoin/unicode/unicode.hpp>
+#include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 #include <bitcoin/bitcoin/utility/timer.hpp>
 
 
@@ -513,27 +521,24 @@ timestamps_position(chain_state::timestamps const& times, bool tip) {
     return times.begin();
 }
 
-std::vector<typename chain_state::timestamps::value_type> 
-timestamps_subset(chain_state::timestamps const& times, bool tip) {
-    auto at = timestamps_position(times, tip);
-    auto n = (std::min)((size_t)std::distance(at, times.end()), median_time_past_interval);
-
-    std::vector<typename chain_state::timestamps::value_type> subset(n);
-    std::copy_n(at, n, subset.begin());
-
-    return subset;
-}
-
 uint32_t chain_state::median_time_past(data const& values, uint32_t, bool tip /*= true*/) {
-    // Create a copy for the in-place sort.
-    auto subset = timestamps_subset(values.timestamp.ordered, tip);
+    auto const& times = values.timestamp.ordered;
+    auto const at = timestamps_position(times, tip);
+    auto const count = (std::min)(size_t(std::distance(at, times.end())), median_time_past_interval);
 
-    // Sort the times by value to obtain the median.
-    std::sort(subset.begin(), subset.end());
+    if (count == 0) {
+        return 0;
+    }
+
+    // Select the median from a stack copy, which needs no allocation or sort.
+    std::array<uint32_t, median_time_past_interval> subset;
+    std::copy_n(at, count, subset.begin());
 
     // Consensus defines median time using modulo 2 element selection.
     // This differs from arithmetic median which averages two middle values.
-    return subset.empty() ? 0 : subset[subset.size() / 2];
+    auto const median = subset.begin() + count / 2;
+    std::nth_element(subset.begin(), median, subset.begin() + count);
+    return *median;
 }
 
 // ------------------------------------------------------------------------------------------------------------
@@ -596,9 +601,17 @@ uint32_t chain_state::cash_difficulty_adjustment(data const& values) {
                                  make_pair(bits_size - 145, values.timestamp.ordered[2]),
                                  pair_cmp);
 
+    // The work of (last_block, first_block] is a difference of cumulative work.
+    // This is derived for constructed states, otherwise it is summed.
+    auto const& cumulative = values.bits.cumulative();
     uint256_t work = 0;
-    for (size_t i = last_block.first + 1; i <= first_block.first; ++i) {
-        work += header::proof(values.bits.ordered[i]);
+
+    if (cumulative.size() == bits_size) {
+        work = cumulative[first_block.first] - cumulative[last_block.first];
+    } else {
+        for (size_t i = last_block.first + 1; i <= first_block.first; ++i) {
+            work += header::proof(values.bits.ordered[i]);
+        }
     }
 
     work *= target_spacing_seconds; //10 * 60
@@ -614,7 +627,7 @@ uint32_t chain_state::cash_difficulty_adjustment(data const& values) {
     auto nextTarget = (-1 * work) / work; //Compute target result
     uint256_t pow_limit(compact{retarget_proof_of_work_limit});
 
-    if (nextTarget.compare(pow_limit) == 1) {
+    if (nextTarget > pow_limit) {
         return retarget_proof_of_work_limit;
     }
 
@@ -884,6 +897,24 @@ uint32_t chain_state::signal_version(uint32_t forks) {
     return first_version;
 }
 
+// Derive the cumulative work of bits, which may be populated arbitrarily.
+chain_state::data& chain_state::cumulate(data& values)
+{
+    auto& cumulative = values.bits.cumulative_;
+    auto const& bits = values.bits.ordered;
+
+    uint256_t total;
+    cumulative.clear();
+
+    for (auto const bit: bits)
+    {
+        total += header::proof(bit);
+        cumulative.push_back(total);
+    }
+
+    return values;
+}
+
 // This is promotion from a preceding height to the next.
 chain_state::data chain_state::to_pool(const chain_state& top)
 {
@@ -900,13 +931,23 @@ chain_state::data chain_state::to_pool(const chain_state& top)
     auto const height = data.height + 1u;
 
     // Enqueue previous block values to collections.
+    // The copied collections share storage, so this does not copy them.
     data.bits.ordered.push_back(data.bits.self);
     data.version.ordered.push_back(data.version.self);
     data.timestamp.ordered.push_back(data.timestamp.self);
 
+    // Extend cumulative work by the enqueued bits, one proof per promotion.
+    // The top state cumulative work is always derived, so it is aligned.
+    auto& cumulative = data.bits.cumulative_;
+    cumulative.push_back((cumulative.empty() ? uint256_t() :
+        cumulative.back()) + header::proof(data.bits.self));
+
     // If bits collection overflows, dequeue oldest member.
     if (data.bits.ordered.size() > bits_count(height, forks))
+    {
         data.bits.ordered.pop_front();
+        cumulative.pop_front();
+    }
 
     // If version collection overflows, dequeue oldest member.
     if (data.version.ordered.size() > version_count(height, forks))
@@ -1076,7 +1117,7 @@ chain_state::chain_state(data&& values, checkpoints const& checkpoints, uint32_t
 , uint64_t magnetic_anomaly_activation_time
 #endif //BITPRIM_CURRENCY_BCH
 )
-    : data_(std::move(values))
+    : data_(std::move(cumulate(values)))
     , forks_(forks | rule_fork::allow_collisions)
     , checkpoints_(checkpoints)
     , active_(activation(data_, forks_
@@ -1099,6 +1140,173 @@ bool chain_state::is_valid() const {
     return data_.height != 0;
 }
 
+// Snapshot.
+//-----------------------------------------------------------------------------
+// Cumulative work is derived on load and so is not persisted. Any change to
+// this layout must increment the snapshot version.
+
+static BC_CONSTEXPR uint32_t snapshot_version = 1;
+
+template <typename Window>
+static void write_window(writer& sink, Window const& window) {
+    sink.write_size_little_endian(window.size());
+
+    for (auto const value: window)
+        sink.write_4_bytes_little_endian(value);
+}
+
+// A window never holds more values than the height of its state.
+template <typename Window>
+static bool read_window(reader& source, Window& window, size_t height) {
+    auto const count = source.read_size_little_endian();
+
+    if (count > height) {
+        source.invalidate();
+        return false;
+    }
+
+    for (size_t index = 0; index < count && source; ++index)
+        window.push_back(source.read_4_bytes_little_endian());
+
+    return source;
+}
+
+// static
+chain_state::ptr chain_state::factory_from_data(data_chunk const& data,
+    checkpoints const& checkpoints, hash_digest const& tip) {
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    auto const state = factory_from_data(source, checkpoints, tip);
+    return source.is_exhausted() ? state : nullptr;
+}
+
+// static
+chain_state::ptr chain_state::factory_from_data(std::istream& stream,
+    checkpoints const& checkpoints, hash_digest const& tip) {
+    istream_reader source(stream);
+    return factory_from_data(source, checkpoints, tip);
+}
+
+// static
+chain_state::ptr chain_state::factory_from_data(reader& source,
+    checkpoints const& checkpoints, hash_digest const& tip) {
+    if (source.read_4_bytes_little_endian() != snapshot_version)
+        return nullptr;
+
+    data values;
+    values.height = source.read_size_little_endian();
+    values.hash = source.read_hash();
+    values.allow_collisions_hash = source.read_hash();
+    values.bip9_bit0_hash = source.read_hash();
+    values.bip9_bit1_hash = source.read_hash();
+    values.bits.self = source.read_4_bytes_little_endian();
+    read_window(source, values.bits.ordered, values.height);
+    values.version.self = source.read_4_bytes_little_endian();
+    read_window(source, values.version.ordered, values.height);
+    values.timestamp.self = source.read_4_bytes_little_endian();
+    values.timestamp.retarget = source.read_4_bytes_little_endian();
+    read_window(source, values.timestamp.ordered, values.height);
+    auto const forks = source.read_4_bytes_little_endian();
+
+    // The snapshot is stale if the configured checkpoints have changed.
+    if (source.read_size_little_endian() != checkpoints.size())
+        return nullptr;
+
+    for (auto const& check: checkpoints) {
+        auto const hash = source.read_hash();
+        auto const height = source.read_8_bytes_little_endian();
+
+        if (!source || hash != check.hash() || height != check.height())
+            return nullptr;
+    }
+
+#ifdef BITPRIM_CURRENCY_BCH
+    auto const monolith_activation_time = source.read_8_bytes_little_endian();
+    auto const magnetic_anomaly_activation_time =
+        source.read_8_bytes_little_endian();
+#endif //BITPRIM_CURRENCY_BCH
+
+    // The snapshot is stale if it is not of the current top block.
+    if (!source || values.height == 0 || values.hash != tip)
+        return nullptr;
+
+    // The state computations presume the window sizes mapped for the height.
+    auto const map = get_map(values.height, checkpoints, forks);
+
+    if (values.bits.ordered.size() != map.bits.count ||
+        values.version.ordered.size() != map.version.count ||
+        values.timestamp.ordered.size() != map.timestamp.count)
+        return nullptr;
+
+    return std::make_shared<chain_state>(std::move(values), checkpoints, forks
+#ifdef BITPRIM_CURRENCY_BCH
+        , monolith_activation_time, magnetic_anomaly_activation_time
+#endif //BITPRIM_CURRENCY_BCH
+    );
+}
+
+data_chunk chain_state::to_data() const {
+    data_chunk data(serialized_size());
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink);
+    return data;
+}
+
+void chain_state::to_data(std::ostream& stream) const {
+    ostream_writer sink(stream);
+    to_data(sink);
+}
+
+void chain_state::to_data(writer& sink) const {
+    sink.write_4_bytes_little_endian(snapshot_version);
+    sink.write_size_little_endian(data_.height);
+    sink.write_hash(data_.hash);
+    sink.write_hash(data_.allow_collisions_hash);
+    sink.write_hash(data_.bip9_bit0_hash);
+    sink.write_hash(data_.bip9_bit1_hash);
+    sink.write_4_bytes_little_endian(data_.bits.self);
+    write_window(sink, data_.bits.ordered);
+    sink.write_4_bytes_little_endian(data_.version.self);
+    write_window(sink, data_.version.ordered);
+    sink.write_4_bytes_little_endian(data_.timestamp.self);
+    sink.write_4_bytes_little_endian(data_.timestamp.retarget);
+    write_window(sink, data_.timestamp.ordered);
+    sink.write_4_bytes_little_endian(forks_);
+    sink.write_size_little_endian(checkpoints_.size());
+
+    for (auto const& check: checkpoints_) {
+        sink.write_hash(check.hash());
+        sink.write_8_bytes_little_endian(check.height());
+    }
+
+#ifdef BITPRIM_CURRENCY_BCH
+    sink.write_8_bytes_little_endian(monolith_activation_time_);
+    sink.write_8_bytes_little_endian(magnetic_anomaly_activation_time_);
+#endif //BITPRIM_CURRENCY_BCH
+}
+
+size_t chain_state::serialized_size() const {
+    auto const window_size = [](size_t count) {
+        return message::variable_uint_size(count) + count * sizeof(uint32_t);
+    };
+
+    auto const checkpoint_size = hash_size + sizeof(uint64_t);
+
+    return sizeof(snapshot_version)
+        + message::variable_uint_size(data_.height)
+        + 4 * hash_size
+        + sizeof(uint32_t) + window_size(data_.bits.ordered.size())
+        + sizeof(uint32_t) + window_size(data_.version.ordered.size())
+        + 2 * sizeof(uint32_t) + window_size(data_.timestamp.ordered.size())
+        + sizeof(forks_)
+        + message::variable_uint_size(checkpoints_.size())
+        + checkpoints_.size() * checkpoint_size
+#ifdef BITPRIM_CURRENCY_BCH
+        + sizeof(monolith_activation_time_)
+        + sizeof(magnetic_anomaly_activation_time_)
+#endif //BITPRIM_CURRENCY_BCH
+        ;
+}
+
 // Properties.
 //-----------------------------------------------------------------------------
 
@@ -79,16 +79,6 @@ inline uint32_t shift_high(uint8_t exponent)
     return  8 * (exponent - 3);
 }
 
-inline size_t logical_size(uint256_t value)
-{
-    auto byte = 0;
-
-    for (; value != 0; ++byte)
-        value >>= 8;
-
-    return byte;
-}
-
 // Constructors
 //-----------------------------------------------------------------------------
 
@@ -159,7 +149,7 @@ bool compact::from_compact(uint256_t& out, uint32_t compact)
 uint32_t compact::from_big(const uint256_t& big)
 {
     // This value is limited to 32, so exponent cannot overflow.
-    auto exponent = static_cast<uint8_t>(logical_size(big));
+    auto exponent = static_cast<uint8_t>(big.byte_length());
 
     // Shift the big number significant digits into the mantissa.
     const auto mantissa64 = exponent <= 3 ?
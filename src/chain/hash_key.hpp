@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_HASH_KEY_HPP
+#define LIBBITCOIN_CHAIN_HASH_KEY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/pseudo_random.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Finalizer of the splitmix64 generator, a fast full avalanche of a word.
+inline uint64_t mix_key(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111eb;
+    return value ^ (value >> 31);
+}
+
+/// A hash table key mixed from all of the hash and the seed, salted per
+/// process, so that chosen hashes cannot force collisions in a table.
+inline uint64_t hash_key(const hash_digest& hash, uint64_t seed=0)
+{
+    static const auto salt = pseudo_random::next();
+    auto value = mix_key(salt ^ seed);
+
+    for (size_t offset = 0; offset < hash_size; offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, hash.data() + offset, sizeof(word));
+        value = mix_key(value ^ word);
+    }
+
+    return value;
+}
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
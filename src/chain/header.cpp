@@ -28,8 +28,11 @@
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 
 namespace libbitcoin {
 namespace chain {
@@ -65,7 +68,7 @@ header::header(header&& other, hash_digest&& hash)
   : header(other.version_, std::move(other.previous_block_hash_),
       std::move(other.merkle_), other.timestamp_, other.bits_, other.nonce_)
 {
-    hash_ = std::make_shared<hash_digest>(std::move(hash));
+    hash_.store(std::move(hash));
     validation = std::move(other.validation);
 }
 
@@ -73,7 +76,7 @@ header::header(const header& other, const hash_digest& hash)
   : header(other.version_, other.previous_block_hash_, other.merkle_,
         other.timestamp_, other.bits_, other.nonce_)
 {
-    hash_ = std::make_shared<hash_digest>(hash);
+    hash_.store(hash);
     validation = other.validation;
 }
 
@@ -175,8 +178,8 @@ header header::factory_from_data(reader& source, bool wire)
 
 bool header::from_data(const data_chunk& data, bool wire)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire);
 }
 
 bool header::from_data(std::istream& stream, bool wire)
@@ -187,22 +190,7 @@ bool header::from_data(std::istream& stream, bool wire)
 
 bool header::from_data(reader& source, bool wire)
 {
-    ////reset();
-
-    version_ = source.read_4_bytes_little_endian();
-    previous_block_hash_ = source.read_hash();
-    merkle_ = source.read_hash();
-    timestamp_ = source.read_4_bytes_little_endian();
-    bits_ = source.read_4_bytes_little_endian();
-    nonce_ = source.read_4_bytes_little_endian();
-
-    if (!wire)
-        validation.median_time_past = source.read_4_bytes_little_endian();
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, wire);
 }
 
 // protected
@@ -232,13 +220,9 @@ bool header::is_valid() const
 
 data_chunk header::to_data(bool wire) const
 {
-    data_chunk data;
-    const auto size = serialized_size(wire);
-    data.reserve(size);
-    data_sink ostream(data);
-    to_data(ostream, wire);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
+    data_chunk data(serialized_size(wire));
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, wire);
     return data;
 }
 
@@ -250,15 +234,7 @@ void header::to_data(std::ostream& stream, bool wire) const
 
 void header::to_data(writer& sink, bool wire) const
 {
-    sink.write_4_bytes_little_endian(version_);
-    sink.write_hash(previous_block_hash_);
-    sink.write_hash(merkle_);
-    sink.write_4_bytes_little_endian(timestamp_);
-    sink.write_4_bytes_little_endian(bits_);
-    sink.write_4_bytes_little_endian(nonce_);
-
-    if (!wire)
-        sink.write_4_bytes_little_endian(validation.median_time_past);
+    to_data<writer>(sink, wire);
 }
 
 // Size.
@@ -377,43 +353,22 @@ void header::set_nonce(uint32_t value)
 // protected
 void header::invalidate_cache() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (hash_)
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        hash_.reset();
-        //---------------------------------------------------------------------
-        mutex_.unlock_and_lock_upgrade();
-    }
-
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+    hash_.reset();
 }
 
 hash_digest header::hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (!hash_)
+    return hash_.get([this](hash_digest& hash)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        hash_ = std::make_shared<hash_digest>(bitcoin_hash(to_data()));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
-    }
-
-    const auto hash = *hash_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+        hash_writer sink;
+        to_data(sink);
+        hash = sink.bitcoin_hash();
+    });
+}
 
-    return hash;
+bool header::is_hashed() const
+{
+    return hash_.cached();
 }
 
 #ifdef BITPRIM_CURRENCY_LTC
@@ -467,24 +422,34 @@ bool header::is_valid_timestamp() const
 // [CheckProofOfWork]
 bool header::is_valid_proof_of_work(bool retarget) const
 {
-    const auto bits = compact(bits_);
-    static const uint256_t pow_limit(compact{ work_limit(retarget) });
+#ifdef BITPRIM_CURRENCY_LTC
+    return is_valid_proof_of_work(bits_, litecoin_proof_of_work_hash(),
+        retarget);
+#else //BITPRIM_CURRENCY_LTC
+    return is_valid_proof_of_work(bits_, hash(), retarget);
+#endif //BITPRIM_CURRENCY_LTC
+}
+
+// static
+bool header::is_valid_proof_of_work(uint32_t bits, const hash_digest& hash,
+    bool retarget)
+{
+    const auto compact_bits = compact(bits);
+    static const uint256_t retarget_limit(compact{ work_limit(true) });
+    static const uint256_t no_retarget_limit(compact{ work_limit(false) });
+    const auto& pow_limit = retarget ? retarget_limit : no_retarget_limit;
 
-    if (bits.is_overflowed())
+    if (compact_bits.is_overflowed())
         return false;
 
-    uint256_t target(bits);
+    uint256_t target(compact_bits);
 
     // Ensure claimed work is within limits.
     if (target < 1 || target > pow_limit)
         return false;
 
     // Ensure actual work is at least claimed amount (smaller is more work).
-#ifdef BITPRIM_CURRENCY_LTC
-    return to_uint256(litecoin_proof_of_work_hash()) <= target;
-#else //BITPRIM_CURRENCY_LTC
-    return to_uint256(hash()) <= target;
-#endif //BITPRIM_CURRENCY_LTC
+    return to_uint256(hash) <= target;
 }
 
 // Validation.
@@ -0,0 +1,439 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/header_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/system/error_code.hpp>
+#include <bitcoin/bitcoin/chain/block.hpp>
+#include <bitcoin/bitcoin/chain/header.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
+#include "hash_key.hpp"
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace boost::iostreams;
+
+const uint32_t header_index::empty_slot = 0;
+
+// File layout: version, count, then the headers, hashes and cumulative work
+// (little endian) of all heights, each array contiguous.
+static const uint32_t index_version = 1;
+static const size_t index_prefix_size = sizeof(uint32_t) + sizeof(uint64_t);
+static const size_t index_record_size = sizeof(header_index::header_data) +
+    hash_size + hash_size;
+
+// Serialized header offsets.
+static const size_t previous_offset = sizeof(uint32_t);
+static const size_t bits_offset = previous_offset + 2 * hash_size +
+    sizeof(uint32_t);
+
+// The table is kept at most half full, so probe sequences remain short.
+static const size_t minimum_slots = 1024;
+
+// The key is salted, since block hashes need not be honestly mined to be
+// offered, so their low order bytes can be chosen to force collisions.
+static size_t to_key(const hash_digest& hash)
+{
+    return static_cast<size_t>(hash_key(hash));
+}
+
+header_index::header_index()
+  : table_(minimum_slots, empty_slot)
+{
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+size_t header_index::size() const
+{
+    return hashes_.size();
+}
+
+bool header_index::empty() const
+{
+    return hashes_.empty();
+}
+
+const header_index::header_data& header_index::data(size_t height) const
+{
+    BITCOIN_ASSERT(height < size());
+    return headers_[height];
+}
+
+const hash_digest& header_index::hash(size_t height) const
+{
+    BITCOIN_ASSERT(height < size());
+    return hashes_[height];
+}
+
+const uint256_t& header_index::work(size_t height) const
+{
+    BITCOIN_ASSERT(height < size());
+    return works_[height];
+}
+
+header header_index::get(size_t height) const
+{
+    const auto& serial = data(height);
+    auto source = make_safe_deserializer(serial.begin(), serial.end());
+    const auto instance = header::factory_from_data(source);
+    return header(instance, hash(height));
+}
+
+// Queries.
+//-----------------------------------------------------------------------------
+
+bool header_index::get_height(size_t& out_height,
+    const hash_digest& hash) const
+{
+    const auto mask = table_.size() - 1;
+
+    for (auto index = slot(hash); table_[index] != empty_slot;
+        index = (index + 1) & mask)
+    {
+        const auto height = table_[index] - 1u;
+
+        if (hashes_[height] == hash)
+        {
+            out_height = height;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool header_index::get_ancestor(hash_digest& out_hash, const hash_digest& hash,
+    size_t height) const
+{
+    size_t descendant;
+    if (!get_height(descendant, hash) || height > descendant)
+        return false;
+
+    // The index is a single chain, so an ancestor is found by height.
+    out_hash = hashes_[height];
+    return true;
+}
+
+hash_list header_index::locator() const
+{
+    if (empty())
+        return{};
+
+    const auto heights = block::locator_heights(size() - 1u);
+    hash_list hashes;
+    hashes.reserve(heights.size());
+
+    for (const auto height: heights)
+        hashes.push_back(hashes_[height]);
+
+    return hashes;
+}
+
+// Modifiers.
+//-----------------------------------------------------------------------------
+
+bool header_index::push(const header& header)
+{
+    header_data serial;
+    auto sink = make_unsafe_serializer(serial.begin());
+    header.to_data(sink);
+    return push(serial, header.hash());
+}
+
+bool header_index::push(const header_data& data)
+{
+    return push(data, bitcoin_hash(data));
+}
+
+bool header_index::push(const header_data& data, const hash_digest& hash)
+{
+    // The height must be representable in the table (less one for empty).
+    if (size() >= max_uint32 - 1u)
+        return false;
+
+    if (!empty() && !std::equal(hashes_.back().begin(), hashes_.back().end(),
+        data.begin() + previous_offset))
+        return false;
+
+    const auto bits = from_little_endian_unsafe<uint32_t>(
+        data.begin() + bits_offset);
+    const auto proof = header::proof(bits);
+
+    headers_.push_back(data);
+    hashes_.push_back(hash);
+    works_.push_back(works_.empty() ? proof : works_.back() + proof);
+    insert(static_cast<uint32_t>(size() - 1u));
+    return true;
+}
+
+void header_index::pop_above(size_t height)
+{
+    while (size() > height + 1u)
+    {
+        erase(static_cast<uint32_t>(size() - 1u));
+        headers_.pop_back();
+        hashes_.pop_back();
+        works_.pop_back();
+    }
+}
+
+void header_index::reserve(size_t count)
+{
+    headers_.reserve(count);
+    hashes_.reserve(count);
+    works_.reserve(count);
+
+    if (table_.size() < 2 * count)
+        rehash(2 * count);
+}
+
+void header_index::clear()
+{
+    headers_.clear();
+    hashes_.clear();
+    works_.clear();
+    table_.assign(minimum_slots, empty_slot);
+}
+
+// Table.
+//-----------------------------------------------------------------------------
+
+size_t header_index::slot(const hash_digest& hash) const
+{
+    return to_key(hash) & (table_.size() - 1u);
+}
+
+// The height must be the top, as growth rehashes all heights.
+void header_index::insert(uint32_t height)
+{
+    if (2 * size() > table_.size())
+    {
+        rehash(2 * table_.size());
+        return;
+    }
+
+    const auto mask = table_.size() - 1;
+    auto index = slot(hashes_[height]);
+
+    while (table_[index] != empty_slot)
+        index = (index + 1) & mask;
+
+    table_[index] = height + 1u;
+}
+
+// Backward shift deletion keeps every probe sequence free of gaps.
+void header_index::erase(uint32_t height)
+{
+    const auto mask = table_.size() - 1;
+    auto index = slot(hashes_[height]);
+
+    while (table_[index] != height + 1u)
+        index = (index + 1) & mask;
+
+    for (auto next = (index + 1) & mask; table_[next] != empty_slot;
+        next = (next + 1) & mask)
+    {
+        // Move the entry back if its home slot is not within (index, next].
+        const auto home = slot(hashes_[table_[next] - 1u]);
+
+        if (((next - home) & mask) >= ((next - index) & mask))
+        {
+            table_[index] = table_[next];
+            index = next;
+        }
+    }
+
+    table_[index] = empty_slot;
+}
+
+void header_index::rehash(size_t slots)
+{
+    size_t count = minimum_slots;
+
+    while (count < slots)
+        count <<= 1;
+
+    table_.assign(count, empty_slot);
+    const auto mask = count - 1;
+
+    for (uint32_t height = 0; height < size(); ++height)
+    {
+        auto index = slot(hashes_[height]);
+
+        while (table_[index] != empty_slot)
+            index = (index + 1) & mask;
+
+        table_[index] = height + 1u;
+    }
+}
+
+// Persistence.
+//-----------------------------------------------------------------------------
+
+// The file is written beside the target and renamed over it when complete,
+// so an interrupted save does not destroy the existing index.
+bool header_index::save(const path& file) const
+{
+    const auto count = size();
+    const auto temporary = file.string() + ".tmp";
+    mapped_file_params params(temporary);
+    params.flags = mapped_file::readwrite;
+    params.new_file_size = index_prefix_size + count * index_record_size;
+
+    try
+    {
+        mapped_file sink(params);
+        auto out = reinterpret_cast<uint8_t*>(sink.data());
+        auto serial = make_unsafe_serializer(out);
+        serial.write_4_bytes_little_endian(index_version);
+        serial.write_8_bytes_little_endian(count);
+        out += index_prefix_size;
+
+        if (count != 0)
+        {
+            std::memcpy(out, headers_.data(), count * sizeof(header_data));
+            out += count * sizeof(header_data);
+            std::memcpy(out, hashes_.data(), count * hash_size);
+            out += count * hash_size;
+        }
+
+        for (const auto& work: works_)
+        {
+            const auto bytes = work.hash();
+            out = std::copy(bytes.begin(), bytes.end(), out);
+        }
+
+        sink.close();
+        boost::filesystem::rename(temporary, file);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        boost::system::error_code ignore;
+        boost::filesystem::remove(temporary, ignore);
+        return false;
+    }
+}
+
+// The hashes and work of the file are verified against its headers.
+bool header_index::load(const path& file)
+{
+    clear();
+
+    try
+    {
+        mapped_file_source source(file.string());
+        const auto size = source.size();
+        auto in = reinterpret_cast<const uint8_t*>(source.data());
+
+        if (size < index_prefix_size ||
+            from_little_endian_unsafe<uint32_t>(in) != index_version)
+            return false;
+
+        const auto count = from_little_endian_unsafe<uint64_t>(
+            in + sizeof(uint32_t));
+
+        if (count >= max_uint32 - 1u ||
+            (size - index_prefix_size) / index_record_size != count ||
+            (size - index_prefix_size) % index_record_size != 0)
+            return false;
+
+        in += index_prefix_size;
+        headers_.resize(count);
+        hashes_.resize(count);
+        works_.reserve(count);
+
+        if (count != 0)
+        {
+            const auto headers_size = count * sizeof(header_data);
+            std::memcpy(headers_.data(), in, headers_size);
+            bitcoin_hashes(hashes_.data(), { in, in + headers_size },
+                sizeof(header_data));
+            in += headers_size;
+        }
+
+        for (size_t height = 0; height < count; ++height)
+        {
+            const auto& hash = hashes_[height];
+
+            if (!std::equal(hash.begin(), hash.end(), in))
+            {
+                clear();
+                return false;
+            }
+
+            in += hash_size;
+        }
+
+        for (size_t height = 0; height < count; ++height)
+        {
+            const auto bits = from_little_endian_unsafe<uint32_t>(
+                headers_[height].begin() + bits_offset);
+            const auto proof = header::proof(bits);
+            works_.push_back(works_.empty() ? proof : works_.back() + proof);
+            const auto bytes = works_.back().hash();
+
+            if (!std::equal(bytes.begin(), bytes.end(), in))
+            {
+                clear();
+                return false;
+            }
+
+            in += hash_size;
+        }
+
+        // Reject a file that does not describe a single linked chain.
+        for (size_t height = 1; height < count; ++height)
+        {
+            const auto& previous = hashes_[height - 1u];
+
+            if (!std::equal(previous.begin(), previous.end(),
+                headers_[height].begin() + previous_offset))
+            {
+                clear();
+                return false;
+            }
+        }
+
+        rehash(2 * count);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        clear();
+        return false;
+    }
+}
+
+} // namespace chain
+} // namespace libbitcoin
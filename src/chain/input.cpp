@@ -25,6 +25,7 @@
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/wallet/payment_address.hpp>
@@ -46,7 +47,7 @@ input::input()
 }
 
 input::input(input&& other)
-  : addresses_(other.addresses_cache()),
+  : addresses_(other.addresses_),
     previous_output_(std::move(other.previous_output_)),
     script_(std::move(other.script_)),
     witness_(std::move(other.witness_)),
@@ -55,7 +56,7 @@ input::input(input&& other)
 }
 
 input::input(const input& other)
-  : addresses_(other.addresses_cache()),
+  : addresses_(other.addresses_),
     previous_output_(other.previous_output_),
     script_(std::move(other.script_)),
     witness_(other.witness_),
@@ -79,17 +80,6 @@ input::input(const output_point& previous_output, const chain::script& script,
 {
 }
 
-// Private cache access for copy/move construction.
-input::addresses_ptr input::addresses_cache() const
-{
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    shared_lock lock(mutex_);
-
-    return addresses_;
-    ///////////////////////////////////////////////////////////////////////////
-}
-
 input::input(output_point&& previous_output, chain::script&& script,
     chain::witness&& witness, uint32_t sequence)
   : previous_output_(std::move(previous_output)), script_(std::move(script)),
@@ -109,7 +99,7 @@ input::input(const output_point& previous_output, const chain::script& script,
 
 input& input::operator=(input&& other)
 {
-    addresses_ = other.addresses_cache();
+    addresses_ = other.addresses_;
     previous_output_ = std::move(other.previous_output_);
     script_ = std::move(other.script_);
     witness_ = std::move(other.witness_);
@@ -119,7 +109,7 @@ input& input::operator=(input&& other)
 
 input& input::operator=(const input& other)
 {
-    addresses_ = other.addresses_cache();
+    addresses_ = other.addresses_;
     previous_output_ = other.previous_output_;
     script_ = other.script_;
     witness_ = other.witness_;
@@ -178,8 +168,8 @@ bool input::from_data(const data_chunk& data, bool wire, bool witness)
 #ifdef BITPRIM_CURRENCY_BCH
     witness = false;
 #endif
-    data_source istream(data);
-    return from_data(istream, wire, witness);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire, witness);
 }
 
 bool input::from_data(std::istream& stream, bool wire, bool witness)
@@ -193,38 +183,24 @@ bool input::from_data(std::istream& stream, bool wire, bool witness)
 
 bool input::from_data(reader& source, bool wire, bool witness)
 {
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#else
-    // Always write witness to store so that we know how to read it.
-    witness |= !wire;
-#endif
-
-    reset();
-
-    if (!previous_output_.from_data(source, wire))
-        return false;
-
-    script_.from_data(source, true);
-
-    // Transaction from_data handles the discontiguous wire witness decoding.
-    if (witness && !wire)
-        witness_.from_data(source, true);
-
-    sequence_ = source.read_4_bytes_little_endian();
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, wire, witness);
 }
 
 void input::reset()
 {
-    previous_output_.reset();
+    recycle();
     script_.reset();
+}
+
+// protected
+void input::recycle()
+{
+    previous_output_.reset();
+    previous_output_.validation = {};
+    script_.recycle();
     witness_.reset();
     sequence_ = 0;
+    invalidate_cache();
 }
 
 // Since empty scripts and zero sequence are valid this relies on the prevout.
@@ -263,21 +239,7 @@ void input::to_data(std::ostream& stream, bool wire, bool witness) const
 
 void input::to_data(writer& sink, bool wire, bool witness) const
 {
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#else
-    // Always write witness to store so that we know how to read it.
-    witness |= !wire;
-#endif
-
-    previous_output_.to_data(sink, wire);
-    script_.to_data(sink, true);
-
-    // Transaction to_data handles the discontiguous wire witness encoding.
-    if (witness && !wire)
-        witness_.to_data(sink, true);
-
-    sink.write_4_bytes_little_endian(sequence_);
+    to_data<writer>(sink, wire, witness);
 }
 
 // Size.
@@ -380,21 +342,7 @@ void input::set_sequence(uint32_t value)
 // protected
 void input::invalidate_cache() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (addresses_)
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        addresses_.reset();
-        //---------------------------------------------------------------------
-        mutex_.unlock_and_lock_upgrade();
-    }
-
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+    addresses_.reset();
 }
 
 payment_address input::address() const
@@ -405,27 +353,12 @@ payment_address input::address() const
 
 payment_address::list input::addresses() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (!addresses_)
+    // TODO: expand to include segregated witness address extraction.
+    return *addresses_.get([this](addresses_ptr& addresses)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-
-        // TODO: expand to include segregated witness address extraction.
-        addresses_ = std::make_shared<payment_address::list>(
+        addresses = std::make_shared<payment_address::list>(
             payment_address::extract_input(script_));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
-    }
-
-    const auto addresses = *addresses_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return addresses;
+    });
 }
 
 // Utilities.
@@ -487,7 +420,8 @@ size_t input::signature_operations(bool bip16, bool bip141) const
     const auto sigops_factor = bip141 ? fast_sigops_factor : 1u;
 
     // Count heavy sigops in the input script.
-    auto sigops = script_.sigops(false) * sigops_factor;
+    const auto& metadata = script_.metadata();
+    auto sigops = metadata.sigops * sigops_factor;
 
     if (bip141 && witness_.extract_sigop_script(witness, prevout))
     {
@@ -495,9 +429,12 @@ size_t input::signature_operations(bool bip16, bool bip141) const
         return sigops + witness.sigops(true);
     }
 
-    if (bip16 && extract_embedded_script(embedded))
+    // This is extract_embedded_script without parsing the embedded script.
+    if (bip16 && metadata.relaxed_push && !script_.empty() &&
+        prevout.is_pay_to_script_hash(rule_fork::bip16_rule))
     {
-        if (bip141 && witness_.extract_sigop_script(witness, embedded))
+        if (bip141 && extract_embedded_script(embedded) &&
+            witness_.extract_sigop_script(witness, embedded))
         {
             // Add sigops in the embedded witness (bip141).
             return sigops + witness.sigops(true);
@@ -505,7 +442,7 @@ size_t input::signature_operations(bool bip16, bool bip141) const
         else
         {
             // Add heavy sigops in the embedded script (bip16).
-            return sigops + embedded.sigops(true) * sigops_factor;
+            return sigops + metadata.embedded_sigops * sigops_factor;
         }
     }
 
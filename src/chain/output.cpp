@@ -24,8 +24,10 @@
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 #include <bitcoin/bitcoin/wallet/payment_address.hpp>
 
 namespace libbitcoin {
@@ -50,7 +52,7 @@ output::output()
 }
 
 output::output(output&& other)
-  : addresses_(other.addresses_cache()),
+  : addresses_(other.addresses_),
     value_(other.value_),
     script_(std::move(other.script_)),
     validation(other.validation)
@@ -58,7 +60,7 @@ output::output(output&& other)
 }
 
 output::output(const output& other)
-  : addresses_(other.addresses_cache()),
+  : addresses_(other.addresses_),
     value_(other.value_),
     script_(other.script_),
     validation(other.validation)
@@ -79,23 +81,12 @@ output::output(uint64_t value, const chain::script& script)
 {
 }
 
-// Private cache access for copy/move construction.
-output::addresses_ptr output::addresses_cache() const
-{
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    shared_lock lock(mutex_);
-
-    return addresses_;
-    ///////////////////////////////////////////////////////////////////////////
-}
-
 // Operators.
 //-----------------------------------------------------------------------------
 
 output& output::operator=(output&& other)
 {
-    addresses_ = other.addresses_cache();
+    addresses_ = other.addresses_;
     value_ = other.value_;
     script_ = std::move(other.script_);
     validation = std::move(other.validation);
@@ -104,7 +95,7 @@ output& output::operator=(output&& other)
 
 output& output::operator=(const output& other)
 {
-    addresses_ = other.addresses_cache();
+    addresses_ = other.addresses_;
     value_ = other.value_;
     script_ = other.script_;
     validation = other.validation;
@@ -147,8 +138,8 @@ output output::factory_from_data(reader& source, bool wire)
 
 bool output::from_data(const data_chunk& data, bool wire)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire);
 }
 
 bool output::from_data(std::istream& stream, bool wire)
@@ -159,27 +150,25 @@ bool output::from_data(std::istream& stream, bool wire)
 
 bool output::from_data(reader& source, bool wire, bool)
 {
-    reset();
-
-    if (!wire)
-        validation.spender_height = source.read_4_bytes_little_endian();
-
-    value_ = source.read_8_bytes_little_endian();
-    script_.from_data(source, true);
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, wire);
 }
 
 // protected
 void output::reset()
 {
-    value_ = output::not_found;
+    recycle();
     script_.reset();
 }
 
+// protected
+void output::recycle()
+{
+    value_ = output::not_found;
+    script_.recycle();
+    validation = {};
+    invalidate_cache();
+}
+
 // Empty scripts are valid, validation relies on not_found only.
 bool output::is_valid() const
 {
@@ -191,13 +180,9 @@ bool output::is_valid() const
 
 data_chunk output::to_data(bool wire) const
 {
-    data_chunk data;
-    const auto size = serialized_size(wire);
-    data.reserve(size);
-    data_sink ostream(data);
-    to_data(ostream, wire);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
+    data_chunk data(serialized_size(wire));
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, wire);
     return data;
 }
 
@@ -209,14 +194,7 @@ void output::to_data(std::ostream& stream, bool wire) const
 
 void output::to_data(writer& sink, bool wire, bool) const
 {
-    if (!wire)
-    {
-        auto height32 = safe_unsigned<uint32_t>(validation.spender_height);
-        sink.write_4_bytes_little_endian(height32);
-    }
-
-    sink.write_8_bytes_little_endian(value_);
-    script_.to_data(sink, true);
+    to_data<writer>(sink, wire);
 }
 
 // Size.
@@ -267,21 +245,7 @@ void output::set_script(chain::script&& value)
 // protected
 void output::invalidate_cache() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (addresses_)
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        addresses_.reset();
-        //---------------------------------------------------------------------
-        mutex_.unlock_and_lock_upgrade();
-    }
-
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+    addresses_.reset();
 }
 payment_address output::address(bool testnet /*= false*/) const{
     if (testnet){
@@ -301,26 +265,12 @@ payment_address output::address(uint8_t p2kh_version,
 payment_address::list output::addresses(uint8_t p2kh_version,
     uint8_t p2sh_version) const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (!addresses_)
+    return *addresses_.get([&](addresses_ptr& addresses)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        addresses_ = std::make_shared<payment_address::list>(
+        addresses = std::make_shared<payment_address::list>(
             payment_address::extract_output(script_, p2kh_version,
                 p2sh_version));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
-    }
-
-    const auto addresses = *addresses_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return addresses;
+    });
 }
 
 // Validation helpers.
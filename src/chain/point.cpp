@@ -27,6 +27,7 @@
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/serializer.hpp>
@@ -144,8 +145,8 @@ point point::factory_from_data(reader& source, bool wire)
 
 bool point::from_data(const data_chunk& data, bool wire)
 {
-    data_source istream(data);
-    return from_data(istream, wire);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire);
 }
 
 bool point::from_data(std::istream& stream, bool wire)
@@ -156,27 +157,7 @@ bool point::from_data(std::istream& stream, bool wire)
 
 bool point::from_data(reader& source, bool wire)
 {
-    reset();
-
-    valid_ = true;
-    hash_ = source.read_hash();
-
-    if (wire)
-    {
-        index_ = source.read_4_bytes_little_endian();
-    }
-    else
-    {
-        index_ = source.read_2_bytes_little_endian();
-
-        if (index_ == max_uint16)
-            index_ = null_index;
-    }
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, wire);
 }
 
 // protected
@@ -197,13 +178,9 @@ bool point::is_valid() const
 
 data_chunk point::to_data(bool wire) const
 {
-    data_chunk data;
-    const auto size = serialized_size(wire);
-    data.reserve(size);
-    data_sink ostream(data);
-    to_data(ostream, wire);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
+    data_chunk data(serialized_size(wire));
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, wire);
     return data;
 }
 
@@ -215,17 +192,7 @@ void point::to_data(std::ostream& stream, bool wire) const
 
 void point::to_data(writer& sink, bool wire) const
 {
-    sink.write_hash(hash_);
-
-    if (wire)
-    {
-        sink.write_4_bytes_little_endian(index_);
-    }
-    else
-    {
-        BITCOIN_ASSERT(index_ == null_index || index_ < max_uint16);
-        sink.write_2_bytes_little_endian(static_cast<uint16_t>(index_));
-    }
+    to_data<writer>(sink, wire);
 }
 
 // Iterator.
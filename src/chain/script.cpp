@@ -19,6 +19,7 @@
 #include <bitcoin/bitcoin/chain/script.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
@@ -26,7 +27,6 @@
 #include <numeric>
 #include <sstream>
 #include <utility>
-#include <boost/range/adaptor/reversed.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/chain/witness.hpp>
@@ -34,6 +34,8 @@
 #include <bitcoin/bitcoin/formats/base_16.hpp>
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/math/signature_cache.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/interpreter.hpp>
 #include <bitcoin/bitcoin/machine/opcode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
@@ -48,38 +50,47 @@
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 #include <bitcoin/bitcoin/utility/string.hpp>
+#include "sighash_context.hpp"
+#include "view_reader.hpp"
 
 
 namespace libbitcoin {
 namespace chain {
 
 using namespace bc::machine;
-using namespace boost::adaptors;
 
 // bit.ly/2cPazSa
 static const auto one_hash = hash_literal(
     "0000000000000000000000000000000000000000000000000000000000000001");
 
+// Optional, installed by the owner of the cache (see set_signature_cache).
+static std::atomic<signature_cache*> signature_cache_(nullptr);
+
 // Constructors.
 //-----------------------------------------------------------------------------
 
 // A default instance is invalid (until modified).
 script::script()
-  : valid_(false), cached_(false)
+  : valid_(false)
 {
 }
 
 script::script(script&& other)
-  : bytes_(std::move(other.bytes_)), valid_(other.valid_), cached_(false)
+  : bytes_(std::move(other.bytes_)), valid_(other.valid_),
+    metadata_(other.metadata_)
 {
     // TODO: implement safe private accessor for conditional cache transfer.
+    other.metadata_.reset();
 }
 
 script::script(const script& other)
-  : bytes_(other.bytes_), valid_(other.valid_), cached_(false)
+  : bytes_(other.bytes_), valid_(other.valid_), metadata_(other.metadata_)
 {
     // TODO: implement safe private accessor for conditional cache transfer.
 }
@@ -104,7 +115,6 @@ script::script(data_chunk&& encoded, bool prefix)
 
     // This is an optimization that avoids streaming the encoded bytes.
     bytes_ = std::move(encoded);
-    cached_ = false;
     valid_ = true;
 }
 
@@ -123,6 +133,8 @@ script& script::operator=(script&& other)
     reset();
     bytes_ = std::move(other.bytes_);
     valid_ = other.valid_;
+    metadata_ = other.metadata_;
+    other.metadata_.reset();
     return *this;
 }
 
@@ -133,6 +145,7 @@ script& script::operator=(const script& other)
     reset();
     bytes_ = other.bytes_;
     valid_ = other.valid_;
+    metadata_ = other.metadata_;
     return *this;
 }
 
@@ -175,8 +188,8 @@ script script::factory_from_data(reader& source, bool prefix)
 
 bool script::from_data(const data_chunk& encoded, bool prefix)
 {
-    data_source istream(encoded);
-    return from_data(istream, prefix);
+    auto source = make_safe_deserializer(encoded.begin(), encoded.end());
+    return from_data(source, prefix);
 }
 
 bool script::from_data(std::istream& stream, bool prefix)
@@ -185,32 +198,9 @@ bool script::from_data(std::istream& stream, bool prefix)
     return from_data(source, prefix);
 }
 
-// Concurrent read/write is not supported, so no critical section.
 bool script::from_data(reader& source, bool prefix)
 {
-    reset();
-    valid_ = true;
-
-    if (prefix)
-    {
-        const auto size = source.read_size_little_endian();
-
-        // The max_script_size constant limits evaluation, but not all scripts
-        // evaluate, so use max_block_size to guard memory allocation here.
-        if (size > get_max_block_size())
-            source.invalidate();
-        else
-            bytes_ = source.read_bytes(size);
-    }
-    else
-    {
-        bytes_ = source.read_bytes();
-    }
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, prefix);
 }
 
 // Concurrent read/write is not supported, so no critical section.
@@ -237,8 +227,9 @@ void script::from_operations(operation::list&& ops)
 {
     ////reset();
     bytes_ = operations_to_data(ops);
-    operations_ = std::move(ops);
-    cached_ = true;
+    operations_.store(std::move(ops));
+    bytecode_.reset();
+    metadata_.reset();
     valid_ = true;
 }
 
@@ -247,8 +238,9 @@ void script::from_operations(const operation::list& ops)
 {
     ////reset();
     bytes_ = operations_to_data(ops);
-    operations_ = ops;
-    cached_ = true;
+    operations_.store(ops);
+    bytecode_.reset();
+    metadata_.reset();
     valid_ = true;
 }
 
@@ -284,12 +276,23 @@ size_t script::serialized_size(const operation::list& ops)
 // Concurrent read/write is not supported, so no critical section.
 void script::reset()
 {
-    bytes_.clear();
+    recycle();
     bytes_.shrink_to_fit();
-    valid_ = false;
-    cached_ = false;
     operations_.clear();
-    operations_.shrink_to_fit();
+    bytecode_.clear();
+    metadata_.clear();
+}
+
+// protected
+// Storage is retained for reuse by deserialization.
+// Concurrent read/write is not supported, so no critical section.
+void script::recycle()
+{
+    bytes_.clear();
+    valid_ = false;
+    operations_.reset();
+    bytecode_.reset();
+    metadata_.reset();
 }
 
 bool script::is_valid() const
@@ -303,7 +306,8 @@ bool script::is_valid_operations() const
 {
     // Script validity is independent of individual operation validity.
     // There is a trailing invalid/default op if a push op had a size mismatch.
-    return operations().empty() || operations_.back().is_valid();
+    const auto& ops = operations();
+    return ops.empty() || ops.back().is_valid();
 }
 
 // Serialization.
@@ -311,13 +315,9 @@ bool script::is_valid_operations() const
 
 data_chunk script::to_data(bool prefix) const
 {
-    data_chunk data;
-    const auto size = serialized_size(prefix);
-    data.reserve(size);
-    data_sink ostream(data);
-    to_data(ostream, prefix);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
+    data_chunk data(serialized_size(prefix));
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, prefix);
     return data;
 }
 
@@ -329,11 +329,7 @@ void script::to_data(std::ostream& stream, bool prefix) const
 
 void script::to_data(writer& sink, bool prefix) const
 {
-    // TODO: optimize by always storing the prefixed serialization.
-    if (prefix)
-        sink.write_variable_little_endian(serialized_size(false));
-
-    sink.write_bytes(bytes_);
+    to_data<writer>(sink, prefix);
 }
 
 std::string script::to_string(uint32_t active_forks) const
@@ -415,66 +411,50 @@ size_t script::serialized_size(bool prefix) const
 // protected
 const operation::list& script::operations() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (cached_)
+    return operations_.get([this](operation::list& ops)
     {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return operations_;
-    }
-
-    operation op;
-    data_source istream(bytes_);
-    istream_reader source(istream);
-    const auto size = bytes_.size();
-
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    mutex_.unlock_upgrade_and_lock();
-
-    // One operation per byte is the upper limit of operations.
-    operations_.reserve(size);
+        operation op;
+        data_source istream(bytes_);
+        istream_reader source(istream);
+        const auto size = bytes_.size();
+
+        // One operation per byte is the upper limit of operations.
+        ops.clear();
+        ops.reserve(size);
+
+        // ********************************************************************
+        // CONSENSUS: In the case of a coinbase script we must parse the entire
+        // script, beyond just the BIP34 requirements, so that sigops can be
+        // calculated from the script. These are counted despite being
+        // irrelevant. In this case an invalid script is parsed to the extent
+        // possible.
+        // ********************************************************************
+
+        // If an op fails it is pushed to operations and the loop terminates.
+        // To validate the ops the caller must test the last op.is_valid(), or
+        // may text script.is_valid_operations(), which is done in script
+        // validation.
+        while (!source.is_exhausted())
+        {
+            op.from_data(source);
+            ops.push_back(std::move(op));
+        }
 
-    // ************************************************************************
-    // CONSENSUS: In the case of a coinbase script we must parse the entire
-    // script, beyond just the BIP34 requirements, so that sigops can be
-    // calculated from the script. These are counted despite being irrelevant.
-    // In this case an invalid script is parsed to the extent possible.
-    // ************************************************************************
+        ops.shrink_to_fit();
+    });
+}
 
-    // If an op fails it is pushed to operations and the loop terminates.
-    // To validate the ops the caller must test the last op.is_valid(), or may
-    // text script.is_valid_operations(), which is done in script validation.
-    while (!source.is_exhausted())
+const machine::bytecode& script::bytecode() const
+{
+    return *bytecode_.get([this](machine::bytecode::ptr& code)
     {
-        op.from_data(source);
-        operations_.push_back(std::move(op));
-    }
-
-    operations_.shrink_to_fit();
-    cached_ = true;
-
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return operations_;
+        code = std::make_shared<const machine::bytecode>(*this);
+    });
 }
 
 // Signing (unversioned).
 //-----------------------------------------------------------------------------
 
-inline hash_digest signature_hash(const transaction& tx, uint32_t sighash_type)
-{
-    // There is no rational interpretation of a signature hash for a coinbase.
-    BITCOIN_ASSERT(!tx.is_coinbase());
-
-    auto serialized = tx.to_data(true, false);
-    extend_data(serialized, to_little_endian(sighash_type));
-    return bitcoin_hash(serialized);
-}
-
 //*****************************************************************************
 // CONSENSUS: Due to masking of bits 6/7 (8 is the anyone_can_pay flag),
 // there are 4 possible 7 bit values that can set "single" and 4 others that
@@ -498,125 +478,10 @@ inline uint8_t is_sighash_enum(uint8_t sighash_type, sighash_algorithm value)
     return to_sighash_enum(sighash_type) == value;
 }
 
-static hash_digest sign_none(const transaction& tx, uint32_t input_index,
-    const script& script_code, uint8_t sighash_type)
-{
-    input::list ins;
-    const auto& inputs = tx.inputs();
-    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
-    ins.reserve(any ? 1 : inputs.size());
-
-    BITCOIN_ASSERT(input_index < inputs.size());
-    const auto& self = inputs[input_index];
-
-    if (any)
-    {
-        // Retain only self.
-        ins.emplace_back(self.previous_output(), script_code, self.sequence());
-    }
-    else
-    {
-        // Erase all input scripts and sequences.
-        for (const auto& input: inputs)
-            ins.emplace_back(input.previous_output(), script{}, 0);
-
-        // Replace self that is lost in the loop.
-        ins[input_index].set_script(script_code);
-        ins[input_index].set_sequence(self.sequence());
-    }
-
-    // Move new inputs to new transaction and drop outputs.
-    return signature_hash({ tx.version(), tx.locktime(), std::move(ins), {} },
-        sighash_type);
-}
-
-static hash_digest sign_single(const transaction& tx, uint32_t input_index,
-    const script& script_code, uint8_t sighash_type)
-{
-    input::list ins;
-    const auto& inputs = tx.inputs();
-    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
-    ins.reserve(any ? 1 : inputs.size());
-
-    BITCOIN_ASSERT(input_index < inputs.size());
-    const auto& self = inputs[input_index];
-
-    if (any)
-    {
-        // Retain only self.
-        ins.emplace_back(self.previous_output(), script_code, self.sequence());
-    }
-    else
-    {
-        // Erase all input scripts and sequences.
-        for (const auto& input: inputs)
-            ins.emplace_back(input.previous_output(), script{}, 0);
-
-        // Replace self that is lost in the loop.
-        ins[input_index].set_script(script_code);
-        ins[input_index].set_sequence(self.sequence());
-    }
-
-    // Trim and clear outputs except that of specified input index.
-    const auto& outputs = tx.outputs();
-    output::list outs(input_index + 1);
-
-    BITCOIN_ASSERT(input_index < outputs.size());
-    outs.back() = outputs[input_index];
-
-    // Move new inputs and new outputs to new transaction.
-    return signature_hash({ tx.version(), tx.locktime(), std::move(ins),
-        std::move(outs) }, sighash_type);
-}
-
-static hash_digest sign_all(const transaction& tx, uint32_t input_index,
-    const script& script_code, uint8_t sighash_type)
-{
-    input::list ins;
-    const auto& inputs = tx.inputs();
-    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
-    ins.reserve(any ? 1 : inputs.size());
-
-    BITCOIN_ASSERT(input_index < inputs.size());
-    const auto& self = inputs[input_index];
-
-    if (any)
-    {
-        // Retain only self.
-        ins.emplace_back(self.previous_output(), script_code, self.sequence());
-    }
-    else
-    {
-        // Erase all input scripts.
-        for (const auto& input: inputs)
-            ins.emplace_back(input.previous_output(), script{},
-                input.sequence());
-
-        // Replace self that is lost in the loop.
-        ins[input_index].set_script(script_code);
-        ////ins[input_index].set_sequence(self.sequence());
-    }
-
-    // Move new inputs and copy outputs to new transaction.
-    transaction out(tx.version(), tx.locktime(), input::list{}, tx.outputs());
-    out.set_inputs(std::move(ins));
-    return signature_hash(out, sighash_type);
-}
-
-static script strip_code_seperators(const script& script_code)
-{
-    operation::list ops;
-
-    for (auto op = script_code.begin(); op != script_code.end(); ++op)
-        if (op->code() != opcode::codeseparator)
-            ops.push_back(*op);
-
-    return script(std::move(ops));
-}
-
 // private/static
 hash_digest script::generate_unversioned_signature_hash(const transaction& tx,
-    uint32_t input_index, const script& script_code, uint8_t sighash_type)
+    uint32_t input_index, const script_code_view& script_code,
+    uint8_t sighash_type)
 {
     const auto sighash = to_sighash_enum(sighash_type);
     if (input_index >= tx.inputs().size() ||
@@ -629,22 +494,10 @@ hash_digest script::generate_unversioned_signature_hash(const transaction& tx,
         return one_hash;
     }
 
-    //*************************************************************************
-    // CONSENSUS: more wacky satoshi behavior.
-    //*************************************************************************
-    const auto stripped = strip_code_seperators(script_code);
-
-    // The sighash serializations are isolated for clarity and optimization.
-    switch (sighash)
-    {
-        case sighash_algorithm::none:
-            return sign_none(tx, input_index, stripped, sighash_type);
-        case sighash_algorithm::single:
-            return sign_single(tx, input_index, stripped, sighash_type);
-        default:
-        case sighash_algorithm::all:
-            return sign_all(tx, input_index, stripped, sighash_type);
-    }
+    // The shared serialization is built once per transaction and reused.
+    // The context skips code separators in place of stripping a script copy.
+    return tx.unversioned_context()->signature_hash(tx, input_index,
+        script_code, sighash_type);
 }
 
 // Signing (version 0).
@@ -652,107 +505,50 @@ hash_digest script::generate_unversioned_signature_hash(const transaction& tx,
 
 hash_digest script::to_outputs(const transaction& tx)
 {
-    const auto sum = [&](size_t total, const output& output)
-    {
-        return total + output.serialized_size();
-    };
-
-    const auto& outs = tx.outputs();
-    auto size = std::accumulate(outs.begin(), outs.end(), size_t(0), sum);
-    data_chunk data;
-    data.reserve(size);
-    data_sink ostream(data);
-    ostream_writer sink(ostream);
+    hash_writer sink;
 
-    const auto write = [&](const output& output)
-    {
+    for (const auto& output: tx.outputs())
         output.to_data(sink, true);
-    };
 
-    std::for_each(outs.begin(), outs.end(), write);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
-    return bitcoin_hash(data);
+    return sink.bitcoin_hash();
 }
 
 hash_digest script::to_inpoints(const transaction& tx)
 {
-    const auto sum = [&](size_t total, const input& input)
-    {
-        return total + input.previous_output().serialized_size();
-    };
-
-    const auto& ins = tx.inputs();
-    auto size = std::accumulate(ins.begin(), ins.end(), size_t(0), sum);
-    data_chunk data;
-    data.reserve(size);
-    data_sink ostream(data);
-    ostream_writer sink(ostream);
+    hash_writer sink;
 
-    const auto write = [&](const input& input)
-    {
+    for (const auto& input: tx.inputs())
         input.previous_output().to_data(sink);
-    };
 
-    std::for_each(ins.begin(), ins.end(), write);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
-    return bitcoin_hash(data);
+    return sink.bitcoin_hash();
 }
 
 hash_digest script::to_sequences(const transaction& tx)
 {
-    const auto sum = [&](size_t total, const input& input)
-    {
-        return total + sizeof(uint32_t);
-    };
-
-    const auto& ins = tx.inputs();
-    auto size = std::accumulate(ins.begin(), ins.end(), size_t(0), sum);
-    data_chunk data;
-    data.reserve(size);
-    data_sink ostream(data);
-    ostream_writer sink(ostream);
+    hash_writer sink;
 
-    const auto write = [&](const input& input)
-    {
+    for (const auto& input: tx.inputs())
         sink.write_4_bytes_little_endian(input.sequence());
-    };
 
-    std::for_each(ins.begin(), ins.end(), write);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
-    return bitcoin_hash(data);
+    return sink.bitcoin_hash();
 }
 
-static size_t preimage_size(size_t script_size)
+static hash_digest to_output(const output& output)
 {
-    return sizeof(uint32_t)
-        + hash_size
-        + hash_size
-        + point::satoshi_fixed_size()
-        + script_size
-        + sizeof(uint64_t)
-        + sizeof(uint32_t)
-        + hash_size
-        + sizeof(uint32_t)
-        + sizeof(uint32_t);
+    hash_writer sink;
+    output.to_data(sink, true);
+    return sink.bitcoin_hash();
 }
 
 // private/static
 hash_digest script::generate_version_0_signature_hash(const transaction& tx,
-    uint32_t input_index, const script& script_code, uint64_t value,
+    uint32_t input_index, const script_code_view& script_code, uint64_t value,
     uint8_t sighash_type)
 {
     // Unlike unversioned algorithm this does not allow an invalid input index.
     BITCOIN_ASSERT(input_index < tx.inputs().size());
     const auto& input = tx.inputs()[input_index];
-    const auto size = preimage_size(script_code.serialized_size(true));
-
-    data_chunk data;
-    data.reserve(size);
-    data_sink ostream(data);
-    ostream_writer sink(ostream);
+    hash_writer sink;
 
     // Flags derived from the signature hash byte.
     const auto sighash = to_sighash_enum(sighash_type);
@@ -785,7 +581,7 @@ hash_digest script::generate_version_0_signature_hash(const transaction& tx,
     // 8. outputs hash (32-byte hash).
     sink.write_hash(all ? tx.outputs_hash() :
         (single && input_index < tx.outputs().size() ?
-            bitcoin_hash(tx.outputs()[input_index].to_data()) : null_hash));
+            to_output(tx.outputs()[input_index]) : null_hash));
 
     // 9. transaction locktime (4-byte little endian).
     sink.write_little_endian(tx.locktime());
@@ -793,9 +589,7 @@ hash_digest script::generate_version_0_signature_hash(const transaction& tx,
     // 10. sighash type of the signature (4-byte [not 1] little endian).
     sink.write_4_bytes_little_endian(sighash_type);
 
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
-    return bitcoin_hash(data);
+    return sink.bitcoin_hash();
 }
 
 // Signing (common).
@@ -803,7 +597,8 @@ hash_digest script::generate_version_0_signature_hash(const transaction& tx,
 
 // static
 hash_digest script::generate_signature_hash(const transaction& tx,
-    uint32_t input_index, const script& script_code, uint8_t sighash_type,
+    uint32_t input_index, const script_code_view& script_code,
+    uint8_t sighash_type,
     script_version version, uint64_t value)
 {
     // The way of serialization is changed (bip143).
@@ -825,8 +620,8 @@ hash_digest script::generate_signature_hash(const transaction& tx,
 // static
 bool script::check_signature(const ec_signature& signature,
     uint8_t sighash_type, const data_chunk& public_key,
-    const script& script_code, const transaction& tx, uint32_t input_index,
-    script_version version, uint64_t value)
+    const script_code_view& script_code, const transaction& tx,
+    uint32_t input_index, script_version version, uint64_t value)
 {
     if (public_key.empty())
         return false;
@@ -835,8 +630,65 @@ bool script::check_signature(const ec_signature& signature,
     const auto sighash = chain::script::generate_signature_hash(tx,
         input_index, script_code, sighash_type, version, value);
 
+    const auto cache = signature_cache_.load();
+
+    // A cached tuple has already passed verification, skip secp256k1.
+    if (cache != nullptr && cache->contains(sighash, public_key, signature))
+        return true;
+
     // Validate the EC signature.
-    return verify_signature(public_key, sighash, signature);
+    if (!verify_signature(public_key, sighash, signature))
+        return false;
+
+    if (cache != nullptr)
+        cache->store(sighash, public_key, signature);
+
+    return true;
+}
+
+// static
+void script::set_signature_cache(signature_cache* cache)
+{
+    signature_cache_.store(cache);
+}
+
+// static
+bool script::defer_signature(ec_verification::list& batch,
+    const ec_signature& signature, uint8_t sighash_type,
+    const data_chunk& public_key, const script_code_view& script_code,
+    const transaction& tx, uint32_t input_index, script_version version,
+    uint64_t value)
+{
+    if (public_key.empty())
+        return false;
+
+    // This always produces a valid signature hash, including one_hash.
+    const auto sighash = chain::script::generate_signature_hash(tx,
+        input_index, script_code, sighash_type, version, value);
+
+    const auto cache = signature_cache_.load();
+
+    // A cached tuple has already passed verification, do not queue it.
+    if (cache != nullptr && cache->contains(sighash, public_key, signature))
+        return true;
+
+    batch.push_back({ public_key, sighash, signature });
+    return true;
+}
+
+// static
+bool script::verify_deferred(const ec_verification::list& batch)
+{
+    if (verify_signatures(batch) != batch.size())
+        return false;
+
+    const auto cache = signature_cache_.load();
+
+    if (cache != nullptr)
+        for (const auto& item: batch)
+            cache->store(item.hash, item.point, item.signature);
+
+    return true;
 }
 
 // static
@@ -1157,179 +1009,218 @@ operation::list script::to_pay_multisig_pattern(uint8_t signatures,
 // Utilities (non-static).
 //-----------------------------------------------------------------------------
 
-data_chunk script::witness_program() const
+// Count 1..16 multisig accurately for embedded (bip16) and witness (bip141).
+inline size_t multisig_sigops(bool accurate, opcode code)
 {
-    // The first operations access must be method-based to guarantee the cache.
-    const auto& ops = operations();
-    return is_witness_program_pattern(ops) ? ops[1].data() : data_chunk{};
+    return accurate && operation::is_positive(code) ?
+        operation::opcode_to_positive(code) : multisig_default_sigops;
 }
 
-script_version script::version() const
+// Sigops are counted over the bytes, so the embedded script is not parsed.
+static size_t count_sigops(data_slice bytes, bool accurate)
 {
-    // The first operations access must be method-based to guarantee the cache.
-    const auto& ops = operations();
+    size_t total = 0;
+    auto preceding = opcode::reserved_255;
+    view_reader reader(bytes.begin(), bytes.end());
 
-    if (!is_witness_program_pattern(ops))
-        return script_version::unversioned;
+    while (reader.is_valid() && reader.remaining() != 0)
+    {
+        const auto code = reader.read_operation();
 
-    // Version 0 is specified, others are reserved (bip141).
-    return (ops[0].code() == opcode::push_size_0) ? script_version::zero :
-        script_version::reserved;
+        if (code == opcode::checksig ||
+            code == opcode::checksigverify)
+        {
+            ++total;
+        }
+        else if (code == opcode::checkmultisig ||
+            code == opcode::checkmultisigverify)
+        {
+            total += multisig_sigops(accurate, preceding);
+        }
+
+        preceding = code;
+    }
+
+    return total;
 }
 
-// Caller should test for is_sign_script_hash_pattern when sign_key_hash result
-// as it is possible for an input script to match both patterns.
-script_pattern script::pattern() const
+// The byte offset of the data of the operation at index (within the script).
+static uint32_t data_offset(const operation::list& ops, size_t index)
 {
-    const auto input = output_pattern();
-    return input == script_pattern::non_standard ? input_pattern() : input;
+    const auto op_size = [](size_t total, const operation& op)
+    {
+        return total + op.serialized_size();
+    };
+
+    const auto& op = ops[index];
+    const auto offset = std::accumulate(ops.begin(), ops.begin() + index,
+        size_t{0}, op_size) + op.serialized_size() - op.data().size();
+    return static_cast<uint32_t>(offset);
 }
 
-// Output patterns are mutually and input unambiguous.
-// The bip141 coinbase pattern is not tested here, must test independently.
-script_pattern script::output_pattern() const
+const script_metadata& script::metadata() const
 {
-    // The first operations access must be method-based to guarantee the cache.
-    if (is_pay_key_hash_pattern(operations()))
-        return script_pattern::pay_key_hash;
+    return metadata_.get([this](script_metadata& out)
+    {
+        // The first operations access must be method-based to guarantee the
+        // cache.
+        const auto& ops = operations();
+        out = script_metadata{};
+
+        // Output patterns are mutually and input unambiguous.
+        // The bip141 coinbase pattern is not tested, must test independently.
+        if (is_pay_key_hash_pattern(ops))
+            out.output_pattern = script_pattern::pay_key_hash;
+        else if (is_pay_script_hash_pattern(ops))
+            out.output_pattern = script_pattern::pay_script_hash;
+        else if (is_null_data_pattern(ops))
+            out.output_pattern = script_pattern::null_data;
+        else if (is_pay_public_key_pattern(ops))
+            out.output_pattern = script_pattern::pay_public_key;
+        else if (is_pay_multisig_pattern(ops))
+            out.output_pattern = script_pattern::pay_multisig;
+
+        // A sign_key_hash result always implies sign_script_hash as well.
+        // The bip34 coinbase pattern is not tested, must test independently.
+        if (is_sign_key_hash_pattern(ops))
+            out.input_pattern = script_pattern::sign_key_hash;
+        else if (is_sign_script_hash_pattern(ops))
+            out.input_pattern = script_pattern::sign_script_hash;
+        else if (is_sign_public_key_pattern(ops))
+            out.input_pattern = script_pattern::sign_public_key;
+        else if (is_sign_multisig_pattern(ops))
+            out.input_pattern = script_pattern::sign_multisig;
+
+        // Version 0 is specified, others are reserved (bip141).
+        if (is_witness_program_pattern(ops))
+            out.version = (ops[0].code() == opcode::push_size_0) ?
+                script_version::zero : script_version::reserved;
+
+        switch (out.output_pattern)
+        {
+            case script_pattern::pay_key_hash:
+                out.payload_offset = data_offset(ops, 2);
+                out.payload_size = short_hash_size;
+                break;
+            case script_pattern::pay_script_hash:
+                out.payload_offset = data_offset(ops, 1);
+                out.payload_size = short_hash_size;
+                break;
+            case script_pattern::pay_public_key:
+                out.payload_offset = data_offset(ops, 0);
+                out.payload_size = ops[0].data().size();
+                break;
+            default:
+                if (out.version != script_version::unversioned)
+                {
+                    out.payload_offset = data_offset(ops, 1);
+                    out.payload_size = ops[1].data().size();
+                }
+                break;
+        }
 
-    if (is_pay_script_hash_pattern(operations_))
-        return script_pattern::pay_script_hash;
+        out.sigops = count_sigops(bytes_, false);
+        out.accurate_sigops = count_sigops(bytes_, true);
+        out.push_only = is_push_only(ops);
+        out.relaxed_push = is_relaxed_push(ops);
+        out.unspendable = (!ops.empty() && ops.front().code() == opcode::return_)
+            || serialized_size(false) > max_script_size;
 
-    if (is_null_data_pattern(operations_))
-        return script_pattern::null_data;
+        // The last push of a relaxed push script is the bip16 embedded script.
+        if (out.relaxed_push && !ops.empty())
+            out.embedded_sigops = count_sigops(ops.back().data(), true);
+    });
+}
 
-    if (is_pay_public_key_pattern(operations_))
-        return script_pattern::pay_public_key;
+data_slice script::payload() const
+{
+    const auto& data = metadata();
+    const auto begin = bytes_.data() + data.payload_offset;
+    return{ begin, begin + data.payload_size };
+}
 
-    if (is_pay_multisig_pattern(operations_))
-        return script_pattern::pay_multisig;
+data_chunk script::witness_program() const
+{
+    if (metadata().version == script_version::unversioned)
+        return{};
 
-    return script_pattern::non_standard;
+    const auto program = payload();
+    return{ program.begin(), program.end() };
 }
 
-// A sign_key_hash result always implies sign_script_hash as well.
-// The bip34 coinbase pattern is not tested here, must test independently.
-script_pattern script::input_pattern() const
+script_version script::version() const
 {
-    // The first operations access must be method-based to guarantee the cache.
-    if (is_sign_key_hash_pattern(operations()))
-        return script_pattern::sign_key_hash;
-
-    // This must follow is_sign_key_hash_pattern for ambiguity comment to hold.
-    if (is_sign_script_hash_pattern(operations_))
-        return script_pattern::sign_script_hash;
+    return metadata().version;
+}
 
-    if (is_sign_public_key_pattern(operations_))
-        return script_pattern::sign_public_key;
+// Caller should test for is_sign_script_hash_pattern when sign_key_hash result
+// as it is possible for an input script to match both patterns.
+script_pattern script::pattern() const
+{
+    const auto& data = metadata();
+    return data.output_pattern == script_pattern::non_standard ?
+        data.input_pattern : data.output_pattern;
+}
 
-    if (is_sign_multisig_pattern(operations_))
-        return script_pattern::sign_multisig;
+script_pattern script::output_pattern() const
+{
+    return metadata().output_pattern;
+}
 
-    return script_pattern::non_standard;
+script_pattern script::input_pattern() const
+{
+    return metadata().input_pattern;
 }
 
 bool script::is_pay_to_witness(uint32_t forks) const
 {
     // This is used internally as an optimization over using script::pattern.
-    // The first operations access must be method-based to guarantee the cache.
     return is_enabled(forks, rule_fork::bip141_rule) &&
-        is_witness_program_pattern(operations());
+        metadata().version != script_version::unversioned;
 }
 
 bool script::is_pay_to_script_hash(uint32_t forks) const
 {
     // This is used internally as an optimization over using script::pattern.
-    // The first operations access must be method-based to guarantee the cache.
     return is_enabled(forks, rule_fork::bip16_rule) &&
-        is_pay_script_hash_pattern(operations());
-}
-
-// Count 1..16 multisig accurately for embedded (bip16) and witness (bip141).
-inline size_t multisig_sigops(bool accurate, opcode code)
-{
-    return accurate && operation::is_positive(code) ?
-        operation::opcode_to_positive(code) : multisig_default_sigops;
+        metadata().output_pattern == script_pattern::pay_script_hash;
 }
 
 size_t script::sigops(bool accurate) const
 {
-    size_t total = 0;
-    auto preceding = opcode::reserved_255;
-
-    // The first operations access must be method-based to guarantee the cache.
-    for (const auto& op: operations())
-    {
-        const auto code = op.code();
-
-        if (code == opcode::checksig ||
-            code == opcode::checksigverify)
-        {
-            ++total;
-        }
-        else if (code == opcode::checkmultisig ||
-            code == opcode::checkmultisigverify)
-        {
-            total += multisig_sigops(accurate, preceding);
-        }
-
-        preceding = code;
-    }
-
-    return total;
+    const auto& data = metadata();
+    return accurate ? data.accurate_sigops : data.sigops;
 }
 
-//*****************************************************************************
-// CONSENSUS: this is a pointless, broken, premature optimization attempt.
-// The comparison and erase are not limited to a single operation and so can
-// erase arbitrary upstream data from the script.
-//*****************************************************************************
-void script::find_and_delete_(const data_chunk& endorsement)
+// private
+// True if find_and_delete of the value may change the script. This is a byte
+// search, so it may also match where find_and_delete would not.
+bool script::contains_push(const data_chunk& value) const
 {
-    // If this is empty it would produce an empty script but not operation.
-    // So we test it for empty prior to operation reserialization.
-    if (endorsement.empty())
-        return;
-
-    // The value must be serialized to script using non-minimal encoding.
-    // Non-minimally-encoded target values will therefore not match.
-    const auto value = operation(endorsement, false).to_data();
-
-    operation op;
-    data_source stream(bytes_);
-    istream_reader source(stream);
-    std::vector<data_chunk::iterator> found;
-
-    // The exhaustion test handles stream end and op deserialization failure.
-    for (auto it = bytes_.begin(); !source.is_exhausted();
-        it += source ? op.serialized_size() : 0)
-    {
-        // Track all found values for later deletion.
-        for (; starts_with(it, bytes_.end(), value); it += value.size())
-        {
-            source.skip(value.size());
-            found.push_back(it);
-        }
-
-        // Read the next op code following last found value.
-        op.from_data(source);
-    }
+    if (value.empty())
+        return false;
 
-    // Delete any found values, reversed to prevent iterator invalidation.
-    for (const auto it: reverse(found))
-        bytes_.erase(it, it + value.size());
+    const auto push = operation(value, false).to_data();
+    return std::search(bytes_.begin(), bytes_.end(), push.begin(),
+        push.end()) != bytes_.end();
 }
 
 // Concurrent read/write is not supported, so no critical section.
 void script::find_and_delete(const data_stack& endorsements)
 {
-    for (const auto& endorsement: endorsements)
-        find_and_delete_(endorsement);
+    script_code_view script_code(*this);
+    script_code.find_and_delete(endorsements);
+
+    // Deletion only shrinks the script, so an unchanged size is no deletion.
+    if (script_code.data().size() == bytes_.size())
+        return;
+
+    bytes_ = script_code.to_data(false);
 
     // Invalidate the cache so that the operations may be regenerated.
-    operations_.clear();
-    cached_ = false;
-    bytes_.shrink_to_fit();
+    operations_.reset();
+    bytecode_.reset();
+    metadata_.reset();
 }
 
 ////// This is slightly more efficient because the script does not get parsed,
@@ -1351,9 +1242,7 @@ void script::find_and_delete(const data_stack& endorsements)
 // The criteria below are not be comprehensive but are fast to evaluate.
 bool script::is_unspendable() const
 {
-    // The first operations access must be method-based to guarantee the cache.
-    return (!operations().empty() && operations_[0].code() == opcode::return_)
-        || serialized_size(false) > max_script_size;
+    return metadata().unspendable;
 }
 
 // Validation.
@@ -1364,10 +1253,169 @@ code script::verify(const transaction& tx, uint32_t input_index,
     const script& prevout_script, uint64_t value)
 {
     code ec;
+
+    if (verify_template(ec, tx, input_index, forks, input_script,
+        input_witness, prevout_script))
+        return ec;
+
+    return verify_program(tx, input_index, forks, input_script, input_witness,
+        prevout_script, value);
+}
+
+// The template verifiers must produce the result and error code of program
+// evaluation, so any deviation from the templates is left to the programs.
+bool script::verify_template(code& out, const transaction& tx,
+    uint32_t input_index, uint32_t forks, const script& input_script,
+    const witness& input_witness, const script& prevout_script)
+{
+    if (!input_witness.empty() || !input_script.is_valid_operations() ||
+        !prevout_script.is_valid_operations())
+        return false;
+
+    const auto& input_ops = input_script.operations();
+    const auto& prevout_ops = prevout_script.operations();
+
+    // [endorsement] [public key] : dup hash160 [hash] equalverify checksig
+    if (is_pay_key_hash_pattern(prevout_ops))
+    {
+        if (!is_sign_key_hash_pattern(input_ops) ||
+            prevout_script.contains_push(input_ops[0].data()))
+            return false;
+
+        const auto& hash = prevout_ops[2].data();
+        const auto key_hash = bitcoin_short_hash(input_ops[1].data());
+
+        out = std::equal(key_hash.begin(), key_hash.end(), hash.begin()) ?
+            verify_check_sig(input_ops[0].data(), input_ops[1].data(),
+                prevout_script, tx, input_index, forks) :
+            error::op_equal_verify2;
+        return true;
+    }
+
+    // [endorsement] : [public key] checksig
+    if (is_pay_public_key_pattern(prevout_ops))
+    {
+        if (!is_sign_public_key_pattern(input_ops) ||
+            prevout_script.contains_push(input_ops[0].data()))
+            return false;
+
+        out = verify_check_sig(input_ops[0].data(), prevout_ops[0].data(),
+            prevout_script, tx, input_index, forks);
+        return true;
+    }
+
+    // zero [endorsement]... [m [public key]... n checkmultisig] : p2sh
+    if (prevout_script.is_pay_to_script_hash(forks))
+    {
+        const auto count = input_ops.size();
+
+        if (count < 3 || input_ops.front().code() != opcode::push_size_0)
+            return false;
+
+        const auto& embedded = input_ops.back().data();
+
+        if (embedded.size() > max_push_data_size)
+            return false;
+
+        const auto first = input_ops.begin() + 1;
+        const auto last = input_ops.end() - 1;
+
+        if (!std::all_of(first, last, [](const operation& op)
+            { return is_endorsement(op.data()); }))
+            return false;
+
+        const script embedded_script(embedded, false);
+        const auto& embedded_ops = embedded_script.operations();
+
+        // Surplus endorsements would remain on the stack, so are not handled.
+        if (!is_pay_multisig_pattern(embedded_ops) ||
+            operation::opcode_to_positive(embedded_ops.front().code()) !=
+                count - 2)
+            return false;
+
+        if (std::any_of(first, last, [&](const operation& op)
+            { return embedded_script.contains_push(op.data()); }))
+            return false;
+
+        const auto& hash = prevout_ops[1].data();
+        const auto script_hash = bitcoin_short_hash(embedded);
+
+        out = std::equal(script_hash.begin(), script_hash.end(),
+            hash.begin()) ? verify_check_multisig(input_ops, embedded_ops,
+                embedded_script, tx, input_index, forks) : error::stack_false;
+        return true;
+    }
+
+    return false;
+}
+
+// private/static
+// The result of op_check_sig followed by the stack result test.
+code script::verify_check_sig(const endorsement& endorsement,
+    const data_chunk& public_key, const script_code_view& script_code,
+    const transaction& tx, uint32_t input_index, uint32_t forks)
+{
+    uint8_t sighash;
+    ec_signature signature;
+    der_signature distinguished;
+    const auto bip66 = is_enabled(forks, rule_fork::bip66_rule);
+
+    if (!parse_endorsement(sighash, distinguished, data_chunk(endorsement)))
+        return error::stack_false;
+
+    // BIP62: only lax encoding fails the operation.
+    if (!parse_signature(signature, distinguished, bip66))
+        return bip66 ? error::op_check_sig : error::stack_false;
+
+    return check_signature(signature, sighash, public_key, script_code, tx,
+        input_index) ? error::success : error::stack_false;
+}
+
+// private/static
+// The result of op_check_multisig followed by the stack result test.
+code script::verify_check_multisig(const operation::list& input_ops,
+    const operation::list& embedded_ops, const script_code_view& script_code,
+    const transaction& tx, uint32_t input_index, uint32_t forks)
+{
+    uint8_t sighash;
+    ec_signature signature;
+    der_signature distinguished;
+    const auto bip66 = is_enabled(forks, rule_fork::bip66_rule);
+
+    // Endorsements and keys are popped, so both are matched from the last.
+    auto public_key = embedded_ops.rbegin() + 2;
+    const auto keys_end = embedded_ops.rend() - 1;
+    const auto endorsements_end = input_ops.rend() - 1;
+
+    for (auto it = input_ops.rbegin() + 1; it != endorsements_end; ++it)
+    {
+        if (!parse_endorsement(sighash, distinguished, data_chunk(it->data())))
+            return error::stack_false;
+
+        // BIP62: only lax encoding fails the operation.
+        if (!parse_signature(signature, distinguished, bip66))
+            return bip66 ? error::op_check_multisig : error::stack_false;
+
+        while (!check_signature(signature, sighash, public_key->data(),
+            script_code, tx, input_index))
+            if (++public_key == keys_end)
+                return error::stack_false;
+    }
+
+    return error::success;
+}
+
+code script::verify_program(const transaction& tx, uint32_t input_index,
+    uint32_t forks, const script& input_script, const witness& input_witness,
+    const script& prevout_script, uint64_t value)
+{
+    code ec;
     bool witnessed;
+    ec_verification::list deferred;
 
-    // Evaluate input script.
+    // Evaluate input script, deferring signature verification where allowed.
     program input(input_script, tx, input_index, forks);
+    input.set_deferred(&deferred);
     if ((ec = input.evaluate()))
         return ec;
 
@@ -1428,6 +1476,10 @@ code script::verify(const transaction& tx, uint32_t input_index,
     if (!witnessed && !input_witness.empty())
         return error::unexpected_witness;
 
+    // Deferred checks fail the script as they would have when evaluated.
+    if (!verify_deferred(deferred))
+        return error::incorrect_signature;
+
     return error::success;
 }
 
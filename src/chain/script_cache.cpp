@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/pseudo_random.hpp>
+#include "../math/external/sha256.h"
+
+namespace libbitcoin {
+namespace chain {
+
+script_cache::script_cache(size_t memory, size_t shards)
+  : entries_(memory, shards)
+{
+    pseudo_random::fill(salt_);
+}
+
+// private
+hash_digest script_cache::to_key(const transaction& tx, uint32_t input_index,
+    uint32_t forks) const
+{
+    BITCOIN_ASSERT(input_index < tx.inputs().size());
+    const auto& input = tx.inputs()[input_index];
+    const auto& prevout = input.previous_output().validation.cache;
+
+    // The witness hash commits to the witness as well as the input scripts.
+    const auto hash = tx.hash(true);
+    const auto index = to_little_endian(input_index);
+    const auto rules = to_little_endian(forks);
+    const auto value = to_little_endian(prevout.value());
+    const auto script = prevout.script().to_data(true);
+
+    hash_digest key;
+    SHA256CTX context;
+    SHA256Init(&context);
+    SHA256Update(&context, salt_.data(), salt_.size());
+    SHA256Update(&context, hash.data(), hash.size());
+    SHA256Update(&context, index.data(), index.size());
+    SHA256Update(&context, rules.data(), rules.size());
+    SHA256Update(&context, value.data(), value.size());
+    SHA256Update(&context, script.data(), script.size());
+    SHA256Final(&context, key.data());
+    return key;
+}
+
+bool script_cache::contains(const transaction& tx, uint32_t input_index,
+    uint32_t forks) const
+{
+    return entries_.contains(to_key(tx, input_index, forks));
+}
+
+void script_cache::store(const transaction& tx, uint32_t input_index,
+    uint32_t forks)
+{
+    entries_.store(to_key(tx, input_index, forks));
+}
+
+void script_cache::clear()
+{
+    entries_.clear();
+}
+
+size_t script_cache::capacity() const
+{
+    return entries_.capacity();
+}
+
+size_t script_cache::hits() const
+{
+    return entries_.hits();
+}
+
+size_t script_cache::misses() const
+{
+    return entries_.misses();
+}
+
+} // namespace chain
+} // namespace libbitcoin
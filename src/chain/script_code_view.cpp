@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/script_code_view.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
+#include "view_reader.hpp"
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::machine;
+
+// The largest push prefix, an op code and a four byte size.
+static const size_t max_push_prefix_size = 1 + sizeof(uint32_t);
+
+// The serialized prefix of a non-minimal push of the given size.
+static size_t push_prefix(uint8_t* out, size_t size)
+{
+    const auto code = operation::opcode_from_size(size);
+    out[0] = static_cast<uint8_t>(code);
+
+    switch (code)
+    {
+        case opcode::push_one_size:
+            out[1] = static_cast<uint8_t>(size);
+            return 2;
+        case opcode::push_two_size:
+        {
+            const auto bytes = to_little_endian(static_cast<uint16_t>(size));
+            std::copy(bytes.begin(), bytes.end(), out + 1);
+            return 1 + bytes.size();
+        }
+        case opcode::push_four_size:
+        {
+            const auto bytes = to_little_endian(static_cast<uint32_t>(size));
+            std::copy(bytes.begin(), bytes.end(), out + 1);
+            return 1 + bytes.size();
+        }
+        default:
+            return 1;
+    }
+}
+
+const size_t script_code_view::uncounted = static_cast<size_t>(max_size_t);
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+script_code_view::script_code_view()
+  : begin_(nullptr), end_(nullptr), separators_(0)
+{
+}
+
+script_code_view::script_code_view(const script& script, size_t offset)
+  : begin_(script.bytes_.data() + offset),
+    end_(script.bytes_.data() + script.bytes_.size()),
+    separators_(uncounted)
+{
+    BITCOIN_ASSERT(offset <= script.bytes_.size());
+}
+
+script_code_view::script_code_view(data_slice bytes)
+  : begin_(bytes.begin()), end_(bytes.end()), separators_(uncounted)
+{
+}
+
+// Deletion.
+//-----------------------------------------------------------------------------
+
+//*****************************************************************************
+// CONSENSUS: this is a pointless, broken, premature optimization attempt.
+// The comparison and erase are not limited to a single operation and so can
+// erase arbitrary upstream data from the script.
+//*****************************************************************************
+void script_code_view::find_and_delete(data_slice endorsement)
+{
+    // If this is empty it would produce an empty script but not operation.
+    // So we test it for empty prior to operation reserialization.
+    if (endorsement.empty())
+        return;
+
+    // The value must be serialized to script using non-minimal encoding.
+    // Non-minimally-encoded target values will therefore not match.
+    uint8_t prefix[max_push_prefix_size];
+    const auto prefix_size = push_prefix(prefix, endorsement.size());
+    const auto value_size = prefix_size + endorsement.size();
+
+    const auto matches = [&](const uint8_t* it)
+    {
+        return static_cast<size_t>(end_ - it) >= value_size &&
+            std::equal(prefix, prefix + prefix_size, it) &&
+            std::equal(endorsement.begin(), endorsement.end(),
+                it + prefix_size);
+    };
+
+    std::vector<const uint8_t*> found;
+    view_reader reader(begin_, end_);
+
+    // The exhaustion test handles view end and op deserialization failure.
+    while (reader.is_valid() && reader.remaining() != 0)
+    {
+        // Track all found values for later deletion.
+        for (; matches(reader.position()); reader.skip(value_size))
+            found.push_back(reader.position());
+
+        // Read the next op code following last found value.
+        reader.read_operation();
+    }
+
+    // Copy only when found, which does not happen in standard scripts.
+    if (found.empty())
+        return;
+
+    const auto size = static_cast<size_t>(end_ - begin_);
+    const auto copy = std::make_shared<data_chunk>();
+    copy->reserve(size - found.size() * value_size);
+    auto start = begin_;
+
+    for (const auto value: found)
+    {
+        copy->insert(copy->end(), start, value);
+        start = value + value_size;
+    }
+
+    copy->insert(copy->end(), start, end_);
+    begin_ = copy->data();
+    end_ = copy->data() + copy->size();
+    deleted_ = copy;
+    separators_ = uncounted;
+}
+
+void script_code_view::find_and_delete(const data_stack& endorsements)
+{
+    for (const auto& endorsement: endorsements)
+        find_and_delete(endorsement);
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+data_slice script_code_view::data() const
+{
+    return{ begin_, end_ };
+}
+
+// Counted only when a sighash excludes code separators.
+size_t script_code_view::separators() const
+{
+    if (separators_ != uncounted)
+        return separators_;
+
+    separators_ = 0;
+    view_reader reader(begin_, end_);
+
+    while (reader.is_valid() && reader.remaining() != 0)
+        if (reader.read_operation() == opcode::codeseparator)
+            ++separators_;
+
+    return separators_;
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+data_chunk script_code_view::to_data(bool prefix, bool separators) const
+{
+    data_chunk data(serialized_size(prefix, separators));
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, prefix, separators);
+    return data;
+}
+
+void script_code_view::to_data(writer& sink, bool prefix,
+    bool separators) const
+{
+    if (prefix)
+        sink.write_variable_little_endian(serialized_size(false, separators));
+
+    if (separators || this->separators() == 0)
+    {
+        sink.write_bytes(begin_, end_ - begin_);
+        return;
+    }
+
+    //*************************************************************************
+    // CONSENSUS: code separators are stripped from the unversioned sighash.
+    //*************************************************************************
+    view_reader reader(begin_, end_);
+    auto start = begin_;
+
+    while (reader.is_valid() && reader.remaining() != 0)
+    {
+        const auto op = reader.position();
+
+        if (reader.read_operation() == opcode::codeseparator)
+        {
+            sink.write_bytes(start, op - start);
+            start = reader.position();
+        }
+    }
+
+    sink.write_bytes(start, end_ - start);
+}
+
+size_t script_code_view::serialized_size(bool prefix, bool separators) const
+{
+    auto size = static_cast<size_t>(end_ - begin_);
+
+    // Each code separator is a single byte operation.
+    if (!separators)
+        size -= this->separators();
+
+    if (prefix)
+        size += message::variable_uint_size(size);
+
+    return size;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sighash_context.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/output.hpp>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/script_code_view.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/machine/sighash_algorithm.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/message/messages.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+using namespace bc::machine;
+
+// Serialized outpoint, empty script and sequence of a blanked input.
+static const size_t outpoint_size = 36;
+static const size_t blank_input_size = outpoint_size + 1 + sizeof(uint32_t);
+
+static const size_t blank_script_and_sequence = 1 + sizeof(uint32_t);
+
+sighash_context::sighash_context(const transaction& tx)
+{
+    const auto& ins = tx.inputs();
+    const auto& outs = tx.outputs();
+    header_ = sizeof(uint32_t) + variable_uint_size(ins.size());
+
+    inputs_.reserve(header_ + ins.size() * blank_input_size);
+    data_sink input_stream(inputs_);
+    ostream_writer input_sink(input_stream);
+    input_sink.write_4_bytes_little_endian(tx.version());
+    input_sink.write_variable_little_endian(ins.size());
+
+    for (const auto& input: ins)
+    {
+        input.previous_output().to_data(input_sink);
+        input_sink.write_byte(0);
+        input_sink.write_4_bytes_little_endian(input.sequence());
+    }
+
+    input_stream.flush();
+    BITCOIN_ASSERT(inputs_.size() == header_ + ins.size() * blank_input_size);
+
+    data_sink output_stream(outputs_);
+    ostream_writer output_sink(output_stream);
+    output_sink.write_variable_little_endian(outs.size());
+
+    for (const auto& output: outs)
+        output.to_data(output_sink);
+
+    output_sink.write_4_bytes_little_endian(tx.locktime());
+    output_stream.flush();
+
+    // Capture the hash state at the start of each input.
+    hash_writer sink;
+    sink.write_bytes(inputs_.data(), header_);
+    midstates_.reserve(ins.size());
+
+    for (size_t index = 0; index < ins.size(); ++index)
+    {
+        midstates_.push_back(sink);
+        sink.write_bytes(inputs_.data() + offset(index), blank_input_size);
+    }
+}
+
+size_t sighash_context::offset(uint32_t input_index) const
+{
+    return header_ + input_index * blank_input_size;
+}
+
+hash_digest sighash_context::signature_hash(const transaction& tx,
+    uint32_t input_index, const script_code_view& script_code,
+    uint8_t sighash_type) const
+{
+    // There is no rational interpretation of a signature hash for a coinbase.
+    BITCOIN_ASSERT(!tx.is_coinbase());
+    BITCOIN_ASSERT(input_index < midstates_.size());
+    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
+    const auto algorithm = sighash_type & sighash_algorithm::mask;
+    const auto single = (algorithm == sighash_algorithm::single);
+    const auto none = (algorithm == sighash_algorithm::none);
+    const auto all = !single && !none;
+
+    const auto self = inputs_.data() + offset(input_index);
+    const auto sequence = self + outpoint_size + 1;
+
+    // Resume after the preceding blanked inputs where they are retained.
+    auto sink = all && !any ? midstates_[input_index] : hash_writer{};
+
+    if (any)
+    {
+        // Retain only self.
+        sink.write_4_bytes_little_endian(tx.version());
+        sink.write_variable_little_endian(1);
+        sink.write_bytes(self, outpoint_size);
+        script_code.to_data(sink, true, false);
+        sink.write_bytes(sequence, sizeof(uint32_t));
+    }
+    else if (all)
+    {
+        // Splice in self.
+        sink.write_bytes(self, outpoint_size);
+        script_code.to_data(sink, true, false);
+        sink.write_bytes(sequence, sizeof(uint32_t));
+        sink.write_bytes(sequence + sizeof(uint32_t),
+            inputs_.data() + inputs_.size() - sequence - sizeof(uint32_t));
+    }
+    else
+    {
+        // Erase all other sequences as well as scripts.
+        sink.write_bytes(inputs_.data(), header_);
+
+        for (size_t index = 0; index < midstates_.size(); ++index)
+        {
+            sink.write_bytes(inputs_.data() + offset(index), outpoint_size);
+
+            if (index == input_index)
+            {
+                script_code.to_data(sink, true, false);
+                sink.write_bytes(sequence, sizeof(uint32_t));
+            }
+            else
+            {
+                // Empty script and zero sequence.
+                sink.skip(blank_script_and_sequence);
+            }
+        }
+    }
+
+    if (all)
+    {
+        // Outputs and locktime are retained.
+        sink.write_bytes(outputs_);
+    }
+    else
+    {
+        if (none)
+        {
+            // Drop outputs.
+            sink.write_variable_little_endian(0);
+        }
+        else
+        {
+            // Default outputs up to the output of the input index.
+            BITCOIN_ASSERT(input_index < tx.outputs().size());
+            sink.write_variable_little_endian(input_index + 1);
+            const output null_output{};
+
+            for (size_t index = 0; index < input_index; ++index)
+                null_output.to_data(sink);
+
+            tx.outputs()[input_index].to_data(sink);
+        }
+
+        sink.write_4_bytes_little_endian(tx.locktime());
+    }
+
+    sink.write_4_bytes_little_endian(sighash_type);
+    return sink.bitcoin_hash();
+}
+
+} // namespace chain
+} // namespace libbitcoin
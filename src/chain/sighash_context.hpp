@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_SIGHASH_CONTEXT_HPP
+#define LIBBITCOIN_CHAIN_SIGHASH_CONTEXT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
+#include <bitcoin/bitcoin/utility/noncopyable.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+class script_code_view;
+class transaction;
+
+/**
+ * Unversioned (legacy) signature hashing state for one transaction.
+ * The blanked serialization that every input preimage shares is built once,
+ * with a sha256 midstate captured at each input. An input then hashes only its
+ * own splice and the remainder of the preimage, without copying the
+ * transaction. Results are identical to hashing the modified transaction.
+ */
+class sighash_context
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<const sighash_context> ptr;
+
+    sighash_context(const transaction& tx);
+
+    /// The transaction must be the one this context was built from.
+    /// The caller handles the one_hash cases, code separators are skipped.
+    hash_digest signature_hash(const transaction& tx, uint32_t input_index,
+        const script_code_view& script_code, uint8_t sighash_type) const;
+
+private:
+    size_t offset(uint32_t input_index) const;
+
+    // version, input count, (outpoint, empty script, sequence) per input.
+    data_chunk inputs_;
+    size_t header_;
+
+    // output count, outputs, locktime (the sighash all tail).
+    data_chunk outputs_;
+
+    // Hash state over inputs_ up to the start of each input.
+    std::vector<hash_writer> midstates_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -19,6 +19,7 @@
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -27,11 +28,11 @@
 #include <sstream>
 #include <utility>
 #include <vector>
-#include <boost/optional.hpp>
 #include <bitcoin/bitcoin/chain/chain_state.hpp>
 #include <bitcoin/bitcoin/chain/input.hpp>
 #include <bitcoin/bitcoin/chain/output.hpp>
 #include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/chain/script_cache.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/error.hpp>
 #include <bitcoin/bitcoin/math/hash.hpp>
@@ -44,9 +45,13 @@
 #include <bitcoin/bitcoin/utility/collection.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
 #include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
+#include "sighash_context.hpp"
 
 
 namespace libbitcoin {
@@ -54,73 +59,8 @@ namespace chain {
 
 using namespace bc::machine;
 
-// Read a length-prefixed collection of inputs or outputs from the source.
-template<class Source, class Put>
-bool read(Source& source, std::vector<Put>& puts, bool wire, bool witness)
-{
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#endif
-
-    auto result = true;
-    const auto count = source.read_size_little_endian();
-
-    // Guard against potential for arbitary memory allocation.
-    if (count > get_max_block_size())
-        source.invalidate();
-    else
-        puts.resize(count);
-
-    const auto deserialize = [&](Put& put)
-    {
-        result = result && put.from_data(source, wire, witness);
-#ifndef NDBEUG
-        put.script().operations();
-#endif
-    };
-
-    std::for_each(puts.begin(), puts.end(), deserialize);
-    return result;
-}
-
-// Write a length-prefixed collection of inputs or outputs to the sink.
-template<class Sink, class Put>
-void write(Sink& sink, const std::vector<Put>& puts, bool wire, bool witness)
-{
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#endif
-    sink.write_variable_little_endian(puts.size());
-
-    const auto serialize = [&](const Put& put)
-    {
-        put.to_data(sink, wire, witness);
-    };
-
-    std::for_each(puts.begin(), puts.end(), serialize);
-}
-
-// Input list must be pre-populated as it determines witness count.
-inline void read_witnesses(reader& source, input::list& inputs)
-{
-    const auto deserialize = [&](input& input)
-    {
-        input.witness().from_data(source, true);
-    };
-
-    std::for_each(inputs.begin(), inputs.end(), deserialize);
-}
-
-// Witness count is not written as it is inferred from input count.
-inline void write_witnesses(writer& sink, const input::list& inputs)
-{
-    const auto serialize = [&sink](const input& input)
-    {
-        input.witness().to_data(sink, true);
-    };
-
-    std::for_each(inputs.begin(), inputs.end(), serialize);
-}
+// Optional, installed by the owner of the cache (see set_script_cache).
+static std::atomic<script_cache*> script_cache_(nullptr);
 
 // Constructors.
 //-----------------------------------------------------------------------------
@@ -149,14 +89,14 @@ transaction::transaction(transaction&& other, hash_digest&& hash)
   : transaction(other.version_, other.locktime_, std::move(other.inputs_),
         std::move(other.outputs_), other.cached_sigops_, other.cached_fees_, other.cached_is_standard_)
 {
-    hash_ = std::make_shared<hash_digest>(std::move(hash));
+    hash_.store(std::move(hash));
     validation = std::move(other.validation);
 }
 
 transaction::transaction(const transaction& other, const hash_digest& hash)
   : transaction(other.version_, other.locktime_, other.inputs_, other.outputs_, other.cached_sigops_, other.cached_fees_, other.cached_is_standard_)
 {
-    hash_ = std::make_shared<hash_digest>(hash);
+    hash_.store(hash);
     validation = other.validation;
 }
 
@@ -270,8 +210,8 @@ bool transaction::from_data(const data_chunk& data, bool wire, bool witness, boo
 #ifdef BITPRIM_CURRENCY_BCH
     witness = false;
 #endif
-    data_source istream(data);
-    return from_data(istream, wire, witness, unconfirmed);
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(source, wire, witness, unconfirmed);
 }
 
 bool transaction::from_data(std::istream& stream, bool wire, bool witness, bool unconfirmed)
@@ -282,95 +222,36 @@ bool transaction::from_data(std::istream& stream, bool wire, bool witness, bool
     istream_reader source(stream);
     return from_data(source, wire, witness, unconfirmed);
 }
-// Witness is not used by outputs, just for template normalization.
 bool transaction::from_data(reader& source, bool wire, bool witness, bool unconfirmed)
 {
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#endif
-    reset();
-
-    if (wire)
-    {
-        // Wire (satoshi protocol) deserialization.
-        version_ = source.read_4_bytes_little_endian();
-        read(source, inputs_, wire, witness);
-#ifdef BITPRIM_CURRENCY_BCH
-        const auto marker = false;
-#else
-        // Detect witness as no inputs (marker) and expected flag (bip144).
-        const auto marker = inputs_.size() == witness_marker &&
-            source.peek_byte() == witness_flag;
-#endif
-
-        // This is always enabled so caller should validate with is_segregated.
-        if (marker)
-        {
-            // Skip over the peeked witness flag.
-            source.skip(1);
-            read(source, inputs_, wire, witness);
-            read(source, outputs_, wire, witness);
-            read_witnesses(source, inputs_);
-        }
-        else
-        {
-            read(source, outputs_, wire, witness);
-        }
-
-        locktime_ = source.read_4_bytes_little_endian();
-    }
-    else
-    {
-        // Database (outputs forward) serialization.
-        // Witness data is managed internal to inputs.
-        read(source, outputs_, wire, witness);
-        read(source, inputs_, wire, witness);
-        const auto locktime = source.read_variable_little_endian();
-        const auto version = source.read_variable_little_endian();
-
-        if (locktime > max_uint32 || version > max_uint32)
-            source.invalidate();
-
-        locktime_ = static_cast<uint32_t>(locktime);
-        version_ = static_cast<uint32_t>(version);
-        if(unconfirmed)
-        {
-            const auto sigops = source.read_4_bytes_little_endian();
-            cached_sigops_ = static_cast<uint32_t>(sigops);
-            const auto fees = source.read_8_bytes_little_endian();
-            cached_fees_ = static_cast<uint64_t>(fees);
-            const auto is_standard = source.read_byte();
-            cached_is_standard_ = static_cast<bool>(is_standard);
-        }
-
-    }
-
-    // TODO: optimize by having reader skip witness data.
-    if (!witness)
-        strip_witness();
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, wire, witness, unconfirmed);
 }
 
 // protected
 void transaction::reset()
 {
-    version_ = 0;
-    locktime_ = 0;
     inputs_.clear();
     inputs_.shrink_to_fit();
     outputs_.clear();
     outputs_.shrink_to_fit();
+    recycle();
+}
+
+// protected
+// Inputs and outputs are retained, as deserialization resizes them and then
+// deserializes each in place, reusing the script storage of prior elements.
+void transaction::recycle()
+{
+    version_ = 0;
+    locktime_ = 0;
     invalidate_cache();
     outputs_hash_.reset();
     inpoints_hash_.reset();
     sequences_hash_.reset();
-    segregated_ = boost::none;
-    total_input_value_ = boost::none;
-    total_output_value_ = boost::none;
+    sighash_context_.reset();
+    segregated_.reset();
+    total_input_value_.reset();
+    total_output_value_.reset();
 }
 
 bool transaction::is_valid() const
@@ -398,11 +279,10 @@ data_chunk transaction::to_data(bool wire, bool witness, bool unconfirmed) const
     // Reserve an extra byte to prevent full reallocation in the case of
     // generate_signature_hash extension by addition of the sighash_type.
     data.reserve(size + sizeof(uint8_t));
+    data.resize(size);
 
-    data_sink ostream(data);
-    to_data(ostream, wire, witness, unconfirmed);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, wire, witness, unconfirmed);
     return data;
 }
 
@@ -418,54 +298,9 @@ void transaction::to_data(std::ostream& stream, bool wire, bool witness, bool un
     to_data(sink, wire, witness, unconfirmed);
 }
 
-// Witness is not used by outputs, just for template normalization.
 void transaction::to_data(writer& sink, bool wire, bool witness, bool unconfirmed) const
 {
-#ifdef BITPRIM_CURRENCY_BCH
-    witness = false;
-#endif
-    if (wire)
-    {
-        // Witness handling must be disabled for non-segregated txs.
-        witness &= is_segregated();
-
-        // Wire (satoshi protocol) serialization.
-        sink.write_4_bytes_little_endian(version_);
-
-        if (witness)
-        {
-            sink.write_byte(witness_marker);
-            sink.write_byte(witness_flag);
-            write(sink, inputs_, wire, witness);
-            write(sink, outputs_, wire, witness);
-            write_witnesses(sink, inputs_);
-        }
-        else
-        {
-            write(sink, inputs_, wire, witness);
-            write(sink, outputs_, wire, witness);
-        }
-
-        sink.write_4_bytes_little_endian(locktime_);
-    }
-    else
-    {
-        // Database (outputs forward) serialization.
-        // Witness data is managed internal to inputs.
-        write(sink, outputs_, wire, witness);
-        write(sink, inputs_, wire, witness);
-        sink.write_variable_little_endian(locktime_);
-        sink.write_variable_little_endian(version_);
-        if(unconfirmed)
-        {
-            sink.write_4_bytes_little_endian(signature_operations());
-            sink.write_8_bytes_little_endian(fees());
-            sink.write_byte(is_standard());
-        }
-    }
-
-
-
+    to_data<writer>(sink, wire, witness, unconfirmed);
 }
 
 // Size.
@@ -544,16 +379,18 @@ void transaction::set_inputs(const input::list& value)
     invalidate_cache();
     inpoints_hash_.reset();
     sequences_hash_.reset();
-    segregated_ = boost::none;
-    total_input_value_ = boost::none;
+    sighash_context_.reset();
+    segregated_.reset();
+    total_input_value_.reset();
 }
 
 void transaction::set_inputs(input::list&& value)
 {
     inputs_ = std::move(value);
     invalidate_cache();
-    segregated_ = boost::none;
-    total_input_value_ = boost::none;
+    sighash_context_.reset();
+    segregated_.reset();
+    total_input_value_.reset();
 }
 
 output::list& transaction::outputs()
@@ -571,14 +408,16 @@ void transaction::set_outputs(const output::list& value)
     outputs_ = value;
     invalidate_cache();
     outputs_hash_.reset();
-    total_output_value_ = boost::none;
+    sighash_context_.reset();
+    total_output_value_.reset();
 }
 
 void transaction::set_outputs(output::list&& value)
 {
     outputs_ = std::move(value);
     invalidate_cache();
-    total_output_value_ = boost::none;
+    sighash_context_.reset();
+    total_output_value_.reset();
 }
 
 uint64_t transaction::cached_fees() const
@@ -602,22 +441,16 @@ bool transaction::cached_is_standard() const
 // protected
 void transaction::invalidate_cache() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    hash_mutex_.lock_upgrade();
-
-    if (hash_ || witness_hash_)
-    {
-        hash_mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        hash_.reset();
-        witness_hash_.reset();
-        //---------------------------------------------------------------------
-        hash_mutex_.unlock_and_lock_upgrade();
-    }
+    hash_.reset();
+    witness_hash_.reset();
+}
 
-    hash_mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+// Hash the serialization without buffering it.
+hash_digest transaction::to_hash(bool witness) const
+{
+    hash_writer sink;
+    to_data(sink, true, witness);
+    return sink.bitcoin_hash();
 }
 
 hash_digest transaction::hash(bool witness) const
@@ -628,111 +461,52 @@ hash_digest transaction::hash(bool witness) const
     // Witness hashing must be disabled for non-segregated txs.
     witness &= is_segregated();
 
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    hash_mutex_.lock_upgrade();
-
     if (witness)
     {
-        if (!witness_hash_)
-        {
-            //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-            hash_mutex_.unlock_upgrade_and_lock();
-
-            // Witness coinbase tx hash is assumed to be null_hash (bip141).
-            witness_hash_ = std::make_shared<hash_digest>(
-                is_coinbase() ? null_hash : bitcoin_hash(to_data(true, true)));
-
-            hash_mutex_.unlock_and_lock_upgrade();
-            //-----------------------------------------------------------------
-        }
-    }
-    else
-    {
-        if (!hash_)
+        // Witness coinbase tx hash is assumed to be null_hash (bip141).
+        return witness_hash_.get([this](hash_digest& hash)
         {
-            //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-            hash_mutex_.unlock_upgrade_and_lock();
-            hash_ = std::make_shared<hash_digest>(bitcoin_hash(to_data(true)));
-            hash_mutex_.unlock_and_lock_upgrade();
-            //-----------------------------------------------------------------
-        }
+            hash = is_coinbase() ? null_hash : to_hash(true);
+        });
     }
 
-    const auto hash = witness ? *witness_hash_ : *hash_;
-    hash_mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return hash;
+    return hash_.get([this](hash_digest& hash)
+    {
+        hash = to_hash(false);
+    });
 }
 
 hash_digest transaction::outputs_hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    hash_mutex_.lock_upgrade();
-
-    if (!outputs_hash_)
+    return outputs_hash_.get([this](hash_digest& hash)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        hash_mutex_.unlock_upgrade_and_lock();
-        outputs_hash_ = std::make_shared<hash_digest>(
-            script::to_outputs(*this));
-        hash_mutex_.unlock_and_lock_upgrade();
-        //-----------------------------------------------------------------
-    }
-
-    const auto hash = *outputs_hash_;
-    hash_mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return hash;
+        hash = script::to_outputs(*this);
+    });
 }
 
 hash_digest transaction::inpoints_hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    hash_mutex_.lock_upgrade();
-
-    if (!inpoints_hash_)
+    return inpoints_hash_.get([this](hash_digest& hash)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        hash_mutex_.unlock_upgrade_and_lock();
-        inpoints_hash_ = std::make_shared<hash_digest>(
-            script::to_inpoints(*this));
-        hash_mutex_.unlock_and_lock_upgrade();
-        //-----------------------------------------------------------------
-    }
-
-    const auto hash = *inpoints_hash_;
-    hash_mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return hash;
+        hash = script::to_inpoints(*this);
+    });
 }
 
 hash_digest transaction::sequences_hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    hash_mutex_.lock_upgrade();
-
-    if (!sequences_hash_)
+    return sequences_hash_.get([this](hash_digest& hash)
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        hash_mutex_.unlock_upgrade_and_lock();
-        sequences_hash_ = std::make_shared<hash_digest>(
-            script::to_sequences(*this));
-        hash_mutex_.unlock_and_lock_upgrade();
-        //-----------------------------------------------------------------
-    }
-
-    const auto hash = *sequences_hash_;
-    hash_mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
+        hash = script::to_sequences(*this);
+    });
+}
 
-    return hash;
+// protected
+sighash_context::ptr transaction::unversioned_context() const
+{
+    return sighash_context_.get([this](sighash_context::ptr& context)
+    {
+        context = std::make_shared<sighash_context>(*this);
+    });
 }
 
 // Utilities.
@@ -746,18 +520,13 @@ void transaction::strip_witness()
         input.strip_witness();
     };
 
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    unique_lock lock(mutex_);
-
-    segregated_ = false;
+    segregated_.store(false);
     std::for_each(inputs_.begin(), inputs_.end(), strip);
-    ///////////////////////////////////////////////////////////////////////////
 }
 
 void transaction::recompute_hash()
 {
-    hash_ = nullptr;
+    hash_.reset();
     hash();
 }
 
@@ -839,23 +608,6 @@ bool transaction::is_locktime_conflict() const
 // Returns max_uint64 in case of overflow.
 uint64_t transaction::total_input_value() const
 {
-    uint64_t value;
-
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (total_input_value_ != boost::none)
-    {
-        value = total_input_value_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     ////static_assert(max_money() < max_uint64, "overflow sentinel invalid");
     const auto sum = [](uint64_t total, const input& input)
     {
@@ -866,46 +618,27 @@ uint64_t transaction::total_input_value() const
         return ceiling_add(total, missing ? 0 : prevout.value());
     };
 
-    value = std::accumulate(inputs_.begin(), inputs_.end(), uint64_t(0), sum);
-    total_input_value_ = value;
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return value;
+    return total_input_value_.get([&](uint64_t& value)
+    {
+        value = std::accumulate(inputs_.begin(), inputs_.end(), uint64_t(0),
+            sum);
+    });
 }
 
 // Returns max_uint64 in case of overflow.
 uint64_t transaction::total_output_value() const
 {
-    uint64_t value;
-
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (total_output_value_ != boost::none)
-    {
-        value = total_output_value_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     ////static_assert(max_money() < max_uint64, "overflow sentinel invalid");
     const auto sum = [](uint64_t total, const output& output)
     {
         return ceiling_add(total, output.value());
     };
 
-    value = std::accumulate(outputs_.begin(), outputs_.end(), uint64_t(0), sum);
-    total_output_value_ = value;
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return value;
+    return total_output_value_.get([&](uint64_t& value)
+    {
+        value = std::accumulate(outputs_.begin(), outputs_.end(), uint64_t(0),
+            sum);
+    });
 }
 
 uint64_t transaction::fees() const
@@ -1062,34 +795,16 @@ bool transaction::is_segregated() const
 #ifdef BITPRIM_CURRENCY_BCH
     return false;
 #endif
-    bool value;
-
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (segregated_ != boost::none)
-    {
-        value = segregated_.get();
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        return value;
-    }
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     const auto segregated = [](const input& input)
     {
         return input.is_segregated();
     };
 
     // If no block tx is has witness data the commitment is optional (bip141).
-    value = std::any_of(inputs_.begin(), inputs_.end(), segregated);
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return value;
+    return segregated_.get([&](bool& value)
+    {
+        value = std::any_of(inputs_.begin(), inputs_.end(), segregated);
+    });
 }
 
 // Coinbase transactions return success, to simplify iteration.
@@ -1110,9 +825,25 @@ code transaction::connect_input(const chain_state& state,
 
     const auto forks = state.enabled_forks();
     const auto index32 = static_cast<uint32_t>(input_index);
+    const auto cache = script_cache_.load();
+
+    // A cached input has already passed verification under these forks.
+    if (cache != nullptr && cache->contains(*this, index32, forks))
+        return error::success;
 
     // Verify the transaction input script against the previous output.
-    return script::verify(*this, index32, forks);
+    const auto ec = script::verify(*this, index32, forks);
+
+    if (!ec && cache != nullptr)
+        cache->store(*this, index32, forks);
+
+    return ec;
+}
+
+// static
+void transaction::set_script_cache(script_cache* cache)
+{
+    script_cache_.store(cache);
 }
 
 // Validation.
@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/chain/transaction_view.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/chain/point.hpp>
+#include <bitcoin/bitcoin/chain/transaction.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include "../math/external/sha256.h"
+#include "view_reader.hpp"
+
+namespace libbitcoin {
+namespace chain {
+
+typedef transaction_view::input_view::list input_views;
+typedef transaction_view::output_view::list output_views;
+
+// Minimum serialized sizes, used to bound reservations.
+static const size_t outpoint_size = hash_size + sizeof(uint32_t);
+static const size_t minimum_input_size = outpoint_size + 1 + sizeof(uint32_t);
+static const size_t minimum_output_size = sizeof(uint64_t) + 1;
+
+// The parts of a wire transaction that are not inputs or outputs.
+struct transaction_layout
+{
+    bool segregated;
+    uint32_t version;
+    uint32_t locktime;
+
+    // From the input count through the last output (hashed with version).
+    const uint8_t* body;
+    const uint8_t* body_end;
+};
+
+// Map the transaction at the reader, recording inputs and outputs if given.
+static bool map(view_reader& source, transaction_layout& out,
+    input_views* inputs, output_views* outputs)
+{
+    out.segregated = false;
+    out.version = source.read_4_bytes_little_endian();
+    out.body = source.position();
+    auto input_count = source.read_size_little_endian();
+
+#ifndef BITPRIM_CURRENCY_BCH
+    // Detect witness as no inputs (marker) and expected flag (bip144).
+    if (input_count == witness_marker && source.peek_byte() == witness_flag)
+    {
+        // Skip over the peeked witness flag.
+        source.skip(1);
+        out.segregated = true;
+        out.body = source.position();
+        input_count = source.read_size_little_endian();
+    }
+#endif
+
+    if (inputs != nullptr)
+        inputs->reserve(std::min(input_count,
+            source.remaining() / minimum_input_size));
+
+    for (size_t index = 0; index < input_count && source.is_valid(); ++index)
+    {
+        const auto point = source.skip(outpoint_size);
+        const auto script_size = source.read_size_little_endian();
+        const auto script = source.skip(script_size);
+        const auto sequence = source.read_4_bytes_little_endian();
+
+        if (inputs != nullptr && source.is_valid())
+            inputs->push_back(
+            {
+                { point, point + outpoint_size },
+                { script, script + script_size },
+                sequence,
+                { point, point }
+            });
+    }
+
+    const auto output_count = source.read_size_little_endian();
+
+    if (outputs != nullptr)
+        outputs->reserve(std::min(output_count,
+            source.remaining() / minimum_output_size));
+
+    for (size_t index = 0; index < output_count && source.is_valid(); ++index)
+    {
+        const auto value = source.read_8_bytes_little_endian();
+        const auto script_size = source.read_size_little_endian();
+        const auto script = source.skip(script_size);
+
+        if (outputs != nullptr && source.is_valid())
+            outputs->push_back({ value, { script, script + script_size } });
+    }
+
+    out.body_end = source.position();
+
+    // Witness count is not written as it is inferred from input count.
+    for (size_t index = 0; out.segregated && index < input_count &&
+        source.is_valid(); ++index)
+    {
+        const auto witness = source.position();
+        const auto items = source.read_size_little_endian();
+
+        for (size_t item = 0; item < items && source.is_valid(); ++item)
+            source.skip(source.read_size_little_endian());
+
+        if (inputs != nullptr && source.is_valid())
+            (*inputs)[index].witness = { witness, source.position() };
+    }
+
+    out.locktime = source.read_4_bytes_little_endian();
+    return source.is_valid();
+}
+
+// Input view.
+//-----------------------------------------------------------------------------
+
+hash_digest transaction_view::input_view::previous_output_hash() const
+{
+    hash_digest hash;
+    std::copy_n(previous_output.begin(), hash_size, hash.begin());
+    return hash;
+}
+
+uint32_t transaction_view::input_view::previous_output_index() const
+{
+    return from_little_endian_unsafe<uint32_t>(
+        previous_output.begin() + hash_size);
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+transaction_view::transaction_view(data_slice data)
+  : begin_(data.begin()),
+    end_(data.begin()),
+    body_(data.begin()),
+    body_end_(data.begin()),
+    valid_(false),
+    segregated_(false),
+    version_(0),
+    locktime_(0)
+{
+    transaction_layout layout;
+    view_reader source(data.begin(), data.end());
+
+    if (!map(source, layout, nullptr, nullptr))
+        return;
+
+    end_ = source.position();
+    body_ = layout.body;
+    body_end_ = layout.body_end;
+    valid_ = true;
+    segregated_ = layout.segregated;
+    version_ = layout.version;
+    locktime_ = layout.locktime;
+}
+
+// static
+size_t transaction_view::serialized_size(data_slice data)
+{
+    transaction_layout layout;
+    view_reader source(data.begin(), data.end());
+
+    return map(source, layout, nullptr, nullptr) ?
+        static_cast<size_t>(source.position() - data.begin()) : 0;
+}
+
+// Map inputs and outputs once, the bounds are already known to be valid.
+const transaction_view::puts& transaction_view::map_puts() const
+{
+    return puts_.get([this](puts& out)
+    {
+        out.inputs.clear();
+        out.outputs.clear();
+
+        if (!valid_)
+            return;
+
+        transaction_layout layout;
+        view_reader source(begin_, end_);
+        map(source, layout, &out.inputs, &out.outputs);
+    });
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+bool transaction_view::is_valid() const
+{
+    return valid_;
+}
+
+bool transaction_view::is_segregated() const
+{
+    return segregated_;
+}
+
+data_slice transaction_view::data() const
+{
+    return { begin_, end_ };
+}
+
+size_t transaction_view::serialized_size() const
+{
+    return static_cast<size_t>(end_ - begin_);
+}
+
+uint32_t transaction_view::version() const
+{
+    return version_;
+}
+
+uint32_t transaction_view::locktime() const
+{
+    return locktime_;
+}
+
+const transaction_view::input_view::list& transaction_view::inputs() const
+{
+    return map_puts().inputs;
+}
+
+const transaction_view::output_view::list& transaction_view::outputs() const
+{
+    return map_puts().outputs;
+}
+
+// The witness serialization is skipped by hashing around it.
+hash_digest transaction_view::hash() const
+{
+    if (!segregated_)
+        return bitcoin_hash(data());
+
+    SHA256CTX context;
+    SHA256Init(&context);
+    SHA256Update(&context, begin_, sizeof(uint32_t));
+    SHA256Update(&context, body_, body_end_ - body_);
+    SHA256Update(&context, end_ - sizeof(uint32_t), sizeof(uint32_t));
+
+    hash_digest hash;
+    SHA256Final(&context, hash.data());
+    return sha256_hash(hash);
+}
+
+transaction transaction_view::to_transaction(bool witness) const
+{
+    transaction tx;
+    auto source = make_safe_deserializer(begin_, end_);
+    tx.from_data(source, true, witness);
+    return tx;
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CHAIN_VIEW_READER_HPP
+#define LIBBITCOIN_CHAIN_VIEW_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/define.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/**
+ * Bounds checked cursor over wire bytes, used to map views without copying.
+ * Once a read would overrun the buffer the reader is invalid, and all reads
+ * return zero without advancing.
+ */
+class view_reader
+{
+public:
+    view_reader(const uint8_t* begin, const uint8_t* end)
+      : position_(begin), end_(end), valid_(true)
+    {
+    }
+
+    bool is_valid() const
+    {
+        return valid_;
+    }
+
+    const uint8_t* position() const
+    {
+        return position_;
+    }
+
+    size_t remaining() const
+    {
+        return static_cast<size_t>(end_ - position_);
+    }
+
+    void invalidate()
+    {
+        valid_ = false;
+    }
+
+    /// Returns the start of the skipped bytes (nullptr if invalid).
+    const uint8_t* skip(size_t size)
+    {
+        if (!valid_ || size > remaining())
+        {
+            valid_ = false;
+            return nullptr;
+        }
+
+        const auto start = position_;
+        position_ += size;
+        return start;
+    }
+
+    uint8_t peek_byte() const
+    {
+        return valid_ && remaining() > 0 ? *position_ : 0;
+    }
+
+    uint8_t read_byte()
+    {
+        const auto start = skip(1);
+        return start == nullptr ? 0 : *start;
+    }
+
+    uint16_t read_2_bytes_little_endian()
+    {
+        const auto start = skip(sizeof(uint16_t));
+        return start == nullptr ? 0 : from_little_endian_unsafe<uint16_t>(start);
+    }
+
+    uint32_t read_4_bytes_little_endian()
+    {
+        const auto start = skip(sizeof(uint32_t));
+        return start == nullptr ? 0 : from_little_endian_unsafe<uint32_t>(start);
+    }
+
+    uint64_t read_8_bytes_little_endian()
+    {
+        const auto start = skip(sizeof(uint64_t));
+        return start == nullptr ? 0 : from_little_endian_unsafe<uint64_t>(start);
+    }
+
+    uint64_t read_variable_little_endian()
+    {
+        const auto value = read_byte();
+
+        switch (value)
+        {
+            case varint_eight_bytes:
+                return read_8_bytes_little_endian();
+            case varint_four_bytes:
+                return read_4_bytes_little_endian();
+            case varint_two_bytes:
+                return read_2_bytes_little_endian();
+            default:
+                return value;
+        }
+    }
+
+    /// Read a size that must also fit within the remaining bytes.
+    size_t read_size_little_endian()
+    {
+        const auto size = read_variable_little_endian();
+
+        if (size > remaining())
+        {
+            valid_ = false;
+            return 0;
+        }
+
+        return static_cast<size_t>(size);
+    }
+
+    /// Skip a script operation, returning its op code.
+    machine::opcode read_operation()
+    {
+        typedef machine::opcode opcode;
+        BC_CONSTEXPR auto op_75 = static_cast<uint8_t>(opcode::push_size_75);
+        const auto code = static_cast<opcode>(read_byte());
+
+        switch (code)
+        {
+            case opcode::push_one_size:
+                skip(read_byte());
+                break;
+            case opcode::push_two_size:
+                skip(read_2_bytes_little_endian());
+                break;
+            case opcode::push_four_size:
+                skip(read_4_bytes_little_endian());
+                break;
+            default:
+                const auto byte = static_cast<uint8_t>(code);
+                skip(byte <= op_75 ? byte : 0);
+                break;
+        }
+
+        return code;
+    }
+
+private:
+    const uint8_t* position_;
+    const uint8_t* const end_;
+    bool valid_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
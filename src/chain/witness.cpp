@@ -38,8 +38,11 @@
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 
 namespace libbitcoin {
 namespace chain {
@@ -142,8 +145,8 @@ witness witness::factory_from_data(reader& source, bool prefix)
 
 bool witness::from_data(const data_chunk& encoded, bool prefix)
 {
-    data_source istream(encoded);
-    return from_data(istream, prefix);
+    auto source = make_safe_deserializer(encoded.begin(), encoded.end());
+    return from_data(source, prefix);
 }
 
 bool witness::from_data(std::istream& stream, bool prefix)
@@ -152,47 +155,9 @@ bool witness::from_data(std::istream& stream, bool prefix)
     return from_data(source, prefix);
 }
 
-// Prefixed data assumed valid here though caller may confirm with is_valid.
 bool witness::from_data(reader& source, bool prefix)
 {
-    reset();
-    valid_ = true;
-
-    const auto read_element = [](reader& source)
-    {
-        // Tokens encoded as variable integer prefixed byte array (bip144).
-        const auto size = source.read_size_little_endian();
-
-        // The max_script_size and max_push_data_size constants limit
-        // evaluation, but not all stacks evaluate, so use max_block_weight
-        // to guard memory allocation here.
-        if (size > max_block_weight)
-        {
-            source.invalidate();
-            return data_chunk{};
-        }
-
-        return source.read_bytes(size);
-    };
-
-    // TODO: optimize store serialization to avoid loop, reading data directly.
-    if (prefix)
-    {
-        // Witness prefix is an element count, not byte length (unlike script).
-        // On wire each witness is prefixed with number of elements (bip144).
-        for (auto count = source.read_size_little_endian(); count > 0; --count)
-             stack_.push_back(read_element(source));
-    }
-    else
-    {
-        while (!source.is_exhausted())
-            stack_.push_back(read_element(source));
-    }
-
-    if (!source)
-        reset();
-
-    return source;
+    return from_data<reader>(source, prefix);
 }
 
 // private/static
@@ -227,13 +192,9 @@ bool witness::is_valid() const
 
 data_chunk witness::to_data(bool prefix) const
 {
-    data_chunk data;
-    const auto size = serialized_size(prefix);
-    data.reserve(size);
-    data_sink ostream(data);
-    to_data(ostream, prefix);
-    ostream.flush();
-    BITCOIN_ASSERT(data.size() == size);
+    data_chunk data(serialized_size(prefix));
+    auto sink = make_unsafe_serializer(data.begin());
+    to_data(sink, prefix);
     return data;
 }
 
@@ -245,19 +206,7 @@ void witness::to_data(std::ostream& stream, bool prefix) const
 
 void witness::to_data(writer& sink, bool prefix) const
 {
-    // Witness prefix is an element count, not byte length (unlike script).
-    if (prefix)
-        sink.write_size_little_endian(stack_.size());
-
-    const auto serialize = [&sink](const data_chunk& element)
-    {
-        // Tokens encoded as variable integer prefixed byte array (bip144).
-        sink.write_size_little_endian(element.size());
-        sink.write_bytes(element);
-    };
-
-    // TODO: optimize store serialization to avoid loop, writing data directly.
-    std::for_each(stack_.begin(), stack_.end(), serialize);
+    to_data<writer>(sink, prefix);
 }
 
 std::string witness::to_string() const
@@ -452,8 +401,11 @@ bool witness::extract_embedded_script(script& out_script,
                     return false;
 
                 // SHA256 of the witness script must match program (bip141).
+                hash_writer sink;
+                out_script.to_data(sink, false);
+                const auto script_hash = sink.sha256_hash();
                 return std::equal(program.begin(), program.end(),
-                    sha256_hash(out_script.to_data(false)).begin());
+                    script_hash.begin());
             }
 
             return false;
@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin/chain/script.hpp>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/interpreter.hpp>
+#include <bitcoin/bitcoin/machine/number.hpp>
+#include <bitcoin/bitcoin/machine/opcode.hpp>
+#include <bitcoin/bitcoin/machine/operation.hpp>
+#include <bitcoin/bitcoin/machine/program.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+namespace machine {
+
+typedef bytecode::result result;
+
+const uint32_t bytecode::no_target = max_uint32;
+
+static BC_CONSTEXPR auto push_size_75 =
+    static_cast<uint8_t>(opcode::push_size_75);
+
+// Handlers.
+//-----------------------------------------------------------------------------
+// These adapt the interpreter operations to the instruction handler.
+
+template <result (*Operation)(program&)>
+static result run(program& program, const bytecode&, size_t)
+{
+    return Operation(program);
+}
+
+static result run_nop(program&, const bytecode&, size_t)
+{
+    return error::success;
+}
+
+static result run_disabled(program&, const bytecode&, size_t)
+{
+    return error::op_disabled;
+}
+
+static result run_reserved(program&, const bytecode&, size_t)
+{
+    return error::op_reserved;
+}
+
+// The push data is read from the script bytes, not a per-operation chunk.
+template <size_t Limit, error::error_code_t Error>
+static result run_push(program& program, const bytecode& code, size_t index)
+{
+    const auto& instruction = code[index];
+
+    if (instruction.size > Limit)
+        return Error;
+
+    const auto data = code.data(instruction);
+    program.push_move({ data, data + instruction.size });
+    return error::success;
+}
+
+static result run_push_number(program& program, const bytecode& code,
+    size_t index)
+{
+    const auto op = code[index].code;
+    return interpreter::op_push_number(program, op == opcode::push_negative_1 ?
+        number::negative_1 : operation::opcode_to_positive(op));
+}
+
+static result run_codeseparator(program& program, const bytecode&,
+    size_t index)
+{
+    // The jump register is set from the operation of the same index.
+    return interpreter::op_codeseparator(program, *(program.begin() + index));
+}
+
+static bytecode::handler to_handler(opcode code)
+{
+    if (static_cast<uint8_t>(code) <= push_size_75)
+        return &run_push<push_size_75, error::op_push_size>;
+
+    if (operation::is_positive(code) || code == opcode::push_negative_1)
+        return &run_push_number;
+
+    if (operation::is_disabled(code))
+        return &run_disabled;
+
+    switch (code)
+    {
+        case opcode::push_one_size:
+            return &run_push<max_uint8, error::op_push_data>;
+        case opcode::push_two_size:
+            return &run_push<max_uint16, error::op_push_data>;
+        case opcode::push_four_size:
+            return &run_push<max_uint32, error::op_push_data>;
+        case opcode::nop:
+        case opcode::nop1:
+        case opcode::nop4:
+        case opcode::nop5:
+        case opcode::nop6:
+        case opcode::nop7:
+        case opcode::nop8:
+        case opcode::nop9:
+        case opcode::nop10:
+            return &run_nop;
+        case opcode::if_:
+            return &run<&interpreter::op_if>;
+        case opcode::notif:
+            return &run<&interpreter::op_notif>;
+        case opcode::else_:
+            return &run<&interpreter::op_else>;
+        case opcode::endif:
+            return &run<&interpreter::op_endif>;
+        case opcode::verify:
+            return &run<&interpreter::op_verify>;
+        case opcode::return_:
+            return &run<&interpreter::op_return>;
+        case opcode::toaltstack:
+            return &run<&interpreter::op_to_alt_stack>;
+        case opcode::fromaltstack:
+            return &run<&interpreter::op_from_alt_stack>;
+        case opcode::drop2:
+            return &run<&interpreter::op_drop2>;
+        case opcode::dup2:
+            return &run<&interpreter::op_dup2>;
+        case opcode::dup3:
+            return &run<&interpreter::op_dup3>;
+        case opcode::over2:
+            return &run<&interpreter::op_over2>;
+        case opcode::rot2:
+            return &run<&interpreter::op_rot2>;
+        case opcode::swap2:
+            return &run<&interpreter::op_swap2>;
+        case opcode::ifdup:
+            return &run<&interpreter::op_if_dup>;
+        case opcode::depth:
+            return &run<&interpreter::op_depth>;
+        case opcode::drop:
+            return &run<&interpreter::op_drop>;
+        case opcode::dup:
+            return &run<&interpreter::op_dup>;
+        case opcode::nip:
+            return &run<&interpreter::op_nip>;
+        case opcode::over:
+            return &run<&interpreter::op_over>;
+        case opcode::pick:
+            return &run<&interpreter::op_pick>;
+        case opcode::roll:
+            return &run<&interpreter::op_roll>;
+        case opcode::rot:
+            return &run<&interpreter::op_rot>;
+        case opcode::swap:
+            return &run<&interpreter::op_swap>;
+        case opcode::tuck:
+            return &run<&interpreter::op_tuck>;
+        case opcode::size:
+            return &run<&interpreter::op_size>;
+        case opcode::equal:
+            return &run<&interpreter::op_equal>;
+        case opcode::equalverify:
+            return &run<&interpreter::op_equal_verify>;
+        case opcode::add1:
+            return &run<&interpreter::op_add1>;
+        case opcode::sub1:
+            return &run<&interpreter::op_sub1>;
+        case opcode::negate:
+            return &run<&interpreter::op_negate>;
+        case opcode::abs:
+            return &run<&interpreter::op_abs>;
+        case opcode::not_:
+            return &run<&interpreter::op_not>;
+        case opcode::nonzero:
+            return &run<&interpreter::op_nonzero>;
+        case opcode::add:
+            return &run<&interpreter::op_add>;
+        case opcode::sub:
+            return &run<&interpreter::op_sub>;
+        case opcode::booland:
+            return &run<&interpreter::op_bool_and>;
+        case opcode::boolor:
+            return &run<&interpreter::op_bool_or>;
+        case opcode::numequal:
+            return &run<&interpreter::op_num_equal>;
+        case opcode::numequalverify:
+            return &run<&interpreter::op_num_equal_verify>;
+        case opcode::numnotequal:
+            return &run<&interpreter::op_num_not_equal>;
+        case opcode::lessthan:
+            return &run<&interpreter::op_less_than>;
+        case opcode::greaterthan:
+            return &run<&interpreter::op_greater_than>;
+        case opcode::lessthanorequal:
+            return &run<&interpreter::op_less_than_or_equal>;
+        case opcode::greaterthanorequal:
+            return &run<&interpreter::op_greater_than_or_equal>;
+        case opcode::min:
+            return &run<&interpreter::op_min>;
+        case opcode::max:
+            return &run<&interpreter::op_max>;
+        case opcode::within:
+            return &run<&interpreter::op_within>;
+        case opcode::ripemd160:
+            return &run<&interpreter::op_ripemd160>;
+        case opcode::sha1:
+            return &run<&interpreter::op_sha1>;
+        case opcode::sha256:
+            return &run<&interpreter::op_sha256>;
+        case opcode::hash160:
+            return &run<&interpreter::op_hash160>;
+        case opcode::hash256:
+            return &run<&interpreter::op_hash256>;
+        case opcode::codeseparator:
+            return &run_codeseparator;
+        case opcode::checksig:
+            return &run<&interpreter::op_check_sig>;
+        case opcode::checksigverify:
+            return &run<&interpreter::op_check_sig_verify>;
+        case opcode::checkmultisig:
+            return &run<&interpreter::op_check_multisig>;
+        case opcode::checkmultisigverify:
+            return &run<&interpreter::op_check_multisig_verify>;
+        case opcode::checklocktimeverify:
+            return &run<&interpreter::op_check_locktime_verify>;
+        case opcode::checksequenceverify:
+            return &run<&interpreter::op_check_sequence_verify>;
+        default:
+            return &run_reserved;
+    }
+}
+
+// Constructors.
+//-----------------------------------------------------------------------------
+
+bytecode::bytecode(const chain::script& script)
+  : bytes_(script.to_data(false))
+{
+    const auto& ops = script.operations();
+    std::vector<uint32_t> branches;
+    uint32_t offset = 0;
+    uint32_t counted = 0;
+    uint32_t faulted = 0;
+
+    instructions_.reserve(ops.size());
+
+    for (const auto& op: ops)
+    {
+        const auto index = static_cast<uint32_t>(instructions_.size());
+        const auto end = offset + static_cast<uint32_t>(op.serialized_size());
+        const auto size = static_cast<uint32_t>(op.data().size());
+
+        instruction compiled;
+        compiled.run = to_handler(op.code());
+        compiled.code = op.code();
+        compiled.conditional = op.is_conditional();
+        compiled.fault = op.is_oversized() ? error::invalid_push_data_size :
+            (op.is_disabled() ? error::op_disabled : error::success);
+
+        // A trailing invalid operation has no data (the script is invalid).
+        compiled.offset = end > bytes_.size() ? offset : end - size;
+        compiled.size = end > bytes_.size() ? 0 : size;
+        compiled.target = no_target;
+        compiled.counted = counted;
+        compiled.faulted = faulted;
+        instructions_.push_back(compiled);
+
+        offset = end;
+        counted += operation::is_counted(op.code()) ? 1 : 0;
+        faulted += compiled.fault == error::success ? 0 : 1;
+
+        // Each if/notif/else targets the next else/endif at its own depth.
+        switch (op.code())
+        {
+            case opcode::if_:
+            case opcode::notif:
+                branches.push_back(index);
+                break;
+            case opcode::else_:
+                if (!branches.empty())
+                {
+                    instructions_[branches.back()].target = index;
+                    branches.back() = index;
+                }
+                break;
+            case opcode::endif:
+                if (!branches.empty())
+                {
+                    instructions_[branches.back()].target = index;
+                    branches.pop_back();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+const bytecode::list& bytecode::instructions() const
+{
+    return instructions_;
+}
+
+const bytecode::instruction& bytecode::operator[](size_t index) const
+{
+    BITCOIN_ASSERT(index < instructions_.size());
+    return instructions_[index];
+}
+
+size_t bytecode::size() const
+{
+    return instructions_.size();
+}
+
+const uint8_t* bytecode::data(const instruction& instruction) const
+{
+    return bytes_.data() + instruction.offset;
+}
+
+} // namespace machine
+} // namespace libbitcoin
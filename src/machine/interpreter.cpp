@@ -20,6 +20,7 @@
 
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/machine/bytecode.hpp>
 #include <bitcoin/bitcoin/machine/operation.hpp>
 #include <bitcoin/bitcoin/machine/program.hpp>
 
@@ -57,6 +58,51 @@ code interpreter::run(program& program)
     return program.closed() ? error::success : error::invalid_stack_scope;
 }
 
+code interpreter::run(const bytecode& code, program& program)
+{
+    result ec;
+
+    if (!program.is_valid())
+        return error::invalid_script;
+
+    for (size_t index = 0; index < code.size(); ++index)
+    {
+        const auto& instruction = code[index];
+
+        if (instruction.fault != error::success)
+            return instruction.fault;
+
+        if (!program.increment_operation_count(instruction.code))
+            return error::invalid_operation_count;
+
+        if (instruction.conditional || program.succeeded())
+        {
+            if ((ec = instruction.run(program, code, index)))
+                return ec;
+
+            if (program.is_stack_overflow())
+                return error::invalid_stack_size;
+        }
+
+        // Jump over a branch not taken unless an operation within it faults.
+        if (instruction.target != bytecode::no_target && !program.succeeded())
+        {
+            const auto& first = code[index + 1];
+            const auto& last = code[instruction.target];
+
+            if (first.faulted == last.faulted)
+            {
+                if (!program.skip_operations(last.counted - first.counted))
+                    return error::invalid_operation_count;
+
+                index = instruction.target - 1;
+            }
+        }
+    }
+
+    return program.closed() ? error::success : error::invalid_stack_scope;
+}
+
 code interpreter::run(const operation& op, program& program)
 {
     return run_op(op, program);
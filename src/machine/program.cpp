@@ -18,14 +18,19 @@
  */
 #include <bitcoin/bitcoin/machine/program.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <utility>
+#include <vector>
 #include <bitcoin/bitcoin/chain/script.hpp>
 #include <bitcoin/bitcoin/chain/transaction.hpp>
 #include <bitcoin/bitcoin/constants.hpp>
 #include <bitcoin/bitcoin/machine/interpreter.hpp>
+#include <bitcoin/bitcoin/machine/script_engine.hpp>
 #include <bitcoin/bitcoin/machine/script_version.hpp>
+#include <bitcoin/bitcoin/machine/stack_element.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
 
 namespace libbitcoin {
@@ -33,19 +38,73 @@ namespace machine {
 
 using namespace bc::chain;
 
-// Fixed tuning parameters, max_stack_size ensures no reallocation.
-static constexpr size_t stack_capactity = max_stack_size;
+// Fixed tuning parameters, the stack reservation covers standard scripts.
+static constexpr size_t stack_capactity = 32;
+static constexpr size_t stack_pool_capacity = 128;
 static constexpr size_t condition_capactity = max_counted_ops;
+static constexpr size_t stack_pool_limit = 4;
 static const chain::transaction default_tx_;
 static const chain::script default_script_;
+static std::atomic<script_engine> engine_(script_engine::interpreted);
 
+// Reserved stacks are recycled per thread, since programs are short-lived.
+static std::vector<stack_element::list>& stack_pool()
+{
+    thread_local std::vector<stack_element::list> pool;
+    return pool;
+}
+
+static stack_element::list acquire_stack()
+{
+    auto& pool = stack_pool();
+    stack_element::list stack;
+
+    if (pool.empty())
+    {
+        stack.reserve(stack_capactity);
+        return stack;
+    }
+
+    stack.swap(pool.back());
+    pool.pop_back();
+    return stack;
+}
+
+static void release_stack(stack_element::list& stack)
+{
+    auto& pool = stack_pool();
+
+    // A stack moved to another program no longer has the reservation, and
+    // a stack grown by a large script is released instead of being retained.
+    if (stack.capacity() < stack_capactity ||
+        stack.capacity() > stack_pool_capacity ||
+        pool.size() >= stack_pool_limit)
+        return;
+
+    stack.clear();
+    pool.push_back(std::move(stack));
+}
+
+// Any items already on the primary stack are preserved.
 void program::reserve_stacks()
 {
-    primary_.reserve(stack_capactity);
-    alternate_.reserve(stack_capactity);
+    if (primary_.capacity() < stack_capactity)
+    {
+        auto stack = acquire_stack();
+        std::move(primary_.begin(), primary_.end(), std::back_inserter(stack));
+        primary_.swap(stack);
+    }
+
+    alternate_ = acquire_stack();
     condition_.reserve(condition_capactity);
 }
 
+void program::release_stacks()
+{
+    release_stack(primary_);
+    release_stack(alternate_);
+}
+
 // Constructors.
 //-----------------------------------------------------------------------------
 
@@ -55,10 +114,13 @@ program::program()
     input_index_(0),
     forks_(0),
     value_(0),
+    deferred_(nullptr),
     version_(script_version::unversioned),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin())
+    jump_(script_.begin()),
+    jump_offset_(0),
+    script_code_(script_)
 {
     reserve_stacks();
 }
@@ -69,10 +131,13 @@ program::program(const script& script)
     input_index_(0),
     forks_(0),
     value_(0),
+    deferred_(nullptr),
     version_(script_version::unversioned),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin())
+    jump_(script_.begin()),
+    jump_offset_(0),
+    script_code_(script_)
 {
     reserve_stacks();
 }
@@ -84,10 +149,13 @@ program::program(const script& script, const chain::transaction& transaction,
     input_index_(input_index),
     forks_(forks),
     value_(max_uint64),
+    deferred_(nullptr),
     version_(script_version::unversioned),
     negative_count_(0),
     operation_count_(0),
-    jump_(script_.begin())
+    jump_(script_.begin()),
+    jump_offset_(0),
+    script_code_(script_)
 {
     reserve_stacks();
 }
@@ -101,13 +169,18 @@ program::program(const script& script, const chain::transaction& transaction,
     input_index_(input_index),
     forks_(forks),
     value_(value),
+    deferred_(nullptr),
     version_(version),
     negative_count_(0),
     operation_count_(0),
     jump_(script_.begin()),
-    primary_(std::move(stack))
+    jump_offset_(0),
+    script_code_(script_)
 {
     reserve_stacks();
+
+    for (auto& item: stack)
+        primary_.emplace_back(std::move(item));
 }
 
 
@@ -118,13 +191,16 @@ program::program(const script& script, const program& other)
     input_index_(other.input_index_),
     forks_(other.forks_),
     value_(other.value_),
+    deferred_(other.deferred_),
     version_(script_version::unversioned),
     negative_count_(0),
     operation_count_(0),
     jump_(script_.begin()),
-    primary_(other.primary_)
+    jump_offset_(0),
+    script_code_(script_)
 {
     reserve_stacks();
+    primary_.assign(other.primary_.begin(), other.primary_.end());
 }
 
 // Condition, alternate, jump and operation_count are not moved.
@@ -134,20 +210,43 @@ program::program(const script& script, program&& other, bool)
     input_index_(other.input_index_),
     forks_(other.forks_),
     value_(other.value_),
+    deferred_(other.deferred_),
     version_(script_version::unversioned),
     negative_count_(0),
     operation_count_(0),
     jump_(script_.begin()),
+    jump_offset_(0),
+    script_code_(script_),
     primary_(std::move(other.primary_))
 {
     reserve_stacks();
 }
 
+program::~program()
+{
+    release_stacks();
+}
+
 // Instructions.
 //-----------------------------------------------------------------------------
 
+// static
+void program::set_engine(script_engine engine)
+{
+    engine_.store(engine);
+}
+
+// static
+script_engine program::engine()
+{
+    return engine_.load();
+}
+
 code program::evaluate()
 {
+    if (engine_.load(std::memory_order_relaxed) == script_engine::compiled)
+        return interpreter::run(script_.bytecode(), *this);
+
     return interpreter::run(*this);
 }
 
@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/digest_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+digest_cache::digest_cache(size_t memory, size_t shards)
+  : sets_(std::max(memory / sizeof(hash_digest) / ways /
+        std::max(shards, size_t(1)), size_t(1))),
+    shard_count_(std::max(shards, size_t(1))),
+    shards_(new shard[shard_count_]),
+    hits_(0),
+    misses_(0)
+{
+    for (size_t index = 0; index < shard_count_; ++index)
+        shards_[index].entries.resize(sets_ * ways, null_hash);
+}
+
+// private
+digest_cache::shard& digest_cache::to_shard(const hash_digest& digest) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(digest.begin());
+    return shards_[value % shard_count_];
+}
+
+// private
+size_t digest_cache::to_set(const hash_digest& digest) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(digest.begin() +
+        sizeof(uint64_t));
+    return (value % sets_) * ways;
+}
+
+bool digest_cache::contains(const hash_digest& digest) const
+{
+    const auto& bucket = to_shard(digest);
+    const auto first = bucket.entries.begin() + to_set(digest);
+    const auto last = first + ways;
+    bool found;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        shared_lock lock(bucket.mutex);
+        found = std::find(first, last, digest) != last;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+        ++hits_;
+    else
+        ++misses_;
+
+    return found;
+}
+
+void digest_cache::store(const hash_digest& digest)
+{
+    if (digest == null_hash)
+        return;
+
+    auto& bucket = to_shard(digest);
+    const auto first = bucket.entries.begin() + to_set(digest);
+    const auto last = first + ways;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(bucket.mutex);
+
+    if (std::find(first, last, digest) != last)
+        return;
+
+    // Fill an empty way, otherwise evict one chosen by the digest.
+    auto slot = std::find(first, last, null_hash);
+    if (slot == last)
+        slot = first + (digest[sizeof(uint64_t) * 2] % ways);
+
+    *slot = digest;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void digest_cache::clear()
+{
+    for (size_t index = 0; index < shard_count_; ++index)
+    {
+        auto& bucket = shards_[index];
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        unique_lock lock(bucket.mutex);
+        std::fill(bucket.entries.begin(), bucket.entries.end(), null_hash);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    hits_ = 0;
+    misses_ = 0;
+}
+
+size_t digest_cache::capacity() const
+{
+    return shard_count_ * sets_ * ways;
+}
+
+size_t digest_cache::hits() const
+{
+    return hits_.load();
+}
+
+size_t digest_cache::misses() const
+{
+    return misses_.load();
+}
+
+} // namespace libbitcoin
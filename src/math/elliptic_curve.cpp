@@ -19,13 +19,20 @@
 #include <bitcoin/bitcoin/math/elliptic_curve.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
 #include <utility>
+#include <vector>
 #include <secp256k1.h>
 #include <secp256k1_recovery.h>
 #include <bitcoin/bitcoin/math/hash.hpp>
 #include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/math/public_key_cache.hpp>
 #include <bitcoin/bitcoin/utility/assert.hpp>
 #include <bitcoin/bitcoin/utility/data.hpp>
+#include <bitcoin/bitcoin/utility/dispatcher.hpp>
+#include <bitcoin/bitcoin/utility/synchronizer.hpp>
 #include "../math/external/lax_der_parsing.h"
 #include "secp256k1_initializer.hpp"
 
@@ -323,12 +330,49 @@ bool sign(ec_signature& out, const ec_secret& secret, const hash_digest& hash)
     return true;
 }
 
+static std::atomic<public_key_cache*> public_key_cache_(nullptr);
+
+static_assert(sizeof(secp256k1_pubkey) == sizeof(public_key_cache::parsed_key),
+    "unexpected secp256k1_pubkey size");
+
+void set_public_key_cache(public_key_cache* cache)
+{
+    public_key_cache_.store(cache);
+}
+
+// Parse a potential point, through the public key cache if installed.
+static bool parse_point(const secp256k1_context* context,
+    secp256k1_pubkey& out, data_slice point)
+{
+    public_key_cache::parsed_key parsed;
+    const auto cache = public_key_cache_.load();
+
+    // Copy to avoid exposing external types.
+    if (cache != nullptr && cache->find(parsed, point))
+    {
+        std::copy(parsed.begin(), parsed.end(), std::begin(out.data));
+        return true;
+    }
+
+    if (secp256k1_ec_pubkey_parse(context, &out, point.data(),
+        point.size()) != 1)
+        return false;
+
+    if (cache != nullptr)
+    {
+        std::copy(std::begin(out.data), std::end(out.data), parsed.begin());
+        cache->store(point, parsed);
+    }
+
+    return true;
+}
+
 bool verify_signature(const ec_compressed& point, const hash_digest& hash,
     const ec_signature& signature)
 {
     secp256k1_pubkey pubkey;
     const auto context = verification.context();
-    return parse(context, pubkey, point) &&
+    return parse_point(context, pubkey, point) &&
         verify_signature(context, pubkey, hash, signature);
 }
 
@@ -337,7 +381,7 @@ bool verify_signature(const ec_uncompressed& point, const hash_digest& hash,
 {
     secp256k1_pubkey pubkey;
     const auto context = verification.context();
-    return parse(context, pubkey, point) &&
+    return parse_point(context, pubkey, point) &&
         verify_signature(context, pubkey, hash, signature);
 }
 
@@ -354,15 +398,139 @@ bool verify_signature(data_slice point, const hash_digest& hash,
     const auto context = verification.context();
     secp256k1_ecdsa_signature_normalize(context, &normal, &parsed);
 
-    // This uses a data slice and calls secp256k1_ec_pubkey_parse() in place of
-    // parse() so that we can support the der_verify data_chunk optimization.
+    // This uses a data slice and calls parse_point() in place of parse() so
+    // that we can support the der_verify data_chunk optimization.
     secp256k1_pubkey pubkey;
-    const auto size = point.size();
-    return
-        secp256k1_ec_pubkey_parse(context, &pubkey, point.data(), size) == 1 &&
+    return parse_point(context, pubkey, point) &&
         secp256k1_ecdsa_verify(context, &normal, hash.data(), &pubkey) == 1;
 }
 
+// EC batch verify
+// ----------------------------------------------------------------------------
+
+// A batch item in the form consumed by secp256k1_ecdsa_verify.
+struct parsed_verification
+{
+    bool parsed;
+    secp256k1_pubkey point;
+    secp256k1_ecdsa_signature signature;
+};
+
+typedef std::vector<parsed_verification> parsed_verifications;
+
+static parsed_verifications parse(const secp256k1_context* context,
+    const ec_verification::list& batch)
+{
+    parsed_verifications out(batch.size());
+    secp256k1_ecdsa_signature parsed;
+
+    for (size_t index = 0; index < batch.size(); ++index)
+    {
+        const auto& item = batch[index];
+        auto& to = out[index];
+
+        // Copy to avoid exposing external types, normalize as verify does.
+        std::copy_n(item.signature.begin(), ec_signature_size,
+            std::begin(parsed.data));
+        secp256k1_ecdsa_signature_normalize(context, &to.signature, &parsed);
+
+        to.parsed = parse_point(context, to.point, item.point);
+    }
+
+    return out;
+}
+
+inline bool verify(const secp256k1_context* context,
+    const parsed_verification& item, const hash_digest& hash)
+{
+    return item.parsed && secp256k1_ecdsa_verify(context, &item.signature,
+        hash.data(), &item.point) == 1;
+}
+
+bool verify_signatures(std::vector<bool>& out,
+    const ec_verification::list& batch)
+{
+    const auto context = verification.context();
+    const auto parsed = parse(context, batch);
+    auto valid = true;
+    out.resize(batch.size());
+
+    for (size_t index = 0; index < batch.size(); ++index)
+        valid &= (out[index] = verify(context, parsed[index],
+            batch[index].hash));
+
+    return valid;
+}
+
+size_t verify_signatures(const ec_verification::list& batch)
+{
+    const auto context = verification.context();
+    const auto parsed = parse(context, batch);
+
+    for (size_t index = 0; index < batch.size(); ++index)
+        if (!verify(context, parsed[index], batch[index].hash))
+            return index;
+
+    return batch.size();
+}
+
+// Items are strided across buckets, each bucket stops at its first failure
+// or once a lower index has failed, so the lowest failure is always found.
+size_t verify_signatures(const ec_verification::list& batch,
+    dispatcher& dispatch)
+{
+    // The calling thread verifies one bucket, the pool verifies the others.
+    const auto buckets = dispatch.size();
+
+    if (buckets < 2 || batch.size() < 2)
+        return verify_signatures(batch);
+
+    const auto context = verification.context();
+    const auto parsed = parse(context, batch);
+    std::atomic<size_t> first_failure(batch.size());
+
+    const auto verify_bucket = [&](size_t bucket)
+    {
+        for (auto index = bucket; index < batch.size(); index += buckets)
+        {
+            if (index > first_failure.load())
+                return;
+
+            if (verify(context, parsed[index], batch[index].hash))
+                continue;
+
+            auto current = first_failure.load();
+            while (index < current &&
+                !first_failure.compare_exchange_weak(current, index));
+
+            return;
+        }
+    };
+
+    const auto complete = std::make_shared<std::promise<void>>();
+    auto finished = complete->get_future();
+    const auto handler = [complete](const code&)
+    {
+        complete->set_value();
+    };
+
+    auto join = synchronize(handler, buckets - 1, "verify",
+        synchronizer_terminate::on_count);
+
+    for (size_t bucket = 1; bucket < buckets; ++bucket)
+    {
+        dispatch.concurrent([&verify_bucket, bucket, join]() mutable
+        {
+            verify_bucket(bucket);
+            join(error::success);
+        });
+    }
+
+    verify_bucket(0);
+    finished.wait();
+    return first_failure.load();
+}
+
 // Recoverable sign/recover
 // ----------------------------------------------------------------------------
 
@@ -27,6 +27,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "sha256_x86.h"
 #include "zeroize.h"
 
 static uint32_t be32dec(const void* pp)
@@ -95,9 +96,79 @@ static unsigned char PAD[SHA256_BLOCK_LENGTH] =
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
+typedef void (*SHA256TransformBlocks)(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count);
+typedef size_t (*SHA256DLanes)(uint8_t* out, const uint8_t* in, size_t size,
+    size_t count);
+
 void SHA256Pad(SHA256CTX* context);
 void SHA256Transform(uint32_t state[SHA256_STATE_LENGTH],
     const uint8_t block[SHA256_BLOCK_LENGTH]);
+static void SHA256TransformScalar(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count);
+
+/* A selected implementation, never modified once defined. */
+typedef struct SHA256Selection
+{
+    SHA256TransformBlocks transform;
+    SHA256DLanes lanes;
+    int implementation;
+} SHA256Selection;
+
+static const SHA256Selection scalar_selection =
+    { SHA256TransformScalar, NULL, SHA256_TRANSFORM_SCALAR };
+
+#ifdef SHA256_WITH_X86
+static const SHA256Selection shani_selection =
+    { SHA256TransformSHANI, NULL, SHA256_TRANSFORM_SHANI };
+static const SHA256Selection sse41_selection =
+    { SHA256TransformScalar, SHA256DSSE41, SHA256_TRANSFORM_SSE41 };
+static const SHA256Selection avx2_selection =
+    { SHA256TransformScalar, SHA256DAVX2, SHA256_TRANSFORM_AVX2 };
+
+/* Automatic selections, indexed by [shani][none, sse41, avx2 lanes]. */
+static const SHA256Selection automatic_selections[2][3] =
+{
+    {
+        { SHA256TransformScalar, NULL, SHA256_TRANSFORM_AUTOMATIC },
+        { SHA256TransformScalar, SHA256DSSE41, SHA256_TRANSFORM_AUTOMATIC },
+        { SHA256TransformScalar, SHA256DAVX2, SHA256_TRANSFORM_AUTOMATIC }
+    },
+    {
+        { SHA256TransformSHANI, NULL, SHA256_TRANSFORM_AUTOMATIC },
+        { SHA256TransformSHANI, SHA256DSSE41, SHA256_TRANSFORM_AUTOMATIC },
+        { SHA256TransformSHANI, SHA256DAVX2, SHA256_TRANSFORM_AUTOMATIC }
+    }
+};
+#else
+static const SHA256Selection automatic_selection =
+    { SHA256TransformScalar, NULL, SHA256_TRANSFORM_AUTOMATIC };
+#endif
+
+/* The current selection, null until first used or selected. Only the pointer
+ * changes, so hashing threads always see a consistent selection. */
+static const SHA256Selection* volatile current = NULL;
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SELECTION_LOAD() ((const SHA256Selection*) \
+    _InterlockedCompareExchangePointer((void* volatile*)&current, NULL, NULL))
+#define SELECTION_STORE(value) \
+    _InterlockedExchangePointer((void* volatile*)&current, (void*)(value))
+#define SELECTION_STORE_IF_NULL(value) \
+    _InterlockedCompareExchangePointer((void* volatile*)&current, \
+        (void*)(value), NULL)
+#else
+#define SELECTION_LOAD() __atomic_load_n(&current, __ATOMIC_ACQUIRE)
+#define SELECTION_STORE(value) \
+    __atomic_store_n(&current, (value), __ATOMIC_RELEASE)
+#define SELECTION_STORE_IF_NULL(value) \
+    do { const SHA256Selection* expected = NULL; \
+    __atomic_compare_exchange_n(&current, &expected, (value), 0, \
+        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); } while (0)
+#endif
+
+static const SHA256Selection* SHA256Selected(void);
 
 void SHA256_(const uint8_t* input, size_t length,
     uint8_t digest[SHA256_DIGEST_LENGTH])
@@ -124,6 +195,7 @@ void SHA256Init(SHA256CTX* context)
 
 void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length)
 {
+    SHA256TransformBlocks transform;
     uint32_t bitlen[2];
     uint32_t r = (context->count[1] >> 3) & 0x3f;
 
@@ -143,17 +215,18 @@ void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length)
         return;
     }
 
+    transform = SHA256Selected()->transform;
     memcpy(&context->buf[r], input, 64 - r);
-    SHA256Transform(context->state, context->buf);
+    transform(context->state, context->buf, 1);
 
     input += 64 - r;
     length -= 64 - r;
 
-    while (length >= 64)
+    if (length >= 64)
     {
-        SHA256Transform(context->state, input);
-        input += 64;
-        length -= 64;
+        transform(context->state, input, length / 64);
+        input += length & ~(size_t)63;
+        length &= 63;
     }
 
     memcpy(context->buf, input, length);
@@ -166,8 +239,119 @@ void SHA256Final(SHA256CTX* context, uint8_t digest[SHA256_DIGEST_LENGTH])
     zeroize((void*)context, sizeof *context);
 }
 
+void SHA256D(uint8_t* out, const uint8_t* in, size_t size, size_t count)
+{
+    SHA256CTX context;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    size_t index = 0;
+    const SHA256DLanes lanes = SHA256Selected()->lanes;
+
+    if (lanes != NULL)
+        index = lanes(out, in, size, count);
+
+    for (; index < count; ++index)
+    {
+        SHA256Init(&context);
+        SHA256Update(&context, in + index * size, size);
+        SHA256Final(&context, digest);
+        SHA256Init(&context);
+        SHA256Update(&context, digest, sizeof digest);
+        SHA256Final(&context, out + index * SHA256_DIGEST_LENGTH);
+    }
+
+    zeroize((void*)digest, sizeof digest);
+}
+
+int SHA256TransformSupported(int implementation)
+{
+    switch (implementation)
+    {
+        case SHA256_TRANSFORM_AUTOMATIC:
+        case SHA256_TRANSFORM_SCALAR:
+            return 1;
+#ifdef SHA256_WITH_X86
+        case SHA256_TRANSFORM_SHANI:
+            return SHA256SHANISupported();
+        case SHA256_TRANSFORM_SSE41:
+            return SHA256SSE41Supported();
+        case SHA256_TRANSFORM_AVX2:
+            return SHA256AVX2Supported();
+#endif
+        default:
+            return 0;
+    }
+}
+
+static const SHA256Selection* SHA256Automatic(void)
+{
+#ifdef SHA256_WITH_X86
+    const int lanes = SHA256AVX2Supported() ? 2 :
+        (SHA256SSE41Supported() ? 1 : 0);
+
+    return &automatic_selections[SHA256SHANISupported() ? 1 : 0][lanes];
+#else
+    return &automatic_selection;
+#endif
+}
+
+int SHA256TransformSelect(int implementation)
+{
+    const SHA256Selection* selection = &scalar_selection;
+
+    if (!SHA256TransformSupported(implementation))
+        return 0;
+
+    switch (implementation)
+    {
+        case SHA256_TRANSFORM_AUTOMATIC:
+            selection = SHA256Automatic();
+            break;
+#ifdef SHA256_WITH_X86
+        case SHA256_TRANSFORM_SHANI:
+            selection = &shani_selection;
+            break;
+        case SHA256_TRANSFORM_SSE41:
+            selection = &sse41_selection;
+            break;
+        case SHA256_TRANSFORM_AVX2:
+            selection = &avx2_selection;
+            break;
+#endif
+        default:
+            break;
+    }
+
+    SELECTION_STORE(selection);
+    return 1;
+}
+
+int SHA256TransformSelected(void)
+{
+    return SHA256Selected()->implementation;
+}
+
 /* Local */
 
+/* Racing first uses detect the same selection, and do not replace an
+ * explicit selection made in the meantime. */
+static const SHA256Selection* SHA256Selected(void)
+{
+    const SHA256Selection* selection = SELECTION_LOAD();
+
+    if (selection != NULL)
+        return selection;
+
+    SELECTION_STORE_IF_NULL(SHA256Automatic());
+    return SELECTION_LOAD();
+}
+
+static void SHA256TransformScalar(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count)
+{
+    for (; count > 0; --count, blocks += SHA256_BLOCK_LENGTH)
+        SHA256Transform(state, blocks);
+}
+
 void SHA256Pad(SHA256CTX* context)
 {
     uint8_t len[8];
@@ -53,6 +53,26 @@ void SHA256Init(SHA256CTX* context);
 void SHA256Update(SHA256CTX* context, const uint8_t* input, size_t length);
 void SHA256Final(SHA256CTX* context, uint8_t digest[SHA256_DIGEST_LENGTH]);
 
+/* Double hash count consecutive inputs of size bytes into count digests,
+ * using vector lanes where selected. Out may alias in if size is at least
+ * SHA256_DIGEST_LENGTH. */
+void SHA256D(uint8_t* out, const uint8_t* in, size_t size, size_t count);
+
+/* Compression function implementations. Automatic (the default) combines
+ * the fastest supported single stream and vector lane implementations, the
+ * others force one (for testing). Selection is atomic, each update or batch
+ * uses the implementation selected when it starts.
+ * The vector lane implementations apply only to SHA256D batches. */
+#define SHA256_TRANSFORM_AUTOMATIC 0
+#define SHA256_TRANSFORM_SCALAR 1
+#define SHA256_TRANSFORM_SHANI 2
+#define SHA256_TRANSFORM_SSE41 3
+#define SHA256_TRANSFORM_AVX2 4
+
+int SHA256TransformSupported(int implementation);
+int SHA256TransformSelect(int implementation);
+int SHA256TransformSelected(void);
+
 #ifdef __cplusplus
 }
 #endif
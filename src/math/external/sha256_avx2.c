@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_x86.h"
+
+#ifdef SHA256_WITH_X86
+
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define LANES_TARGET
+#else
+#define LANES_TARGET __attribute__((target("avx2")))
+#endif
+
+#define LANES 8
+#define VEC __m256i
+#define V_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define V_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define V_SET1(x) _mm256_set1_epi32((int)(x))
+#define V_ADD(a, b) _mm256_add_epi32(a, b)
+#define V_XOR(a, b) _mm256_xor_si256(a, b)
+#define V_AND(a, b) _mm256_and_si256(a, b)
+#define V_OR(a, b) _mm256_or_si256(a, b)
+#define V_SHR(x, n) _mm256_srli_epi32(x, n)
+#define V_SHL(x, n) _mm256_slli_epi32(x, n)
+#define LANES_FUNCTION SHA256DAVX2
+
+#include "sha256_lanes.h"
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/* Multi-lane double sha256 of fixed size inputs, shared by the vector
+ * implementations. The including file defines the vector type and operations:
+ * LANES, VEC, V_LOAD, V_STORE, V_SET1, V_ADD, V_XOR, V_AND, V_OR, V_SHR, V_SHL,
+ * along with LANES_TARGET and the LANES_FUNCTION name to define. */
+#ifndef LIBBITCOIN_SHA256_LANES_H
+#define LIBBITCOIN_SHA256_LANES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "sha256.h"
+
+static const uint32_t lanes_iv[SHA256_STATE_LENGTH] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t lanes_k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define L_ROTR(x, n) V_OR(V_SHR(x, n), V_SHL(x, 32 - n))
+#define L_S0(x) V_XOR(V_XOR(L_ROTR(x, 2), L_ROTR(x, 13)), L_ROTR(x, 22))
+#define L_S1(x) V_XOR(V_XOR(L_ROTR(x, 6), L_ROTR(x, 11)), L_ROTR(x, 25))
+#define L_s0(x) V_XOR(V_XOR(L_ROTR(x, 7), L_ROTR(x, 18)), V_SHR(x, 3))
+#define L_s1(x) V_XOR(V_XOR(L_ROTR(x, 17), L_ROTR(x, 19)), V_SHR(x, 10))
+#define L_Ch(x, y, z) V_XOR(V_AND(x, V_XOR(y, z)), z)
+#define L_Maj(x, y, z) V_OR(V_AND(x, V_OR(y, z)), V_AND(y, z))
+
+static uint32_t lanes_be32dec(const uint8_t* p)
+{
+    return ((uint32_t)(p[3]) + ((uint32_t)(p[2]) << 8) +
+        ((uint32_t)(p[1]) << 16) + ((uint32_t)(p[0]) << 24));
+}
+
+static void lanes_be32enc(uint8_t* p, uint32_t x)
+{
+    p[3] = x & 0xff;
+    p[2] = (x >> 8) & 0xff;
+    p[1] = (x >> 16) & 0xff;
+    p[0] = (x >> 24) & 0xff;
+}
+
+/* Compress one block per lane, the message words are consumed. */
+static LANES_TARGET void lanes_transform(VEC state[SHA256_STATE_LENGTH],
+    VEC w[16])
+{
+    VEC a = state[0], b = state[1], c = state[2], d = state[3];
+    VEC e = state[4], f = state[5], g = state[6], h = state[7];
+    VEC t0, t1;
+    size_t i;
+
+    for (i = 0; i < 64; ++i)
+    {
+        if (i >= 16)
+            w[i & 15] = V_ADD(V_ADD(L_s1(w[(i - 2) & 15]), w[(i - 7) & 15]),
+                V_ADD(L_s0(w[(i - 15) & 15]), w[i & 15]));
+
+        t0 = V_ADD(V_ADD(h, L_S1(e)), V_ADD(L_Ch(e, f, g),
+            V_ADD(V_SET1(lanes_k[i]), w[i & 15])));
+        t1 = V_ADD(L_S0(a), L_Maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = V_ADD(d, t0);
+        d = c;
+        c = b;
+        b = a;
+        a = V_ADD(t0, t1);
+    }
+
+    state[0] = V_ADD(state[0], a);
+    state[1] = V_ADD(state[1], b);
+    state[2] = V_ADD(state[2], c);
+    state[3] = V_ADD(state[3], d);
+    state[4] = V_ADD(state[4], e);
+    state[5] = V_ADD(state[5], f);
+    state[6] = V_ADD(state[6], g);
+    state[7] = V_ADD(state[7], h);
+}
+
+/* Load the block at offset of each lane's buffer as message words. */
+static LANES_TARGET void lanes_load(VEC w[16], const uint8_t* base,
+    size_t stride, size_t offset)
+{
+    uint32_t words[LANES];
+    size_t lane;
+    size_t i;
+
+    for (i = 0; i < 16; ++i)
+    {
+        for (lane = 0; lane < LANES; ++lane)
+            words[lane] = lanes_be32dec(base + lane * stride + offset + 4 * i);
+
+        w[i] = V_LOAD(words);
+    }
+}
+
+static LANES_TARGET void lanes_initialize(VEC state[SHA256_STATE_LENGTH])
+{
+    size_t i;
+    for (i = 0; i < SHA256_STATE_LENGTH; ++i)
+        state[i] = V_SET1(lanes_iv[i]);
+}
+
+/* Each lane's output is written after all inputs of the batch are consumed,
+ * so out may alias in provided size is at least the digest length. */
+LANES_TARGET size_t LANES_FUNCTION(uint8_t* out, const uint8_t* in,
+    size_t size, size_t count)
+{
+    const size_t batches = count / LANES;
+    const size_t full = size / SHA256_BLOCK_LENGTH;
+    const size_t rest = size % SHA256_BLOCK_LENGTH;
+    const size_t tails = rest + 9 > SHA256_BLOCK_LENGTH ? 2 : 1;
+    const uint64_t bits = (uint64_t)size * 8;
+    uint8_t tail[LANES][2 * SHA256_BLOCK_LENGTH];
+    uint32_t words[LANES];
+    VEC state[SHA256_STATE_LENGTH];
+    VEC w[16];
+    size_t batch, block, lane;
+    uint8_t* length;
+    size_t i;
+
+    for (batch = 0; batch < batches; ++batch, in += LANES * size)
+    {
+        lanes_initialize(state);
+
+        for (block = 0; block < full; ++block)
+        {
+            lanes_load(w, in, size, block * SHA256_BLOCK_LENGTH);
+            lanes_transform(state, w);
+        }
+
+        /* The unaligned remainder of each input with its padding. */
+        for (lane = 0; lane < LANES; ++lane)
+        {
+            memset(tail[lane], 0, sizeof tail[lane]);
+            memcpy(tail[lane], in + lane * size + full * SHA256_BLOCK_LENGTH,
+                rest);
+            tail[lane][rest] = 0x80;
+            length = tail[lane] + tails * SHA256_BLOCK_LENGTH - 8;
+            lanes_be32enc(length, (uint32_t)(bits >> 32));
+            lanes_be32enc(length + 4, (uint32_t)bits);
+        }
+
+        for (block = 0; block < tails; ++block)
+        {
+            lanes_load(w, tail[0], sizeof tail[0], block * SHA256_BLOCK_LENGTH);
+            lanes_transform(state, w);
+        }
+
+        /* The second hash of the 32 byte digest is a single padded block. */
+        for (i = 0; i < SHA256_STATE_LENGTH; ++i)
+            w[i] = state[i];
+
+        w[8] = V_SET1(0x80000000);
+        for (i = 9; i < 15; ++i)
+            w[i] = V_SET1(0);
+
+        w[15] = V_SET1(SHA256_DIGEST_LENGTH * 8);
+        lanes_initialize(state);
+        lanes_transform(state, w);
+
+        for (i = 0; i < SHA256_STATE_LENGTH; ++i)
+        {
+            V_STORE(words, state[i]);
+            for (lane = 0; lane < LANES; ++lane)
+                lanes_be32enc(out + (batch * LANES + lane) *
+                    SHA256_DIGEST_LENGTH + 4 * i, words[lane]);
+        }
+    }
+
+    return batches * LANES;
+}
+
+#undef L_ROTR
+#undef L_S0
+#undef L_S1
+#undef L_s0
+#undef L_s1
+#undef L_Ch
+#undef L_Maj
+
+#endif
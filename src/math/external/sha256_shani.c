@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_x86.h"
+
+#ifdef SHA256_WITH_X86
+
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define SHANI_TARGET
+#else
+#define SHANI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#endif
+
+static const uint32_t K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* Four rounds over the scheduled message words in MSG_. */
+#define ROUNDS(MSG_, i) \
+    msg = _mm_add_epi32(MSG_, _mm_loadu_si128((const __m128i*)&K[4 * i])); \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+    msg = _mm_shuffle_epi32(msg, 0x0e); \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg)
+
+/* Complete the schedule of NEXT_ from CURRENT_ and PRIOR_. */
+#define SCHEDULE(NEXT_, CURRENT_, PRIOR_) \
+    NEXT_ = _mm_add_epi32(NEXT_, _mm_alignr_epi8(CURRENT_, PRIOR_, 4)); \
+    NEXT_ = _mm_sha256msg2_epu32(NEXT_, CURRENT_)
+
+#define LOAD(MSG_, offset) \
+    MSG_ = _mm_shuffle_epi8(_mm_loadu_si128( \
+        (const __m128i*)(blocks + offset)), mask)
+
+SHANI_TARGET void SHA256TransformSHANI(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count)
+{
+    __m128i state0, state1, msg, tmp, msg0, msg1, msg2, msg3;
+    __m128i abef, cdgh;
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+        0x0405060700010203ull);
+
+    /* Reorder the state words into the ABEF/CDGH layout of sha256rnds2. */
+    tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+    state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xb1);
+    state1 = _mm_shuffle_epi32(state1, 0x1b);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; count > 0; --count, blocks += SHA256_BLOCK_LENGTH)
+    {
+        abef = state0;
+        cdgh = state1;
+
+        LOAD(msg0, 0);
+        ROUNDS(msg0, 0);
+
+        LOAD(msg1, 16);
+        ROUNDS(msg1, 1);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        LOAD(msg2, 32);
+        ROUNDS(msg2, 2);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        LOAD(msg3, 48);
+        ROUNDS(msg3, 3);
+        SCHEDULE(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        ROUNDS(msg0, 4);
+        SCHEDULE(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        ROUNDS(msg1, 5);
+        SCHEDULE(msg2, msg1, msg0);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        ROUNDS(msg2, 6);
+        SCHEDULE(msg3, msg2, msg1);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        ROUNDS(msg3, 7);
+        SCHEDULE(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        ROUNDS(msg0, 8);
+        SCHEDULE(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        ROUNDS(msg1, 9);
+        SCHEDULE(msg2, msg1, msg0);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        ROUNDS(msg2, 10);
+        SCHEDULE(msg3, msg2, msg1);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        ROUNDS(msg3, 11);
+        SCHEDULE(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        ROUNDS(msg0, 12);
+        SCHEDULE(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        ROUNDS(msg1, 13);
+        SCHEDULE(msg2, msg1, msg0);
+
+        ROUNDS(msg2, 14);
+        SCHEDULE(msg3, msg2, msg1);
+
+        ROUNDS(msg3, 15);
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    /* Restore the state words to ABCD/EFGH order. */
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+#undef ROUNDS
+#undef SCHEDULE
+#undef LOAD
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_x86.h"
+
+#ifdef SHA256_WITH_X86
+
+#include <stdint.h>
+#include <stddef.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define LANES_TARGET
+#else
+#define LANES_TARGET __attribute__((target("sse4.1")))
+#endif
+
+#define LANES 4
+#define VEC __m128i
+#define V_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define V_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define V_SET1(x) _mm_set1_epi32((int)(x))
+#define V_ADD(a, b) _mm_add_epi32(a, b)
+#define V_XOR(a, b) _mm_xor_si128(a, b)
+#define V_AND(a, b) _mm_and_si128(a, b)
+#define V_OR(a, b) _mm_or_si128(a, b)
+#define V_SHR(x, n) _mm_srli_epi32(x, n)
+#define V_SHL(x, n) _mm_slli_epi32(x, n)
+#define LANES_FUNCTION SHA256DSSE41
+
+#include "sha256_lanes.h"
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_x86.h"
+
+#ifdef SHA256_WITH_X86
+
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+static void cpuid(uint32_t leaf, uint32_t sub, uint32_t* a, uint32_t* b,
+    uint32_t* c, uint32_t* d)
+{
+#ifdef _MSC_VER
+    int registers[4];
+    __cpuidex(registers, (int)leaf, (int)sub);
+    *a = (uint32_t)registers[0];
+    *b = (uint32_t)registers[1];
+    *c = (uint32_t)registers[2];
+    *d = (uint32_t)registers[3];
+#else
+    __cpuid_count(leaf, sub, *a, *b, *c, *d);
+#endif
+}
+
+/* The extended control register, only valid if OSXSAVE is set. */
+static uint64_t xgetbv(void)
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t low, high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((uint64_t)high << 32) | low;
+#endif
+}
+
+static uint32_t max_leaf(void)
+{
+    uint32_t a, b, c, d;
+    cpuid(0, 0, &a, &b, &c, &d);
+    return a;
+}
+
+int SHA256SSE41Supported(void)
+{
+    uint32_t a, b, c, d;
+
+    if (max_leaf() < 1)
+        return 0;
+
+    /* Leaf 1: ECX bit 19 is SSE4.1. */
+    cpuid(1, 0, &a, &b, &c, &d);
+    return (c & (1u << 19)) != 0;
+}
+
+int SHA256SHANISupported(void)
+{
+    uint32_t a, b, c, d;
+
+    if (max_leaf() < 7)
+        return 0;
+
+    /* Leaf 1: ECX bit 9 is SSSE3, bit 19 is SSE4.1. */
+    cpuid(1, 0, &a, &b, &c, &d);
+    if ((c & (1u << 9)) == 0 || (c & (1u << 19)) == 0)
+        return 0;
+
+    /* Leaf 7: EBX bit 29 is SHA. */
+    cpuid(7, 0, &a, &b, &c, &d);
+    return (b & (1u << 29)) != 0;
+}
+
+int SHA256AVX2Supported(void)
+{
+    uint32_t a, b, c, d;
+
+    if (max_leaf() < 7)
+        return 0;
+
+    /* Leaf 1: ECX bit 27 is OSXSAVE, bit 28 is AVX. */
+    cpuid(1, 0, &a, &b, &c, &d);
+    if ((c & (1u << 27)) == 0 || (c & (1u << 28)) == 0)
+        return 0;
+
+    /* The operating system must preserve the XMM and YMM registers. */
+    if ((xgetbv() & 6) != 6)
+        return 0;
+
+    /* Leaf 7: EBX bit 5 is AVX2. */
+    cpuid(7, 0, &a, &b, &c, &d);
+    return (b & (1u << 5)) != 0;
+}
+
+#endif
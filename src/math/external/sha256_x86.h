@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_SHA256_X86_H
+#define LIBBITCOIN_SHA256_X86_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sha256.h"
+
+/* The x86 extensions are compiled in where the compiler can target them,
+ * their use is decided at run time from CPUID. */
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)) && (defined(__GNUC__) || defined(_MSC_VER))
+#define SHA256_WITH_X86
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifdef SHA256_WITH_X86
+
+/* Nonzero if the CPU supports the SHA, SSSE3 and SSE4.1 instructions. */
+int SHA256SHANISupported(void);
+
+/* Nonzero if the CPU supports the SSE4.1 instructions. */
+int SHA256SSE41Supported(void);
+
+/* Nonzero if the CPU and operating system support the AVX2 instructions. */
+int SHA256AVX2Supported(void);
+
+/* Compress the given number of consecutive 64 byte blocks into state. */
+void SHA256TransformSHANI(uint32_t state[SHA256_STATE_LENGTH],
+    const uint8_t* blocks, size_t count);
+
+/* Double hash count inputs of size bytes, 4 or 8 at a time in vector lanes.
+ * Returns the number of inputs hashed (a multiple of the lane count). */
+size_t SHA256DSSE41(uint8_t* out, const uint8_t* in, size_t size,
+    size_t count);
+size_t SHA256DAVX2(uint8_t* out, const uint8_t* in, size_t size,
+    size_t count);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
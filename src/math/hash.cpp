@@ -43,6 +43,17 @@ hash_digest bitcoin_hash(data_slice data)
     return sha256_hash(sha256_hash(data));
 }
 
+void bitcoin_hashes(hash_digest* out, data_slice data, size_t size)
+{
+    static_assert(sizeof(hash_digest) == hash_size, "unpadded hash_digest");
+
+    if (size == 0)
+        return;
+
+    SHA256D(reinterpret_cast<uint8_t*>(out), data.data(), size,
+        data.size() / size);
+}
+
 #ifdef BITPRIM_CURRENCY_LTC
 hash_digest litecoin_hash(data_slice data) {
     hash_digest hash;
@@ -110,6 +121,51 @@ hash_digest sha256_hash(data_slice first, data_slice second)
     return hash;
 }
 
+static int to_transform(sha256_implementation value)
+{
+    switch (value)
+    {
+        case sha256_implementation::scalar:
+            return SHA256_TRANSFORM_SCALAR;
+        case sha256_implementation::shani:
+            return SHA256_TRANSFORM_SHANI;
+        case sha256_implementation::sse41:
+            return SHA256_TRANSFORM_SSE41;
+        case sha256_implementation::avx2:
+            return SHA256_TRANSFORM_AVX2;
+        case sha256_implementation::automatic:
+        default:
+            return SHA256_TRANSFORM_AUTOMATIC;
+    }
+}
+
+bool sha256_supported(sha256_implementation value)
+{
+    return SHA256TransformSupported(to_transform(value)) != 0;
+}
+
+bool set_sha256_implementation(sha256_implementation value)
+{
+    return SHA256TransformSelect(to_transform(value)) != 0;
+}
+
+sha256_implementation get_sha256_implementation()
+{
+    switch (SHA256TransformSelected())
+    {
+        case SHA256_TRANSFORM_SCALAR:
+            return sha256_implementation::scalar;
+        case SHA256_TRANSFORM_SHANI:
+            return sha256_implementation::shani;
+        case SHA256_TRANSFORM_SSE41:
+            return sha256_implementation::sse41;
+        case SHA256_TRANSFORM_AVX2:
+            return sha256_implementation::avx2;
+        default:
+            return sha256_implementation::automatic;
+    }
+}
+
 hash_digest hmac_sha256_hash(data_slice data, data_slice key)
 {
     hash_digest hash;
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/public_key_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/pseudo_random.hpp>
+#include "../math/external/sha256.h"
+
+namespace libbitcoin {
+
+public_key_cache::public_key_cache(size_t memory, size_t shards)
+  : sets_(std::max(memory / sizeof(entry) / ways /
+        std::max(shards, size_t(1)), size_t(1))),
+    shard_count_(std::max(shards, size_t(1))),
+    shards_(new shard[shard_count_]),
+    hits_(0),
+    misses_(0)
+{
+    pseudo_random::fill(salt_);
+
+    for (size_t index = 0; index < shard_count_; ++index)
+        shards_[index].entries.resize(sets_ * ways, entry{});
+}
+
+// private
+hash_digest public_key_cache::to_digest(data_slice point) const
+{
+    hash_digest digest;
+    SHA256CTX context;
+    SHA256Init(&context);
+    SHA256Update(&context, salt_.data(), salt_.size());
+    SHA256Update(&context, point.data(), point.size());
+    SHA256Final(&context, digest.data());
+    return digest;
+}
+
+// private
+public_key_cache::shard& public_key_cache::to_shard(
+    const hash_digest& digest) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(digest.begin());
+    return shards_[value % shard_count_];
+}
+
+// private
+size_t public_key_cache::to_set(const hash_digest& digest) const
+{
+    const auto value = from_little_endian_unsafe<uint64_t>(digest.begin() +
+        sizeof(uint64_t));
+    return (value % sets_) * ways;
+}
+
+bool public_key_cache::find(parsed_key& out, data_slice point) const
+{
+    // Only public key sizes are stored, so others are not counted.
+    if (point.empty() || point.size() > ec_uncompressed_size)
+        return false;
+
+    const auto digest = to_digest(point);
+    const auto& bucket = to_shard(digest);
+    const auto first = bucket.entries.begin() + to_set(digest);
+    const auto last = first + ways;
+    const auto size = static_cast<uint8_t>(point.size());
+    const auto match = [&](const entry& item)
+    {
+        return item.size == size &&
+            std::equal(point.begin(), point.end(), item.point.begin());
+    };
+
+    bool found;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        shared_lock lock(bucket.mutex);
+        const auto it = std::find_if(first, last, match);
+        found = it != last;
+
+        if (found)
+            out = it->parsed;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+        ++hits_;
+    else
+        ++misses_;
+
+    return found;
+}
+
+void public_key_cache::store(data_slice point, const parsed_key& parsed)
+{
+    if (point.empty() || point.size() > ec_uncompressed_size)
+        return;
+
+    const auto digest = to_digest(point);
+    auto& bucket = to_shard(digest);
+    const auto first = bucket.entries.begin() + to_set(digest);
+    const auto last = first + ways;
+    const auto size = static_cast<uint8_t>(point.size());
+    const auto match = [&](const entry& item)
+    {
+        return item.size == size &&
+            std::equal(point.begin(), point.end(), item.point.begin());
+    };
+
+    const auto empty = [](const entry& item)
+    {
+        return item.size == 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(bucket.mutex);
+
+    if (std::find_if(first, last, match) != last)
+        return;
+
+    // Fill an empty way, otherwise evict one chosen by the digest.
+    auto slot = std::find_if(first, last, empty);
+    if (slot == last)
+        slot = first + (digest[sizeof(uint64_t) * 2] % ways);
+
+    slot->size = size;
+    std::copy(point.begin(), point.end(), slot->point.begin());
+    slot->parsed = parsed;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void public_key_cache::clear()
+{
+    for (size_t index = 0; index < shard_count_; ++index)
+    {
+        auto& bucket = shards_[index];
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        unique_lock lock(bucket.mutex);
+        std::fill(bucket.entries.begin(), bucket.entries.end(), entry{});
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    hits_ = 0;
+    misses_ = 0;
+}
+
+size_t public_key_cache::capacity() const
+{
+    return shard_count_ * sets_ * ways;
+}
+
+size_t public_key_cache::hits() const
+{
+    return hits_.load();
+}
+
+size_t public_key_cache::misses() const
+{
+    return misses_.load();
+}
+
+} // namespace libbitcoin
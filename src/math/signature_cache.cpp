@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/signature_cache.hpp>
+
+#include <cstddef>
+#include <bitcoin/bitcoin/math/elliptic_curve.hpp>
+#include <bitcoin/bitcoin/math/hash.hpp>
+#include <bitcoin/bitcoin/utility/pseudo_random.hpp>
+#include "../math/external/sha256.h"
+
+namespace libbitcoin {
+
+signature_cache::signature_cache(size_t memory, size_t shards)
+  : entries_(memory, shards)
+{
+    pseudo_random::fill(salt_);
+}
+
+// private
+hash_digest signature_cache::to_key(const hash_digest& sighash,
+    data_slice public_key, const ec_signature& signature) const
+{
+    hash_digest key;
+    SHA256CTX context;
+    SHA256Init(&context);
+    SHA256Update(&context, salt_.data(), salt_.size());
+    SHA256Update(&context, sighash.data(), sighash.size());
+    SHA256Update(&context, public_key.data(), public_key.size());
+    SHA256Update(&context, signature.data(), signature.size());
+    SHA256Final(&context, key.data());
+    return key;
+}
+
+bool signature_cache::contains(const hash_digest& sighash,
+    data_slice public_key, const ec_signature& signature) const
+{
+    return entries_.contains(to_key(sighash, public_key, signature));
+}
+
+void signature_cache::store(const hash_digest& sighash,
+    data_slice public_key, const ec_signature& signature)
+{
+    entries_.store(to_key(sighash, public_key, signature));
+}
+
+void signature_cache::clear()
+{
+    entries_.clear();
+}
+
+size_t signature_cache::capacity() const
+{
+    return entries_.capacity();
+}
+
+size_t signature_cache::hits() const
+{
+    return entries_.hits();
+}
+
+size_t signature_cache::misses() const
+{
+    return entries_.misses();
+}
+
+} // namespace libbitcoin
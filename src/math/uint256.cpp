@@ -0,0 +1,253 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/math/uint256.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace libbitcoin {
+
+// The division works on 32 bit digits so that each partial quotient and
+// remainder fits a 64 bit native integer.
+static constexpr size_t digits = 8;
+static constexpr uint64_t digit_base = uint64_t(1) << 32;
+
+static void to_digits(uint32_t out[digits], const uint256_t& value)
+{
+    for (size_t limb = 0; limb < 4; ++limb)
+    {
+        out[2 * limb] = static_cast<uint32_t>(value[limb]);
+        out[2 * limb + 1] = static_cast<uint32_t>(value[limb] >> 32);
+    }
+}
+
+static uint256_t from_digits(const uint32_t in[digits])
+{
+    const auto limb = [in](size_t index)
+    {
+        return (uint64_t(in[2 * index + 1]) << 32) | in[2 * index];
+    };
+
+    return{ limb(0), limb(1), limb(2), limb(3) };
+}
+
+static size_t significant(const uint32_t in[digits])
+{
+    auto count = digits;
+    while (count > 0 && in[count - 1] == 0)
+        --count;
+
+    return count;
+}
+
+static size_t leading_zeros(uint32_t digit)
+{
+    size_t zeros = 0;
+    for (; (digit & 0x80000000) == 0; digit <<= 1)
+        ++zeros;
+
+    return zeros;
+}
+
+// Knuth, The Art of Computer Programming, Vol 2, 4.3.1, Algorithm D.
+void uint256_t::divide(uint256_t& quotient, uint256_t& remainder,
+    const uint256_t& dividend, const uint256_t& divisor)
+{
+    uint32_t u[digits];
+    uint32_t v[digits];
+    uint32_t q[digits] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    to_digits(u, dividend);
+    to_digits(v, divisor);
+
+    const auto n = significant(v);
+    const auto m = significant(u);
+
+    if (n == 0)
+        throw std::overflow_error("Division by zero.");
+
+    if (dividend < divisor)
+    {
+        remainder = dividend;
+        quotient = 0;
+        return;
+    }
+
+    // Short division by a single digit.
+    if (n == 1)
+    {
+        uint64_t carry = 0;
+
+        for (auto j = m; j > 0; --j)
+        {
+            const auto current = (carry << 32) | u[j - 1];
+            q[j - 1] = static_cast<uint32_t>(current / v[0]);
+            carry = current % v[0];
+        }
+
+        quotient = from_digits(q);
+        remainder = carry;
+        return;
+    }
+
+    // Normalize so that the divisor's top digit has its high bit set.
+    const auto shift = leading_zeros(v[n - 1]);
+    uint32_t vn[digits];
+    uint32_t un[digits + 1];
+
+    for (auto i = n - 1; i > 0; --i)
+        vn[i] = static_cast<uint32_t>((uint64_t(v[i]) << shift) |
+            (uint64_t(v[i - 1]) >> (32 - shift)));
+
+    vn[0] = v[0] << shift;
+    un[m] = static_cast<uint32_t>(uint64_t(u[m - 1]) >> (32 - shift));
+
+    for (auto i = m - 1; i > 0; --i)
+        un[i] = static_cast<uint32_t>((uint64_t(u[i]) << shift) |
+            (uint64_t(u[i - 1]) >> (32 - shift)));
+
+    un[0] = u[0] << shift;
+
+    for (auto j = m - n + 1; j > 0; --j)
+    {
+        const auto at = j - 1;
+
+        // Estimate the quotient digit, which is at most two too high.
+        const auto numerator = (uint64_t(un[at + n]) << 32) | un[at + n - 1];
+        auto estimate = numerator / vn[n - 1];
+        auto rest = numerator % vn[n - 1];
+
+        while (estimate >= digit_base ||
+            estimate * vn[n - 2] > ((rest << 32) | un[at + n - 2]))
+        {
+            --estimate;
+            rest += vn[n - 1];
+
+            if (rest >= digit_base)
+                break;
+        }
+
+        // Multiply and subtract.
+        int64_t borrow = 0;
+        int64_t difference;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto product = estimate * vn[i];
+            difference = int64_t(un[i + at]) - borrow -
+                int64_t(product & 0xffffffff);
+            un[i + at] = static_cast<uint32_t>(difference);
+            borrow = int64_t(product >> 32) - (difference >> 32);
+        }
+
+        difference = int64_t(un[at + n]) - borrow;
+        un[at + n] = static_cast<uint32_t>(difference);
+        q[at] = static_cast<uint32_t>(estimate);
+
+        // The estimate was one too high, so add the divisor back.
+        if (difference < 0)
+        {
+            --q[at];
+            uint64_t carry = 0;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const auto sum = uint64_t(un[i + at]) + vn[i] + carry;
+                un[i + at] = static_cast<uint32_t>(sum);
+                carry = sum >> 32;
+            }
+
+            un[at + n] = static_cast<uint32_t>(un[at + n] + carry);
+        }
+    }
+
+    // Denormalize the remainder.
+    uint32_t r[digits] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < n; ++i)
+        r[i] = static_cast<uint32_t>((uint64_t(un[i]) >> shift) |
+            (uint64_t(un[i + 1]) << (32 - shift)));
+
+    quotient = from_digits(q);
+    remainder = from_digits(r);
+}
+
+static uint32_t to_digit(char character, uint32_t base)
+{
+    uint32_t digit = base;
+
+    if (character >= '0' && character <= '9')
+        digit = character - '0';
+    else if (character >= 'a' && character <= 'f')
+        digit = character - 'a' + 10;
+    else if (character >= 'A' && character <= 'F')
+        digit = character - 'A' + 10;
+
+    if (digit >= base)
+        throw std::invalid_argument("Invalid uint256 text.");
+
+    return digit;
+}
+
+uint256_t::uint256_t(const std::string& text)
+  : uint256_t()
+{
+    const auto hexadecimal = text.size() > 2 && text[0] == '0' &&
+        (text[1] == 'x' || text[1] == 'X');
+
+    const uint32_t base = hexadecimal ? 16 : 10;
+    const auto start = text.begin() + (hexadecimal ? 2 : 0);
+
+    if (start == text.end())
+        throw std::invalid_argument("Invalid uint256 text.");
+
+    for (auto character = start; character != text.end(); ++character)
+    {
+        *this *= base;
+        *this += to_digit(*character, base);
+    }
+}
+
+std::ostream& operator<<(std::ostream& stream, const uint256_t& value)
+{
+    const auto hexadecimal = (stream.flags() & std::ios::hex) != 0;
+    const uint32_t base = hexadecimal ? 16 : 10;
+    static const char symbols[] = "0123456789abcdef";
+
+    std::string text;
+    auto rest = value;
+    uint256_t digit;
+
+    do
+    {
+        uint256_t::divide(rest, digit, rest, base);
+        text.push_back(symbols[digit[0]]);
+    } while (rest);
+
+    if (hexadecimal && (stream.flags() & std::ios::showbase) != 0)
+        text.append("x0");
+
+    std::reverse(text.begin(), text.end());
+    return stream << text;
+}
+
+} // namespace libbitcoin
@@ -28,6 +28,7 @@
 #include <bitcoin/bitcoin/utility/data.hpp>
 #include <bitcoin/bitcoin/utility/reader.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 
 namespace libbitcoin {
@@ -196,7 +197,9 @@ data_chunk to_data_header_nonce(block const& block, uint64_t nonce) {
 }
 
 hash_digest hash(block const& block, uint64_t nonce) {
-    return sha256_hash(to_data_header_nonce(block,nonce));
+    hash_writer sink;
+    to_data_header_nonce(block, nonce, sink);
+    return sink.sha256_hash();
 }
 
 } // namespace message
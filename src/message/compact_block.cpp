@@ -25,6 +25,7 @@
 #include <bitcoin/bitcoin/multi_crypto_support.hpp>
 #include <bitcoin/bitcoin/utility/container_sink.hpp>
 #include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
 #include <bitcoin/bitcoin/utility/pseudo_random.hpp>
@@ -428,7 +429,9 @@ data_chunk to_data_header_nonce(compact_block const& block) {
 }
 
 hash_digest hash(compact_block const& block) {
-    return sha256_hash(to_data_header_nonce(block));
+    hash_writer sink;
+    to_data_header_nonce(block, sink);
+    return sink.sha256_hash();
 }
 
 
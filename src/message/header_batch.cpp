@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/message/header_batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <istream>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/error.hpp>
+#include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/message/headers.hpp>
+#include <bitcoin/bitcoin/message/version.hpp>
+#include <bitcoin/bitcoin/utility/assert.hpp>
+#include <bitcoin/bitcoin/utility/container_source.hpp>
+#include <bitcoin/bitcoin/utility/deserializer.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include <bitcoin/bitcoin/utility/istream_reader.hpp>
+#include <bitcoin/bitcoin/utility/synchronizer.hpp>
+#include <bitcoin/bitcoin/utility/timer.hpp>
+
+namespace libbitcoin {
+namespace message {
+
+// Serialized header offsets.
+static const size_t previous_offset = sizeof(uint32_t);
+static const size_t timestamp_offset = previous_offset + 2 * hash_size;
+static const size_t bits_offset = timestamp_offset + sizeof(uint32_t);
+
+// Below this many headers per bucket the pool is not worth engaging.
+static const size_t minimum_bucket = 64;
+
+header_batch::header_batch()
+{
+}
+
+bool header_batch::from_data(uint32_t version, const data_chunk& data)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return from_data(version, source);
+}
+
+bool header_batch::from_data(uint32_t version, std::istream& stream)
+{
+    istream_reader source(stream);
+    return from_data(version, source);
+}
+
+bool header_batch::from_data(uint32_t version, reader& source)
+{
+    reset();
+
+    const auto count = source.read_size_little_endian();
+
+    // Guard against potential for arbitary memory allocation.
+    if (count > max_get_headers)
+        source.invalidate();
+    else
+        elements_.resize(count);
+
+    const auto canonical = (version == version::level::canonical);
+    data_chunk buffer;
+
+    // Each header is followed by an empty transaction count on the wire.
+    for (auto& element: elements_)
+    {
+        source.read_bytes(buffer, element.size());
+        std::copy(buffer.begin(), buffer.end(), element.begin());
+
+        if (!canonical && source.read_byte() != 0x00)
+            source.invalidate();
+
+        if (!source)
+            break;
+    }
+
+    if (version < headers::version_minimum)
+        source.invalidate();
+
+    if (!source)
+    {
+        reset();
+        return false;
+    }
+
+    // The elements are contiguous, so all are hashed in one batch.
+    hashes_.resize(elements_.size());
+
+    if (!elements_.empty())
+        bitcoin_hashes(hashes_.data(), { elements_.front().data(),
+            elements_.front().data() + elements_.size() *
+            sizeof(header_data) }, sizeof(header_data));
+
+    return true;
+}
+
+void header_batch::reset()
+{
+    elements_.clear();
+    elements_.shrink_to_fit();
+    hashes_.clear();
+    hashes_.shrink_to_fit();
+}
+
+size_t header_batch::size() const
+{
+    return elements_.size();
+}
+
+bool header_batch::empty() const
+{
+    return elements_.empty();
+}
+
+const header_batch::list& header_batch::elements() const
+{
+    return elements_;
+}
+
+const hash_list& header_batch::hashes() const
+{
+    return hashes_;
+}
+
+chain::header header_batch::get(size_t index) const
+{
+    BITCOIN_ASSERT(index < size());
+    const auto& element = elements_[index];
+    auto source = make_safe_deserializer(element.begin(), element.end());
+    const auto instance = chain::header::factory_from_data(source);
+    return chain::header(instance, hashes_[index]);
+}
+
+// Validation.
+//-----------------------------------------------------------------------------
+
+size_t header_batch::first_unlinked(const hash_digest& previous) const
+{
+    auto expected = &previous;
+
+    for (size_t index = 0; index < elements_.size(); ++index)
+    {
+        const auto link = elements_[index].begin() + previous_offset;
+
+        if (!std::equal(expected->begin(), expected->end(), link))
+            return index;
+
+        expected = &hashes_[index];
+    }
+
+    return elements_.size();
+}
+
+bool header_batch::is_valid(size_t index, uint32_t future,
+    bool retarget) const
+{
+    const auto& element = elements_[index];
+    const auto timestamp = from_little_endian_unsafe<uint32_t>(
+        element.begin() + timestamp_offset);
+    const auto bits = from_little_endian_unsafe<uint32_t>(
+        element.begin() + bits_offset);
+
+#ifdef BITPRIM_CURRENCY_LTC
+    const auto& pow_hash = get(index).litecoin_proof_of_work_hash();
+#else
+    const auto& pow_hash = hashes_[index];
+#endif
+
+    return timestamp <= future &&
+        chain::header::is_valid_proof_of_work(bits, pow_hash, retarget);
+}
+
+// The latest valid timestamp, saturated in the 32 bit header field.
+static uint32_t future_limit()
+{
+    const auto future = static_cast<uint64_t>(zulu_time()) +
+        timestamp_future_seconds;
+    return static_cast<uint32_t>(std::min<uint64_t>(future, max_uint32));
+}
+
+size_t header_batch::check(const hash_digest& previous, bool retarget) const
+{
+    const auto future = future_limit();
+    const auto unlinked = first_unlinked(previous);
+
+    for (size_t index = 0; index < unlinked; ++index)
+        if (!is_valid(index, future, retarget))
+            return index;
+
+    return unlinked;
+}
+
+// Linkage is a sequential pass of comparisons, proof of work of the linked
+// prefix is distributed over buckets by index. Each bucket stops once a lower
+// index has failed, so the lowest failure is that of the serial check.
+size_t header_batch::check(const hash_digest& previous, dispatcher& dispatch,
+    bool retarget) const
+{
+    const auto unlinked = first_unlinked(previous);
+    const auto buckets = std::min(dispatch.size(), unlinked / minimum_bucket);
+
+    if (buckets < 2)
+        return check(previous, retarget);
+
+    const auto future = future_limit();
+    std::atomic<size_t> first_failure(unlinked);
+
+    const auto check_bucket = [&](size_t bucket)
+    {
+        for (auto index = bucket; index < unlinked; index += buckets)
+        {
+            if (index > first_failure.load())
+                return;
+
+            if (is_valid(index, future, retarget))
+                continue;
+
+            auto current = first_failure.load();
+            while (index < current &&
+                !first_failure.compare_exchange_weak(current, index));
+
+            return;
+        }
+    };
+
+    const auto complete = std::make_shared<std::promise<void>>();
+    auto finished = complete->get_future();
+    const auto handler = [complete](const code&)
+    {
+        complete->set_value();
+    };
+
+    auto join = synchronize(handler, buckets - 1, "headers",
+        synchronizer_terminate::on_count);
+
+    for (size_t bucket = 1; bucket < buckets; ++bucket)
+    {
+        dispatch.concurrent([&check_bucket, bucket, join]() mutable
+        {
+            check_bucket(bucket);
+            join(error::success);
+        });
+    }
+
+    check_bucket(0);
+    finished.wait();
+    return first_failure.load();
+}
+
+} // namespace message
+} // namespace libbitcoin
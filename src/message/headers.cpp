@@ -23,6 +23,7 @@
 #include <initializer_list>
 #include <istream>
 #include <utility>
+#include <vector>
 #include <bitcoin/bitcoin/math/limits.hpp>
 #include <bitcoin/bitcoin/message/inventory.hpp>
 #include <bitcoin/bitcoin/message/inventory_vector.hpp>
@@ -32,6 +33,7 @@
 #include <bitcoin/bitcoin/utility/container_source.hpp>
 #include <bitcoin/bitcoin/utility/istream_reader.hpp>
 #include <bitcoin/bitcoin/utility/ostream_writer.hpp>
+#include <bitcoin/bitcoin/utility/serializer.hpp>
 
 namespace libbitcoin {
 namespace message {
@@ -175,29 +177,44 @@ bool headers::is_sequential() const
     if (elements_.empty())
         return true;
 
-    auto previous = elements_.front().hash();
+    hash_list hashes;
+    to_hashes(hashes);
 
-    for (auto it = elements_.begin() + 1; it != elements_.end(); ++it)
-    {
-        if (it->previous_block_hash() != previous)
+    for (size_t index = 1; index < elements_.size(); ++index)
+        if (elements_[index].previous_block_hash() != hashes[index - 1])
             return false;
 
-        previous = it->hash();
-    }
-
     return true;
 }
 
+// Cached hashes are reused, the others are hashed as one batch.
 void headers::to_hashes(hash_list& out) const
 {
-    out.clear();
-    out.reserve(elements_.size());
-    const auto map = [&out](const header& header)
-    {
-        out.push_back(header.hash());
-    };
+    const auto size = chain::header::satoshi_fixed_size();
+    std::vector<size_t> uncached;
+    out.resize(elements_.size());
 
-    std::for_each(elements_.begin(), elements_.end(), map);
+    for (size_t index = 0; index < elements_.size(); ++index)
+        if (elements_[index].is_hashed())
+            out[index] = elements_[index].hash();
+        else
+            uncached.push_back(index);
+
+    if (uncached.empty())
+        return;
+
+    // Serialize contiguously so the uncached headers are hashed as a batch.
+    data_chunk data(uncached.size() * size);
+    auto sink = make_unsafe_serializer(data.begin());
+
+    for (const auto index: uncached)
+        elements_[index].chain::header::to_data(sink);
+
+    hash_list hashes(uncached.size());
+    bitcoin_hashes(hashes.data(), data, size);
+
+    for (size_t index = 0; index < uncached.size(); ++index)
+        out[uncached[index]] = hashes[index];
 }
 
 void headers::to_inventory(inventory_vector::list& out,
@@ -0,0 +1,253 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/bitcoin/utility/hash_writer.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <bitcoin/bitcoin/constants.hpp>
+#include <bitcoin/bitcoin/math/limits.hpp>
+#include <bitcoin/bitcoin/utility/endian.hpp>
+#include "../math/external/sha256.h"
+
+namespace libbitcoin {
+
+static const uint8_t zeros[64] = { 0 };
+
+hash_writer::hash_writer()
+  : context_(new SHA256CTX)
+{
+    SHA256Init(context_.get());
+}
+
+// The context is a plain C struct, so copies retain the hash state.
+hash_writer::hash_writer(const hash_writer& other)
+  : context_(new SHA256CTX(*other.context_))
+{
+}
+
+hash_writer::hash_writer(hash_writer&& other) BC_NOEXCEPT
+  : context_(std::move(other.context_))
+{
+}
+
+hash_writer::~hash_writer()
+{
+}
+
+hash_writer& hash_writer::operator=(const hash_writer& other)
+{
+    context_.reset(new SHA256CTX(*other.context_));
+    return *this;
+}
+
+hash_writer& hash_writer::operator=(hash_writer&& other) BC_NOEXCEPT
+{
+    context_ = std::move(other.context_);
+    return *this;
+}
+
+// Context.
+//-----------------------------------------------------------------------------
+
+hash_writer::operator bool() const
+{
+    return true;
+}
+
+bool hash_writer::operator!() const
+{
+    return false;
+}
+
+// Hashes.
+//-----------------------------------------------------------------------------
+
+void hash_writer::write_hash(const hash_digest& value)
+{
+    write_bytes(value.data(), value.size());
+}
+
+void hash_writer::write_short_hash(const short_hash& value)
+{
+    write_bytes(value.data(), value.size());
+}
+
+void hash_writer::write_mini_hash(const mini_hash& value)
+{
+    write_bytes(value.data(), value.size());
+}
+
+hash_digest hash_writer::sha256_hash()
+{
+    hash_digest hash;
+    SHA256Final(context_.get(), hash.data());
+    SHA256Init(context_.get());
+    return hash;
+}
+
+hash_digest hash_writer::bitcoin_hash()
+{
+    hash_digest hash;
+    const auto context = context_.get();
+    SHA256Final(context, hash.data());
+    SHA256Init(context);
+    SHA256Update(context, hash.data(), hash.size());
+    SHA256Final(context, hash.data());
+    SHA256Init(context);
+    return hash;
+}
+
+// Big Endian Integers.
+//-----------------------------------------------------------------------------
+
+void hash_writer::write_2_bytes_big_endian(uint16_t value)
+{
+    write_big_endian<uint16_t>(value);
+}
+
+void hash_writer::write_4_bytes_big_endian(uint32_t value)
+{
+    write_big_endian<uint32_t>(value);
+}
+
+void hash_writer::write_8_bytes_big_endian(uint64_t value)
+{
+    write_big_endian<uint64_t>(value);
+}
+
+void hash_writer::write_variable_big_endian(uint64_t value)
+{
+    if (value < varint_two_bytes)
+    {
+        write_byte(static_cast<uint8_t>(value));
+    }
+    else if (value <= max_uint16)
+    {
+        write_byte(varint_two_bytes);
+        write_2_bytes_big_endian(static_cast<uint16_t>(value));
+    }
+    else if (value <= max_uint32)
+    {
+        write_byte(varint_four_bytes);
+        write_4_bytes_big_endian(static_cast<uint32_t>(value));
+    }
+    else
+    {
+        write_byte(varint_eight_bytes);
+        write_8_bytes_big_endian(value);
+    }
+}
+
+void hash_writer::write_size_big_endian(size_t value)
+{
+    write_variable_big_endian(value);
+}
+
+// Little Endian Integers.
+//-----------------------------------------------------------------------------
+
+void hash_writer::write_error_code(const code& ec)
+{
+    write_4_bytes_little_endian(static_cast<uint32_t>(ec.value()));
+}
+
+void hash_writer::write_2_bytes_little_endian(uint16_t value)
+{
+    write_little_endian<uint16_t>(value);
+}
+
+void hash_writer::write_4_bytes_little_endian(uint32_t value)
+{
+    write_little_endian<uint32_t>(value);
+}
+
+void hash_writer::write_8_bytes_little_endian(uint64_t value)
+{
+    write_little_endian<uint64_t>(value);
+}
+
+void hash_writer::write_variable_little_endian(uint64_t value)
+{
+    if (value < varint_two_bytes)
+    {
+        write_byte(static_cast<uint8_t>(value));
+    }
+    else if (value <= max_uint16)
+    {
+        write_byte(varint_two_bytes);
+        write_2_bytes_little_endian(static_cast<uint16_t>(value));
+    }
+    else if (value <= max_uint32)
+    {
+        write_byte(varint_four_bytes);
+        write_4_bytes_little_endian(static_cast<uint32_t>(value));
+    }
+    else
+    {
+        write_byte(varint_eight_bytes);
+        write_8_bytes_little_endian(value);
+    }
+}
+
+void hash_writer::write_size_little_endian(size_t value)
+{
+    write_variable_little_endian(value);
+}
+
+// Bytes.
+//-----------------------------------------------------------------------------
+
+void hash_writer::write_byte(uint8_t value)
+{
+    write_bytes(&value, 1);
+}
+
+void hash_writer::write_bytes(const data_chunk& data)
+{
+    write_bytes(data.data(), data.size());
+}
+
+void hash_writer::write_bytes(const uint8_t* data, size_t size)
+{
+    if (size > 0)
+        SHA256Update(context_.get(), data, size);
+}
+
+void hash_writer::write_string(const std::string& value, size_t size)
+{
+    const auto length = std::min(size, value.size());
+    write_bytes(reinterpret_cast<const uint8_t*>(value.data()), length);
+    skip(floor_subtract(size, length));
+}
+
+void hash_writer::write_string(const std::string& value)
+{
+    write_variable_little_endian(value.size());
+    write_bytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+void hash_writer::skip(size_t size)
+{
+    for (; size > sizeof(zeros); size -= sizeof(zeros))
+        write_bytes(zeros, sizeof(zeros));
+
+    write_bytes(zeros, size);
+}
+
+} // namespace libbitcoin
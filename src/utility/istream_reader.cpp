@@ -214,6 +214,19 @@ data_chunk istream_reader::read_bytes(size_t size)
     return out;
 }
 
+// Output size is guaranteed.
+// This is a memory exhaustion risk if caller does not control size.
+void istream_reader::read_bytes(data_chunk& out, size_t size)
+{
+    out.resize(size);
+
+    if (size > 0)
+    {
+        auto buffer = reinterpret_cast<char*>(out.data());
+        stream_.read(buffer, size);
+    }
+}
+
 std::string istream_reader::read_string()
 {
     return read_string(read_size_little_endian());
@@ -514,14 +514,14 @@ payment_address::list payment_address::extract_output(
         {
             return
             {
-                { to_array<short_hash_size>(script[2].data()), p2kh_version }
+                { to_array<short_hash_size>(script.payload()), p2kh_version }
             };
         }
         case script_pattern::pay_script_hash:
         {
             return
             {
-                { to_array<short_hash_size>(script[1].data()), p2sh_version }
+                { to_array<short_hash_size>(script.payload()), p2sh_version }
             };
         }
         case script_pattern::pay_public_key:
@@ -529,7 +529,7 @@ payment_address::list payment_address::extract_output(
             return
             {
                 // pay_public_key is not p2kh but we conflate for tracking.
-                { ec_public{ script[0].data() }, p2kh_version }
+                { ec_public{ to_chunk(script.payload()) }, p2kh_version }
             };
         }
 
@@ -355,6 +355,33 @@ BOOST_AUTO_TEST_CASE(block__factory_from_data_3__genesis_mainnet__success)
     BOOST_REQUIRE(genesis.header().merkle() == block.generate_merkle_root());
 }
 
+BOOST_AUTO_TEST_CASE(block__from_data__recycled_instance__equals_fresh_instance)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const auto testnet = chain::block::genesis_testnet();
+    chain::transaction tx;
+    tx.set_version(1);
+    tx.set_inputs({ { chain::output_point{ genesis.hash(), 0 }, chain::script{ { 0x51 }, false }, 42 } });
+    tx.set_outputs({ { 1, chain::script{ { 0x51 }, false } } });
+    const chain::block two_tx(testnet.header(), { testnet.transactions().front(), tx });
+
+    chain::block instance;
+    BOOST_REQUIRE(instance.from_data(two_tx.to_data()));
+    BOOST_REQUIRE(instance == two_tx);
+    instance.transactions().front().outputs().front().validation.spender_height = 42;
+
+    // Fewer transactions, with larger scripts.
+    BOOST_REQUIRE(instance.from_data(genesis.to_data()));
+    BOOST_REQUIRE(instance == genesis);
+    BOOST_REQUIRE_EQUAL(instance.transactions().front().outputs().front().validation.spender_height,
+        chain::output::validation::not_spent);
+
+    BOOST_REQUIRE(instance.from_data(two_tx.to_data()));
+    BOOST_REQUIRE(instance == two_tx);
+    BOOST_REQUIRE(instance.hash() == two_tx.hash());
+    BOOST_REQUIRE(instance.generate_merkle_root() == two_tx.generate_merkle_root());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(block_generate_merkle_root_tests)
@@ -724,4 +751,185 @@ BOOST_AUTO_TEST_CASE(block__is_forward_reference__forward_reference__true)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(block_is_internal_double_spend_tests)
+
+BOOST_AUTO_TEST_CASE(block__is_internal_double_spend__no_transactions__false)
+{
+    chain::block value;
+    BOOST_REQUIRE(!value.is_internal_double_spend());
+}
+
+BOOST_AUTO_TEST_CASE(block__is_internal_double_spend__distinct_prevouts__false)
+{
+    chain::block value;
+    chain::transaction coinbase{ 1, 0, { { { null_hash, chain::point::null_index }, {}, 0 } }, {} };
+    chain::transaction first{ 1, 0, { { { hash_literal("ab00000000000000000000000000000000000000000000000000000000000000"), 0 }, {}, 0 }, { { hash_literal("ab00000000000000000000000000000000000000000000000000000000000000"), 1 }, {}, 0 } }, {} };
+    chain::transaction second{ 1, 0, { { { hash_literal("cd00000000000000000000000000000000000000000000000000000000000000"), 0 }, {}, 0 } }, {} };
+    value.set_transactions({ coinbase, first, second });
+    BOOST_REQUIRE(!value.is_internal_double_spend());
+}
+
+BOOST_AUTO_TEST_CASE(block__is_internal_double_spend__same_prevout_in_two_transactions__true)
+{
+    chain::block value;
+    chain::transaction coinbase{ 1, 0, { { { null_hash, chain::point::null_index }, {}, 0 } }, {} };
+    chain::transaction first{ 1, 0, { { { hash_literal("ab00000000000000000000000000000000000000000000000000000000000000"), 1 }, {}, 0 } }, {} };
+    chain::transaction second{ 2, 0, { { { hash_literal("ab00000000000000000000000000000000000000000000000000000000000000"), 1 }, {}, 0 } }, {} };
+    value.set_transactions({ coinbase, first, second });
+    BOOST_REQUIRE(value.is_internal_double_spend());
+}
+
+BOOST_AUTO_TEST_CASE(block__is_internal_double_spend__many_distinct_prevouts__false)
+{
+    chain::block value;
+    chain::transaction coinbase{ 1, 0, { { { null_hash, chain::point::null_index }, {}, 0 } }, {} };
+    chain::input::list inputs;
+
+    for (uint32_t index = 0; index < 1000; ++index)
+        inputs.push_back({ { null_hash, index }, {}, 0 });
+
+    value.set_transactions({ coinbase, { 1, 0, std::move(inputs), {} } });
+    BOOST_REQUIRE(!value.is_internal_double_spend());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(block_check_tests)
+
+BOOST_AUTO_TEST_CASE(block__check__dispatcher__matches_serial)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    BOOST_REQUIRE_EQUAL(genesis.check().value(), error::success);
+    BOOST_REQUIRE_EQUAL(genesis.check(dispatch).value(), error::success);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block__check__dispatcher_double_spend_and_merkle_mismatch__first_in_order)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const auto prevout = hash_literal("ab00000000000000000000000000000000000000000000000000000000000000");
+    chain::transaction first{ 1, 0, { { { prevout, 0 }, {}, 0 } }, {} };
+    chain::transaction second{ 2, 0, { { { prevout, 0 }, {}, 0 } }, {} };
+    const chain::block value(genesis.header(), { genesis.transactions().front(), first, second });
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    BOOST_REQUIRE_EQUAL(value.check().value(), error::block_internal_double_spend);
+    BOOST_REQUIRE_EQUAL(value.check(dispatch).value(), error::block_internal_double_spend);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(block_connect_tests)
+
+static const config::checkpoint::list no_checkpoints;
+
+static chain::chain_state connect_state()
+{
+    chain::chain_state::data values;
+    values.height = 1000;
+    values.hash = null_hash;
+    values.allow_collisions_hash = null_hash;
+    values.bip9_bit0_hash = null_hash;
+    values.bip9_bit1_hash = null_hash;
+    values.bits.self = 0x207fffff;
+    values.bits.ordered = { 0x207fffff };
+    values.version.self = 4;
+    values.version.ordered = {};
+    values.timestamp.self = 1000;
+    values.timestamp.retarget = 0;
+    values.timestamp.ordered = { 1000 };
+
+    return chain::chain_state(std::move(values), no_checkpoints, machine::rule_fork::no_rules
+#ifdef BITPRIM_CURRENCY_BCH
+        , 0, 0
+#endif
+    );
+}
+
+// Each input spends an output with the given script, or an uncached one.
+static chain::transaction spend(uint32_t version,
+    const std::vector<std::string>& prevout_scripts)
+{
+    chain::input::list inputs;
+
+    for (uint32_t index = 0; index < prevout_scripts.size(); ++index)
+    {
+        chain::input input{ { hash_literal("ab00000000000000000000000000000000000000000000000000000000000000"), index }, {}, 0 };
+        chain::script prevout_script;
+
+        if (!prevout_scripts[index].empty())
+        {
+            BOOST_REQUIRE(prevout_script.from_string(prevout_scripts[index]));
+            input.previous_output().validation.cache = { 1, prevout_script };
+        }
+
+        inputs.push_back(input);
+    }
+
+    return { version, 0, std::move(inputs), { { 1, {} } } };
+}
+
+static chain::block connect_block(const chain::transaction::list& spends)
+{
+    chain::transaction coinbase{ 1, 0, { { { null_hash, chain::point::null_index }, {}, 0 } }, { { 1, {} } } };
+    chain::transaction::list transactions{ coinbase };
+    transactions.insert(transactions.end(), spends.begin(), spends.end());
+    chain::block value;
+    value.set_transactions(std::move(transactions));
+    return value;
+}
+
+BOOST_AUTO_TEST_CASE(block__connect__dispatcher_valid__success)
+{
+    const std::vector<std::string> valid(16, "1");
+    const auto value = connect_block({ spend(1, valid), spend(2, valid), spend(3, valid) });
+    const auto state = connect_state();
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    BOOST_REQUIRE_EQUAL(value.connect(state).value(), error::success);
+    BOOST_REQUIRE_EQUAL(value.connect(state, dispatch).value(), error::success);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(block__connect__dispatcher_several_failures__first_in_block_order)
+{
+    std::vector<std::string> second(16, "1");
+    std::vector<std::string> third(16, "1");
+    std::vector<std::string> fourth(16, "1");
+    second[9] = "return";
+    third[0] = "0";
+    fourth[1] = "";
+
+    const auto first = spend(1, std::vector<std::string>(16, "1"));
+    const auto expected = spend(2, second);
+    const auto value = connect_block({ first, expected, spend(3, third), spend(4, fourth) });
+    const auto state = connect_state();
+    const auto serial = value.connect(state);
+
+    BOOST_REQUIRE(serial);
+    BOOST_REQUIRE_EQUAL(serial.value(), expected.connect(state).value());
+    BOOST_REQUIRE(serial.value() != spend(3, third).connect(state).value());
+    BOOST_REQUIRE(serial.value() != spend(4, fourth).connect(state).value());
+
+    for (const auto threads: { 2, 3, 4, 8 })
+    {
+        threadpool pool(threads);
+        dispatcher dispatch(pool, "test");
+
+        for (size_t round = 0; round < 10; ++round)
+            BOOST_REQUIRE_EQUAL(value.connect(state, dispatch).value(), serial.value());
+
+        pool.shutdown();
+        pool.join();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(block_view_tests)
+
+#define TX1 \
+"0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc" \
+"4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294" \
+"789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e" \
+"2830b115472fb31de67d16972867f13945012103e589480b2f746381fca01a9b" \
+"12c517b7a482a203c8b2742985da0ac72cc078f2ffffffff02f0c9c467000000" \
+"001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00" \
+"0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000" \
+"00"
+
+BOOST_AUTO_TEST_CASE(block_view__constructor__insufficient_bytes__invalid)
+{
+    const data_chunk data(10);
+    const chain::block_view instance(data);
+    BOOST_REQUIRE(!instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.transaction_count(), 0u);
+    BOOST_REQUIRE(instance.hash() == null_hash);
+}
+
+BOOST_AUTO_TEST_CASE(block_view__constructor__genesis__matches_block)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    const auto raw_block = genesis.to_data();
+
+    const chain::block_view instance(raw_block);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(instance.hash() == genesis.hash());
+    BOOST_REQUIRE(to_chunk(instance.header_data()) == genesis.header().to_data());
+    BOOST_REQUIRE_EQUAL(instance.transaction_count(), 1u);
+    BOOST_REQUIRE(instance.to_header() == genesis.header());
+    BOOST_REQUIRE(instance.to_block() == genesis);
+}
+
+BOOST_AUTO_TEST_CASE(block_view__transactions__two_transactions__expected_offsets_and_hashes)
+{
+    const auto genesis = chain::block::genesis_mainnet();
+    chain::transaction tx1;
+    BOOST_REQUIRE(tx1.from_data(to_chunk(base16_literal(TX1))));
+    const chain::block expected(genesis.header(), { genesis.transactions().front(), tx1 });
+    const auto raw_block = expected.to_data();
+
+    const chain::block_view instance(raw_block);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.transaction_count(), 2u);
+
+    const auto offsets = instance.transaction_offsets();
+    BOOST_REQUIRE_EQUAL(offsets.size(), 2u);
+    BOOST_REQUIRE_EQUAL(offsets[0], chain::header::satoshi_fixed_size() + 1u);
+    BOOST_REQUIRE_EQUAL(offsets[1], offsets[0] + expected.transactions()[0].serialized_size());
+
+    const auto transactions = instance.transactions();
+    BOOST_REQUIRE_EQUAL(transactions.size(), 2u);
+    BOOST_REQUIRE(transactions[0].hash() == expected.transactions()[0].hash());
+    BOOST_REQUIRE(transactions[1].hash() == expected.transactions()[1].hash());
+    BOOST_REQUIRE(instance.to_block() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(block_view__transactions__truncated__empty)
+{
+    const auto raw_block = chain::block::genesis_mainnet().to_data();
+    const data_slice truncated(raw_block.data(), raw_block.data() + raw_block.size() - 1);
+
+    const chain::block_view instance(truncated);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.transaction_count(), 1u);
+    BOOST_REQUIRE(instance.transaction_offsets().empty());
+    BOOST_REQUIRE(instance.transactions().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+BOOST_AUTO_TEST_SUITE(chain_state_tests)
+
+static const auto tip_hash = hash_literal("000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+static const auto other_hash = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+static const config::checkpoint::list test_checkpoints{ { tip_hash, 0 }, { other_hash, 5 } };
+
+static const uint32_t test_forks = rule_fork::bip34_rule;
+
+// The windows are of the mapped sizes for the height and forks.
+static chain_state::data test_data()
+{
+    static const std::vector<uint32_t> timestamps
+    {
+        900, 1100, 1000, 1200, 1150, 1250, 1050, 1300, 1120, 1180, 1160, 1140
+    };
+
+    const auto map = chain_state::get_map(12, test_checkpoints, test_forks);
+    BOOST_REQUIRE(map.timestamp.count <= timestamps.size());
+
+    chain_state::data values;
+    values.height = 12;
+    values.hash = tip_hash;
+    values.allow_collisions_hash = other_hash;
+    values.bip9_bit0_hash = null_hash;
+    values.bip9_bit1_hash = other_hash;
+    values.bits.self = 0x1d00ffff;
+    values.bits.ordered.resize(map.bits.count);
+    std::fill(values.bits.ordered.begin(), values.bits.ordered.end(), 0x1d00ffff);
+    values.version.self = 4;
+
+    for (uint32_t index = 0; index < map.version.count; ++index)
+        values.version.ordered.push_back(index % 4 + 1);
+
+    values.timestamp.self = 1300;
+    values.timestamp.retarget = 1000;
+
+    for (auto it = timestamps.end() - map.timestamp.count; it != timestamps.end(); ++it)
+        values.timestamp.ordered.push_back(*it);
+
+    return values;
+}
+
+static chain_state test_state(const config::checkpoint::list& checkpoints,
+    chain_state::data&& values=test_data())
+{
+    return chain_state(std::move(values), checkpoints, test_forks
+#ifdef BITPRIM_CURRENCY_BCH
+        , 42, 43
+#endif
+    );
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__to_data__always__serialized_size)
+{
+    const auto state = test_state(test_checkpoints);
+    BOOST_REQUIRE_EQUAL(state.to_data().size(), state.serialized_size());
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__round_trip__equal_state)
+{
+    const auto expected = test_state(test_checkpoints);
+    const auto data = expected.to_data();
+    const auto state = chain_state::factory_from_data(data, test_checkpoints, tip_hash);
+    BOOST_REQUIRE(state);
+    BOOST_REQUIRE(state->is_valid());
+    BOOST_REQUIRE_EQUAL(state->height(), expected.height());
+    BOOST_REQUIRE_EQUAL(state->enabled_forks(), expected.enabled_forks());
+    BOOST_REQUIRE_EQUAL(state->minimum_version(), expected.minimum_version());
+    BOOST_REQUIRE_EQUAL(state->median_time_past(), expected.median_time_past());
+    BOOST_REQUIRE_EQUAL(state->work_required(), expected.work_required());
+    BOOST_REQUIRE_EQUAL(state->median_time_past(), 1150u);
+#ifdef BITPRIM_CURRENCY_BCH
+    BOOST_REQUIRE_EQUAL(state->monolith_activation_time(), 42u);
+    BOOST_REQUIRE_EQUAL(state->magnetic_anomaly_activation_time(), 43u);
+#endif
+    BOOST_REQUIRE(state->to_data() == data);
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__stream_round_trip__equal_data)
+{
+    const auto expected = test_state(test_checkpoints);
+    std::stringstream stream;
+    expected.to_data(stream);
+    const auto state = chain_state::factory_from_data(stream, test_checkpoints, tip_hash);
+    BOOST_REQUIRE(state);
+    BOOST_REQUIRE(state->to_data() == expected.to_data());
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__other_tip__null)
+{
+    const auto data = test_state(test_checkpoints).to_data();
+    BOOST_REQUIRE(!chain_state::factory_from_data(data, test_checkpoints, other_hash));
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__other_checkpoints__null)
+{
+    const auto data = test_state(test_checkpoints).to_data();
+    const config::checkpoint::list fewer{ { tip_hash, 0 } };
+    const config::checkpoint::list changed{ { tip_hash, 0 }, { other_hash, 6 } };
+    BOOST_REQUIRE(!chain_state::factory_from_data(data, fewer, tip_hash));
+    BOOST_REQUIRE(!chain_state::factory_from_data(data, changed, tip_hash));
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__other_version__null)
+{
+    auto data = test_state(test_checkpoints).to_data();
+    data[0] ^= 0xff;
+    BOOST_REQUIRE(!chain_state::factory_from_data(data, test_checkpoints, tip_hash));
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__unmapped_window_sizes__null)
+{
+    auto short_bits = test_data();
+    short_bits.bits.ordered.pop_front();
+    BOOST_REQUIRE(!chain_state::factory_from_data(test_state(test_checkpoints, std::move(short_bits)).to_data(), test_checkpoints, tip_hash));
+
+    auto long_versions = test_data();
+    long_versions.version.ordered.push_back(4);
+    BOOST_REQUIRE(!chain_state::factory_from_data(test_state(test_checkpoints, std::move(long_versions)).to_data(), test_checkpoints, tip_hash));
+
+    auto short_timestamps = test_data();
+    short_timestamps.timestamp.ordered.pop_front();
+    BOOST_REQUIRE(!chain_state::factory_from_data(test_state(test_checkpoints, std::move(short_timestamps)).to_data(), test_checkpoints, tip_hash));
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__factory_from_data__truncated_or_extended__null)
+{
+    auto data = test_state(test_checkpoints).to_data();
+    const data_chunk truncated(data.begin(), data.end() - 1);
+    BOOST_REQUIRE(!chain_state::factory_from_data(truncated, test_checkpoints, tip_hash));
+    data.push_back(0x00);
+    BOOST_REQUIRE(!chain_state::factory_from_data(data, test_checkpoints, tip_hash));
+}
+
+#ifdef BITPRIM_CURRENCY_BCH
+
+// The DAA as computed before cumulative windows, by summing the work of the
+// window selected by the median timestamps of its first and last three.
+static uint32_t summed_work_required(const std::vector<uint32_t>& bits,
+    const std::vector<uint32_t>& timestamps)
+{
+    typedef std::pair<size_t, uint32_t> block;
+    const auto size = bits.size();
+    const auto median = [&](size_t first)
+    {
+        std::vector<block> blocks;
+        for (auto index = first; index < first + 3; ++index)
+            blocks.emplace_back(index, timestamps[index]);
+
+        std::sort(blocks.begin(), blocks.end(), [](const block& left, const block& right)
+        {
+            return left.second < right.second;
+        });
+
+        return blocks[1];
+    };
+
+    const auto first_block = median(size - 3);
+    const auto last_block = median(size - 147);
+
+    uint256_t work = 0;
+    for (auto index = last_block.first + 1; index <= first_block.first; ++index)
+        work += header::proof(bits[index]);
+
+    work *= target_spacing_seconds;
+    int64_t timespan = first_block.second - last_block.second;
+    timespan = std::min<int64_t>(timespan, 288 * target_spacing_seconds);
+    timespan = std::max<int64_t>(timespan, 72 * target_spacing_seconds);
+    work /= timespan;
+
+    const uint256_t target = (-1 * work) / work;
+    if (target > uint256_t(compact{ retarget_proof_of_work_limit }))
+        return retarget_proof_of_work_limit;
+
+    return compact(target).normal();
+}
+
+static chain_state::data daa_data(size_t height,
+    const std::vector<uint32_t>& bits, const std::vector<uint32_t>& timestamps,
+    size_t first)
+{
+    chain_state::data values;
+    values.height = height;
+    values.hash = null_hash;
+    values.allow_collisions_hash = null_hash;
+    values.bip9_bit0_hash = null_hash;
+    values.bip9_bit1_hash = null_hash;
+    values.bits.self = bits[first + 147];
+    values.version.self = 4;
+    values.timestamp.self = timestamps[first + 147];
+    values.timestamp.retarget = timestamps[first];
+
+    for (auto index = first; index < first + 147; ++index)
+    {
+        values.bits.ordered.push_back(bits[index]);
+        values.timestamp.ordered.push_back(timestamps[index]);
+    }
+
+    return values;
+}
+
+BOOST_AUTO_TEST_CASE(chain_state__work_required__daa_window__matches_summed_work)
+{
+    static const size_t height = 600001;
+    static const auto forks = rule_fork::retarget;
+
+    // Varied difficulty and out of order timestamps, over two windows.
+    std::vector<uint32_t> bits;
+    std::vector<uint32_t> timestamps;
+    for (uint32_t index = 0; index < 149; ++index)
+    {
+        bits.push_back(0x18000000 | (0x030000 + (index * 7919) % 0x20000));
+        timestamps.push_back(1500000000 + 600 * index + (index * 4409) % 1201);
+    }
+
+    // The window of the parent state and of its child.
+    const std::vector<uint32_t> parent_bits(bits.begin(), bits.begin() + 147);
+    const std::vector<uint32_t> parent_timestamps(timestamps.begin(), timestamps.begin() + 147);
+    const std::vector<uint32_t> child_bits(bits.begin() + 1, bits.begin() + 148);
+    const std::vector<uint32_t> child_timestamps(timestamps.begin() + 1, timestamps.begin() + 148);
+
+    const chain_state parent(daa_data(height - 1, bits, timestamps, 0), {}, forks, 0, 0);
+    BOOST_REQUIRE_EQUAL(parent.work_required(), summed_work_required(parent_bits, parent_timestamps));
+
+    // The child window is derived in full on construction.
+    const chain_state child(daa_data(height, bits, timestamps, 1), {}, forks, 0, 0);
+    const auto expected = summed_work_required(child_bits, child_timestamps);
+    BOOST_REQUIRE_EQUAL(child.work_required(), expected);
+    BOOST_REQUIRE(child.work_required() != parent.work_required());
+
+    // The promoted window is derived incrementally from the parent.
+    const header next(4, null_hash, null_hash, timestamps[148], bits[148], 0);
+    const chain_state promoted(parent, next);
+    BOOST_REQUIRE_EQUAL(promoted.height(), height);
+    BOOST_REQUIRE_EQUAL(promoted.work_required(), expected);
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
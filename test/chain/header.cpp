@@ -111,6 +111,18 @@ BOOST_AUTO_TEST_CASE(header__from_data__insufficient_bytes__failure)
     BOOST_REQUIRE(!header.is_valid());
 }
 
+BOOST_AUTO_TEST_CASE(header__from_data__reused_instance__hash_updated)
+{
+    const chain::header first(10, null_hash, null_hash, 531234, 6523454, 68644);
+    const chain::header second(11, null_hash, null_hash, 531235, 6523455, 68645);
+
+    chain::header header;
+    BOOST_REQUIRE(header.from_data(first.to_data()));
+    BOOST_REQUIRE(header.hash() == bitcoin_hash(first.to_data()));
+    BOOST_REQUIRE(header.from_data(second.to_data()));
+    BOOST_REQUIRE(header.hash() == bitcoin_hash(second.to_data()));
+}
+
 BOOST_AUTO_TEST_CASE(header__factory_from_data_1__valid_input__success)
 {
     chain::header expected
@@ -431,6 +443,18 @@ BOOST_AUTO_TEST_CASE(header__is_valid_proof_of_work__hash_less_than_bits__return
     BOOST_REQUIRE(instance.is_valid_proof_of_work());
 }
 
+BOOST_AUTO_TEST_CASE(header__is_hashed__before_and_after_hash__expected)
+{
+    const chain::header instance(10u, hash_literal("abababababababababababababababababababababababababababababababab"),
+        hash_literal("fefefefefefefefefefefefefefefefefefefefefefefefefefefefefefefefe"),
+        531234u, 6523454u, 68644u);
+
+    BOOST_REQUIRE(!instance.is_hashed());
+    const auto hash = instance.hash();
+    BOOST_REQUIRE(instance.is_hashed());
+    BOOST_REQUIRE(hash == instance.hash());
+}
+
 BOOST_AUTO_TEST_CASE(header__operator_assign_equals__always__matches_equivalent)
 {
     // This must be non-const.
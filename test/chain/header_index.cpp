@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(header_index_tests)
+
+#define TEST_DIRECTORY "header_index_tests"
+
+static header::list make_chain(size_t count, uint32_t salt=0)
+{
+    header::list headers;
+    auto previous = null_hash;
+
+    for (uint32_t height = 0; height < count; ++height)
+    {
+        headers.emplace_back(1u, previous, null_hash, height, 0x1d00ffff,
+            salt + height);
+        previous = headers.back().hash();
+    }
+
+    return headers;
+}
+
+static void populate(header_index& index, const header::list& headers)
+{
+    for (const auto& header: headers)
+        BOOST_REQUIRE(index.push(header));
+}
+
+static boost::filesystem::path test_file(const std::string& name)
+{
+    boost::filesystem::create_directories(TEST_DIRECTORY);
+    return boost::filesystem::path(TEST_DIRECTORY) / name;
+}
+
+BOOST_AUTO_TEST_CASE(header_index__construct__default__empty)
+{
+    const header_index index;
+    BOOST_REQUIRE(index.empty());
+    BOOST_REQUIRE_EQUAL(index.size(), 0u);
+    BOOST_REQUIRE(index.locator().empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__linked__accessors_expected)
+{
+    const auto headers = make_chain(3);
+    header_index index;
+    populate(index, headers);
+
+    BOOST_REQUIRE_EQUAL(index.size(), 3u);
+
+    for (size_t height = 0; height < headers.size(); ++height)
+    {
+        BOOST_REQUIRE(index.hash(height) == headers[height].hash());
+        BOOST_REQUIRE(index.get(height) == headers[height]);
+        BOOST_REQUIRE(index.get(height).hash() == headers[height].hash());
+    }
+
+    BOOST_REQUIRE(index.work(0) == header::proof(0x1d00ffff));
+    BOOST_REQUIRE(index.work(2) == header::proof(0x1d00ffff) * 3);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__unlinked__false)
+{
+    const auto headers = make_chain(2);
+    header_index index;
+    BOOST_REQUIRE(index.push(headers[0]));
+    BOOST_REQUIRE(!index.push(make_chain(2, 42)[1]));
+    BOOST_REQUIRE_EQUAL(index.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__data__same_hash)
+{
+    const auto headers = make_chain(2);
+    header_index index;
+    header_index::header_data data;
+    const auto serial = headers[0].to_data();
+    std::copy(serial.begin(), serial.end(), data.begin());
+    BOOST_REQUIRE(index.push(data));
+    BOOST_REQUIRE(index.hash(0) == headers[0].hash());
+    BOOST_REQUIRE(index.push(headers[1]));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_height__many__expected)
+{
+    const auto headers = make_chain(5000);
+    header_index index;
+    populate(index, headers);
+
+    for (size_t height = 0; height < headers.size(); ++height)
+    {
+        size_t out_height;
+        BOOST_REQUIRE(index.get_height(out_height, headers[height].hash()));
+        BOOST_REQUIRE_EQUAL(out_height, height);
+    }
+
+    size_t out_height;
+    BOOST_REQUIRE(!index.get_height(out_height, null_hash));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_ancestor__expected)
+{
+    const auto headers = make_chain(100);
+    header_index index;
+    populate(index, headers);
+
+    hash_digest out_hash;
+    BOOST_REQUIRE(index.get_ancestor(out_hash, headers[50].hash(), 10));
+    BOOST_REQUIRE(out_hash == headers[10].hash());
+    BOOST_REQUIRE(index.get_ancestor(out_hash, headers[50].hash(), 50));
+    BOOST_REQUIRE(out_hash == headers[50].hash());
+    BOOST_REQUIRE(!index.get_ancestor(out_hash, headers[50].hash(), 51));
+    BOOST_REQUIRE(!index.get_ancestor(out_hash, null_hash, 0));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__locator__expected_heights)
+{
+    const auto headers = make_chain(1000);
+    header_index index;
+    populate(index, headers);
+
+    const auto heights = block::locator_heights(999);
+    const auto locator = index.locator();
+    BOOST_REQUIRE_EQUAL(locator.size(), heights.size());
+
+    for (size_t position = 0; position < heights.size(); ++position)
+        BOOST_REQUIRE(locator[position] == headers[heights[position]].hash());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__pop_above__reorganize__lookups_consistent)
+{
+    const auto headers = make_chain(3000);
+    const auto fork = make_chain(2000, 42);
+    header_index index;
+    populate(index, headers);
+    index.pop_above(0);
+
+    // Extend the genesis with a different branch.
+    for (size_t height = 1; height < fork.size(); ++height)
+    {
+        auto header = fork[height];
+        header.set_previous_block_hash(index.hash(height - 1));
+        BOOST_REQUIRE(index.push(header));
+    }
+
+    size_t out_height;
+    BOOST_REQUIRE_EQUAL(index.size(), 2000u);
+    BOOST_REQUIRE(index.get_height(out_height, headers[0].hash()));
+    BOOST_REQUIRE_EQUAL(out_height, 0u);
+
+    for (size_t height = 1; height < headers.size(); ++height)
+        BOOST_REQUIRE(!index.get_height(out_height, headers[height].hash()));
+
+    for (size_t height = 0; height < index.size(); ++height)
+    {
+        BOOST_REQUIRE(index.get_height(out_height, index.hash(height)));
+        BOOST_REQUIRE_EQUAL(out_height, height);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_index__save_load__round_trip__expected)
+{
+    const auto file = test_file("round_trip");
+    const auto headers = make_chain(500);
+    header_index index;
+    populate(index, headers);
+    BOOST_REQUIRE(index.save(file));
+
+    header_index loaded;
+    BOOST_REQUIRE(loaded.load(file));
+    BOOST_REQUIRE_EQUAL(loaded.size(), index.size());
+
+    for (size_t height = 0; height < headers.size(); ++height)
+    {
+        size_t out_height;
+        BOOST_REQUIRE(loaded.data(height) == index.data(height));
+        BOOST_REQUIRE(loaded.work(height) == index.work(height));
+        BOOST_REQUIRE(loaded.get_height(out_height, headers[height].hash()));
+        BOOST_REQUIRE_EQUAL(out_height, height);
+    }
+
+    BOOST_REQUIRE(loaded.locator() == index.locator());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__save_load__empty__empty)
+{
+    const auto file = test_file("empty");
+    BOOST_REQUIRE(header_index().save(file));
+
+    header_index loaded;
+    BOOST_REQUIRE(loaded.push(make_chain(1)[0]));
+    BOOST_REQUIRE(loaded.load(file));
+    BOOST_REQUIRE(loaded.empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__load__missing__false)
+{
+    header_index index;
+    BOOST_REQUIRE(!index.load(test_file("missing")));
+    BOOST_REQUIRE(index.empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__load__truncated__false)
+{
+    const auto file = test_file("truncated");
+    header_index index;
+    populate(index, make_chain(10));
+    BOOST_REQUIRE(index.save(file));
+    boost::filesystem::resize_file(file, boost::filesystem::file_size(file) - 1);
+
+    header_index loaded;
+    BOOST_REQUIRE(!loaded.load(file));
+    BOOST_REQUIRE(loaded.empty());
+}
+
+// Flip one byte of the file at offset.
+static void corrupt(const boost::filesystem::path& file, size_t offset)
+{
+    std::fstream stream(file.string(), std::ios::in | std::ios::out |
+        std::ios::binary);
+    stream.seekg(offset);
+    const auto byte = static_cast<char>(stream.get() ^ 0x01);
+    stream.seekp(offset);
+    stream.put(byte);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__load__corrupt_hash__false)
+{
+    static const size_t count = 10;
+    const auto file = test_file("corrupt_hash");
+    header_index index;
+    populate(index, make_chain(count));
+    BOOST_REQUIRE(index.save(file));
+
+    // Version and count prefix, then headers, then hashes.
+    corrupt(file, 12 + count * 80 + 5 * hash_size + 7);
+
+    header_index loaded;
+    BOOST_REQUIRE(!loaded.load(file));
+    BOOST_REQUIRE(loaded.empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__load__corrupt_work__false)
+{
+    static const size_t count = 10;
+    const auto file = test_file("corrupt_work");
+    header_index index;
+    populate(index, make_chain(count));
+    BOOST_REQUIRE(index.save(file));
+
+    // Version and count prefix, then headers and hashes, then works.
+    corrupt(file, 12 + count * (80 + hash_size) + 3 * hash_size + 9);
+
+    header_index loaded;
+    BOOST_REQUIRE(!loaded.load(file));
+    BOOST_REQUIRE(loaded.empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_index__save__existing__replaced_without_temporary)
+{
+    const auto file = test_file("replaced");
+    header_index index;
+    populate(index, make_chain(10));
+    BOOST_REQUIRE(index.save(file));
+    index.pop_above(4);
+    BOOST_REQUIRE(index.save(file));
+    BOOST_REQUIRE(!boost::filesystem::exists(file.string() + ".tmp"));
+
+    header_index loaded;
+    BOOST_REQUIRE(loaded.load(file));
+    BOOST_REQUIRE_EQUAL(loaded.size(), 5u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
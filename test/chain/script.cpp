@@ -117,10 +117,26 @@ transaction new_tx(const script_test& test)
     };
 }
 
-std::string test_name(const script_test& test)
+// Each data-driven test is run on both script engines.
+static const script_engine script_engines[] =
+{
+    script_engine::interpreted,
+    script_engine::compiled
+};
+
+code verify(const transaction& tx, script_engine engine, uint32_t forks)
+{
+    program::set_engine(engine);
+    const auto result = script::verify(tx, 0, forks);
+    program::set_engine(script_engine::interpreted);
+    return result;
+}
+
+std::string test_name(const script_test& test, script_engine engine)
 {
     std::stringstream out;
-    out << "input: \"" << test.input << "\" "
+    out << (engine == script_engine::compiled ? "compiled " : "")
+        << "input: \"" << test.input << "\" "
         << "prevout: \"" << test.output << "\" "
         << "("
             << test.input_sequence << ", "
@@ -408,6 +424,67 @@ BOOST_AUTO_TEST_CASE(script__pattern__17_of_17_multisig__non_standard)
     BOOST_REQUIRE(instance.pattern() == machine::script_pattern::non_standard);
 }
 
+BOOST_AUTO_TEST_CASE(script__metadata__pay_key_hash__expected)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("dup hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] equalverify checksig"));
+    const auto& metadata = instance.metadata();
+    BOOST_REQUIRE(metadata.output_pattern == machine::script_pattern::pay_key_hash);
+    BOOST_REQUIRE(metadata.input_pattern == machine::script_pattern::non_standard);
+    BOOST_REQUIRE(metadata.version == machine::script_version::unversioned);
+    BOOST_REQUIRE_EQUAL(metadata.sigops, 1u);
+    BOOST_REQUIRE_EQUAL(metadata.accurate_sigops, 1u);
+    BOOST_REQUIRE(!metadata.push_only);
+    BOOST_REQUIRE(!metadata.unspendable);
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.payload()), "88350574280395ad2c3e2ee20e322073d94e5e40");
+}
+
+BOOST_AUTO_TEST_CASE(script__metadata__multisig__accurate_sigops)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string(SCRIPT_3_OF_3_MULTISIG));
+    BOOST_REQUIRE_EQUAL(instance.sigops(false), multisig_default_sigops);
+    BOOST_REQUIRE_EQUAL(instance.sigops(true), 3u);
+    BOOST_REQUIRE(instance.payload().empty());
+}
+
+BOOST_AUTO_TEST_CASE(script__metadata__null_data__unspendable)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string(SCRIPT_RETURN));
+    BOOST_REQUIRE(instance.metadata().unspendable);
+    BOOST_REQUIRE(instance.is_unspendable());
+}
+
+BOOST_AUTO_TEST_CASE(script__metadata__sign_script_hash__embedded_sigops)
+{
+    script embedded;
+    BOOST_REQUIRE(embedded.from_string(SCRIPT_3_OF_3_MULTISIG));
+
+    script instance;
+    instance.from_operations({ { opcode::push_size_0 }, { embedded.to_data(false) } });
+    const auto& metadata = instance.metadata();
+    BOOST_REQUIRE(metadata.push_only);
+    BOOST_REQUIRE(metadata.relaxed_push);
+    BOOST_REQUIRE_EQUAL(metadata.sigops, 0u);
+    BOOST_REQUIRE_EQUAL(metadata.embedded_sigops, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(script__metadata__copy__retained)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] equal"));
+    BOOST_REQUIRE(instance.output_pattern() == machine::script_pattern::pay_script_hash);
+
+    const auto copy = instance;
+    BOOST_REQUIRE(copy.output_pattern() == machine::script_pattern::pay_script_hash);
+    BOOST_REQUIRE_EQUAL(encode_base16(copy.payload()), "88350574280395ad2c3e2ee20e322073d94e5e40");
+
+    instance.from_operations({ { opcode::return_ } });
+    BOOST_REQUIRE(instance.output_pattern() == machine::script_pattern::non_standard);
+    BOOST_REQUIRE(instance.is_unspendable());
+}
+
 // Data-driven tests.
 //------------------------------------------------------------------------------
 
@@ -415,46 +492,49 @@ BOOST_AUTO_TEST_CASE(script__pattern__17_of_17_multisig__non_standard)
 
 BOOST_AUTO_TEST_CASE(script__bip16__valid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: valid_bip16_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are valid prior to and after BIP16 activation.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip16_rule) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip16_rule) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) == error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__bip16__invalid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalid_bip16_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are invalid prior to and after BIP16 activation.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip16_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip16_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__bip16__invalidated)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalidated_bip16_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are valid prior to BIP16 activation and invalid after.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip16_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip16_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
@@ -462,46 +542,49 @@ BOOST_AUTO_TEST_CASE(script__bip16__invalidated)
 
 BOOST_AUTO_TEST_CASE(script__bip65__valid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: valid_bip65_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are valid prior to and after BIP65 activation.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip65_rule) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip65_rule) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) == error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__bip65__invalid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalid_bip65_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are invalid prior to and after BIP65 activation.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip65_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip65_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__bip65__invalidated)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalidated_bip65_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are valid prior to BIP65 activation and invalid after.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip65_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip65_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
@@ -509,46 +592,49 @@ BOOST_AUTO_TEST_CASE(script__bip65__invalidated)
 
 BOOST_AUTO_TEST_CASE(script__bip112__valid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: valid_bip112_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are valid prior to and after BIP112 activation.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip112_rule) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip112_rule) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) == error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__bip112__invalid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalid_bip112_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are invalid prior to and after BIP112 activation.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip112_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip112_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__bip112__invalidated)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalidated_bip112_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are valid prior to BIP112 activation and invalid after.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip112_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip112_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
@@ -556,33 +642,35 @@ BOOST_AUTO_TEST_CASE(script__bip112__invalidated)
 
 BOOST_AUTO_TEST_CASE(script__multisig__valid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: valid_multisig_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are always valid.
         // These are scripts potentially affected by bip66 (but should not be).
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip66_rule) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip66_rule) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) == error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__multisig__invalid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalid_multisig_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are always invalid.
         // These are scripts potentially affected by bip66 (but should not be).
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::bip66_rule) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::bip66_rule) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
     }
 }
 
@@ -590,30 +678,623 @@ BOOST_AUTO_TEST_CASE(script__multisig__invalid)
 
 BOOST_AUTO_TEST_CASE(script__context_free__valid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: valid_context_free_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are always valid.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) == error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) == error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) == error::success, name);
     }
 }
 
 BOOST_AUTO_TEST_CASE(script__context_free__invalid)
 {
+    for (const auto engine: script_engines)
     for (const auto& test: invalid_context_free_scripts)
     {
         const auto tx = new_tx(test);
-        const auto name = test_name(test);
+        const auto name = test_name(test, engine);
         BOOST_REQUIRE_MESSAGE(tx.is_valid(), name);
 
         // These are always invalid.
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::no_rules) != error::success, name);
-        BOOST_CHECK_MESSAGE(script::verify(tx, 0, rule_fork::all_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::no_rules) != error::success, name);
+        BOOST_CHECK_MESSAGE(verify(tx, engine, rule_fork::all_rules) != error::success, name);
+    }
+}
+
+// Bytecode tests.
+//------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(script__bytecode__branches__target_next_else_or_endif)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("1 if 2 if 3 else 4 endif else 5 endif"));
+    const auto& code = instance.bytecode();
+    BOOST_REQUIRE_EQUAL(code.size(), 11u);
+    BOOST_REQUIRE_EQUAL(code[1].target, 8u);
+    BOOST_REQUIRE_EQUAL(code[3].target, 5u);
+    BOOST_REQUIRE_EQUAL(code[5].target, 7u);
+    BOOST_REQUIRE_EQUAL(code[8].target, 10u);
+    BOOST_REQUIRE_EQUAL(code[0].target, bytecode::no_target);
+    BOOST_REQUIRE_EQUAL(code[10].target, bytecode::no_target);
+}
+
+BOOST_AUTO_TEST_CASE(script__bytecode__push__references_script_bytes)
+{
+    script instance;
+    BOOST_REQUIRE(instance.from_string("[0102] [03]"));
+    const auto& code = instance.bytecode();
+    BOOST_REQUIRE_EQUAL(code.size(), 2u);
+    BOOST_REQUIRE_EQUAL(code[0].size, 2u);
+    BOOST_REQUIRE_EQUAL(code[1].size, 1u);
+    BOOST_REQUIRE_EQUAL(code.data(code[0])[1], 0x02);
+    BOOST_REQUIRE_EQUAL(code.data(code[1])[0], 0x03);
+}
+
+// Template verification tests.
+//------------------------------------------------------------------------------
+
+static const uint32_t template_forks[] =
+{
+    rule_fork::no_rules,
+    rule_fork::bip16_rule,
+    rule_fork::bip66_rule,
+    rule_fork::bip16_rule | rule_fork::bip66_rule | rule_fork::bip147_rule,
+    rule_fork::all_rules
+};
+
+// Returns false if not a template, otherwise requires the program result.
+static bool template_matches_program(const transaction& tx, uint32_t index,
+    const script& prevout_script)
+{
+    auto templated = false;
+    const auto& input = tx.inputs()[index];
+
+    for (const auto forks: template_forks)
+    {
+        code result;
+        if (!script::verify_template(result, tx, index, forks, input.script(),
+            input.witness(), prevout_script))
+            continue;
+
+        templated = true;
+        const auto expected = script::verify_program(tx, index, forks,
+            input.script(), input.witness(), prevout_script, 0);
+        BOOST_REQUIRE_EQUAL(result.value(), expected.value());
+    }
+
+    return templated;
+}
+
+static transaction new_spend(const script& input_script)
+{
+    return transaction
+    {
+        1,
+        0,
+        input::list{ { output_point{ null_hash, 0 }, input_script, 0 } },
+        output::list{ { 42, script{} } }
+    };
+}
+
+// Signs the input with the secrets in order, returning the endorsements.
+static data_stack new_endorsements(const transaction& tx,
+    const script& prevout_script, const std::vector<ec_secret>& secrets)
+{
+    data_stack endorsements;
+
+    for (const auto& secret: secrets)
+    {
+        endorsement out;
+        BOOST_REQUIRE(script::create_endorsement(out, secret, prevout_script,
+            tx, 0, sighash_algorithm::all));
+        endorsements.push_back(out);
+    }
+
+    return endorsements;
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__mainnet_p2pkh_single__matches_program)
+{
+    // input 315ac7d4c26d69668129cc352851d9389b4a6868f1509c6c8b66bead11e2619f:1
+    data_chunk tx_data;
+    BOOST_REQUIRE(decode_base16(tx_data, "0100000002dc38e9359bd7da3b58386204e186d9408685f427f5e513666db735aa8a6b2169000000006a47304402205d8feeb312478e468d0b514e63e113958d7214fa572acd87079a7f0cc026fc5c02200fa76ea05bf243af6d0f9177f241caf606d01fcfd5e62d6befbca24e569e5c27032102100a1a9ca2c18932d6577c58f225580184d0e08226d41959874ac963e3c1b2feffffffffdc38e9359bd7da3b58386204e186d9408685f427f5e513666db735aa8a6b2169010000006b4830450220087ede38729e6d35e4f515505018e659222031273b7366920f393ee3ab17bc1e022100ca43164b757d1a6d1235f13200d4b5f76dd8fda4ec9fc28546b2df5b1211e8df03210275983913e60093b767e85597ca9397fb2f418e57f998d6afbbc536116085b1cbffffffff0140899500000000001976a914fcc9b36d38cf55d7d5b4ee4dddb6b2c17612f48c88ac00000000"));
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(tx_data));
+
+    data_chunk script_data;
+    BOOST_REQUIRE(decode_base16(script_data, "76a91433cef61749d11ba2adf091a5e045678177fe3a6d88ac"));
+    const auto prevout_script = script::factory_from_data(script_data, false);
+
+    BOOST_REQUIRE(template_matches_program(tx, 1, prevout_script));
+
+    code result;
+    BOOST_REQUIRE(script::verify_template(result, tx, 1, rule_fork::all_rules, tx.inputs()[1].script(), {}, prevout_script));
+    BOOST_REQUIRE_EQUAL(result.value(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__mainnet_block_290329_tx__matches_program)
+{
+    data_chunk tx_data;
+    BOOST_REQUIRE(decode_base16(tx_data, "0100000002f9cbafc519425637ba4227f8d0a0b7160b4e65168193d5af39747891de98b5b5000000006b4830450221008dd619c563e527c47d9bd53534a770b102e40faa87f61433580e04e271ef2f960220029886434e18122b53d5decd25f1f4acb2480659fea20aabd856987ba3c3907e0121022b78b756e2258af13779c1a1f37ea6800259716ca4b7f0b87610e0bf3ab52a01ffffffff42e7988254800876b69f24676b3e0205b77be476512ca4d970707dd5c60598ab00000000fd260100483045022015bd0139bcccf990a6af6ec5c1c52ed8222e03a0d51c334df139968525d2fcd20221009f9efe325476eb64c3958e4713e9eefe49bf1d820ed58d2112721b134e2a1a53034930460221008431bdfa72bc67f9d41fe72e94c88fb8f359ffa30b33c72c121c5a877d922e1002210089ef5fc22dd8bfc6bf9ffdb01a9862d27687d424d1fefbab9e9c7176844a187a014c9052483045022015bd0139bcccf990a6af6ec5c1c52ed8222e03a0d51c334df139968525d2fcd20221009f9efe325476eb64c3958e4713e9eefe49bf1d820ed58d2112721b134e2a1a5303210378d430274f8c5ec1321338151e9f27f4c676a008bdf8638d07c0b6be9ab35c71210378d430274f8c5ec1321338151e9f27f4c676a008bdf8638d07c0b6be9ab35c7153aeffffffff01a08601000000000017a914d8dacdadb7462ae15cd906f1878706d0da8660e68700000000"));
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(tx_data));
+
+    // The p2pkh prevout of input zero is implied by its public key.
+    const auto& public_key = tx.inputs()[0].script().operations()[1].data();
+    const script prevout0(script::to_pay_key_hash_pattern(bitcoin_short_hash(public_key)));
+    BOOST_REQUIRE(template_matches_program(tx, 0, prevout0));
+
+    // The p2sh embedded script of input one contains an endorsement.
+    data_chunk script_data;
+    BOOST_REQUIRE(decode_base16(script_data, "a914d8dacdadb7462ae15cd906f1878706d0da8660e687"));
+    const auto prevout1 = script::factory_from_data(script_data, false);
+    BOOST_REQUIRE(!template_matches_program(tx, 1, prevout1));
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__p2pk__matches_program)
+{
+    const ec_secret secret{ { 1 } };
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    const script prevout_script(script::to_pay_public_key_pattern(point));
+
+    auto tx = new_spend({});
+    const auto endorsements = new_endorsements(tx, prevout_script, { secret });
+    tx.inputs()[0].set_script(operation::list{ { endorsements[0] } });
+    BOOST_REQUIRE(template_matches_program(tx, 0, prevout_script));
+
+    // A trailing byte after the DER signature is lax encoding.
+    auto lax = endorsements[0];
+    lax.insert(lax.end() - 1, 0x00);
+    tx.inputs()[0].set_script(operation::list{ { lax } });
+    BOOST_REQUIRE(template_matches_program(tx, 0, prevout_script));
+
+    // The script is not signed by this key.
+    const ec_secret other{ { 2 } };
+    tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, prevout_script, { other })[0] } });
+    BOOST_REQUIRE(template_matches_program(tx, 0, prevout_script));
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__p2sh_multisig__matches_program)
+{
+    const std::vector<ec_secret> secrets{ { { 1 } }, { { 2 } }, { { 3 } } };
+    point_list points(secrets.size());
+
+    for (size_t index = 0; index < secrets.size(); ++index)
+        BOOST_REQUIRE(secret_to_public(points[index], secrets[index]));
+
+    const script embedded(script::to_pay_multisig_pattern(2, points));
+    const auto embedded_data = embedded.to_data(false);
+    const script prevout_script(script::to_pay_script_hash_pattern(bitcoin_short_hash(embedded_data)));
+
+    const auto spend = [&](const data_stack& endorsements)
+    {
+        operation::list ops{ { opcode::push_size_0 } };
+        for (const auto& endorsement: endorsements)
+            ops.emplace_back(endorsement);
+
+        ops.emplace_back(embedded_data);
+        return new_spend(ops);
+    };
+
+    auto tx = spend({});
+    const auto one_two = new_endorsements(tx, embedded, { secrets[0], secrets[1] });
+    const auto one_three = new_endorsements(tx, embedded, { secrets[0], secrets[2] });
+    const auto two_one = new_endorsements(tx, embedded, { secrets[1], secrets[0] });
+    const auto three = new_endorsements(tx, embedded, { secrets[2] });
+
+    BOOST_REQUIRE(template_matches_program(spend(one_two), 0, prevout_script));
+    BOOST_REQUIRE(template_matches_program(spend(one_three), 0, prevout_script));
+
+    // Endorsements out of key order do not verify.
+    BOOST_REQUIRE(template_matches_program(spend(two_one), 0, prevout_script));
+
+    // A corrupted signature does not verify.
+    auto corrupt = one_two;
+    corrupt[1][10] ^= 0x01;
+    BOOST_REQUIRE(template_matches_program(spend(corrupt), 0, prevout_script));
+
+    // The embedded script does not match the script hash.
+    const script other_prevout(script::to_pay_script_hash_pattern(bitcoin_short_hash(one_two[0])));
+    BOOST_REQUIRE(template_matches_program(spend(one_two), 0, other_prevout));
+
+    // The endorsement count must match the signature count of the template.
+    BOOST_REQUIRE(!template_matches_program(spend(three), 0, prevout_script));
+}
+
+// Pushes the data with the size prefix ("1", "2" or "4"), not minimally.
+static operation non_minimal_push(const data_chunk& data,
+    const std::string& prefix)
+{
+    operation op;
+    BOOST_REQUIRE(op.from_string("[" + prefix + "." + encode_base16(data) + "]"));
+    return op;
+}
+
+// Spends a p2sh multisig embedded script with the dummy and endorsements.
+static transaction new_multisig_spend(const operation& dummy,
+    const data_stack& endorsements, const data_chunk& embedded)
+{
+    operation::list ops{ dummy };
+    for (const auto& endorsement: endorsements)
+        ops.emplace_back(endorsement);
+
+    ops.emplace_back(embedded);
+    return new_spend(ops);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__non_minimal_pushes__matches_program)
+{
+    const ec_secret secret{ { 1 } };
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    const auto key = to_chunk(point);
+    const auto key_hash = to_chunk(bitcoin_short_hash(key));
+    const script p2pk(script::to_pay_public_key_pattern(point));
+    const script p2pkh(script::to_pay_key_hash_pattern(bitcoin_short_hash(key)));
+
+    auto tx = new_spend({});
+    const auto p2pk_endorsement = new_endorsements(tx, p2pk, { secret })[0];
+    const auto p2pkh_endorsement = new_endorsements(tx, p2pkh, { secret })[0];
+
+    for (const auto prefix: { "1", "2", "4" })
+    {
+        tx.inputs()[0].set_script(operation::list{ non_minimal_push(p2pk_endorsement, prefix) });
+        BOOST_REQUIRE(template_matches_program(tx, 0, p2pk));
+
+        tx.inputs()[0].set_script(operation::list{ non_minimal_push(p2pkh_endorsement, prefix), { key } });
+        BOOST_REQUIRE(template_matches_program(tx, 0, p2pkh));
+
+        tx.inputs()[0].set_script(operation::list{ { p2pkh_endorsement }, non_minimal_push(key, prefix) });
+        BOOST_REQUIRE(template_matches_program(tx, 0, p2pkh));
+
+        // The prevout pushes are not minimal, so the endorsement is of them.
+        const script p2pk_pushed(operation::list{ non_minimal_push(key, prefix), { opcode::checksig } });
+        tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, p2pk_pushed, { secret })[0] } });
+        BOOST_REQUIRE(template_matches_program(tx, 0, p2pk_pushed));
+
+        const script p2pkh_pushed(operation::list
+        {
+            { opcode::dup }, { opcode::hash160 }, non_minimal_push(key_hash, prefix),
+            { opcode::equalverify }, { opcode::checksig }
+        });
+        tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, p2pkh_pushed, { secret })[0] }, { key } });
+        BOOST_REQUIRE(template_matches_program(tx, 0, p2pkh_pushed));
     }
+
+    // Non-minimal pushes of the endorsements and the embedded script.
+    const std::vector<ec_secret> secrets{ { { 1 } }, { { 2 } } };
+    point_list points(secrets.size());
+    BOOST_REQUIRE(secret_to_public(points[0], secrets[0]));
+    BOOST_REQUIRE(secret_to_public(points[1], secrets[1]));
+    const script embedded(script::to_pay_multisig_pattern(2, points));
+    const auto embedded_data = embedded.to_data(false);
+    const script p2sh(script::to_pay_script_hash_pattern(bitcoin_short_hash(embedded_data)));
+    const auto endorsements = new_endorsements(tx, embedded, secrets);
+
+    tx = new_spend(operation::list
+    {
+        { opcode::push_size_0 },
+        non_minimal_push(endorsements[0], "1"),
+        non_minimal_push(endorsements[1], "2"),
+        non_minimal_push(embedded_data, "4")
+    });
+    BOOST_REQUIRE(template_matches_program(tx, 0, p2sh));
+
+    // A non-minimal zero dummy is left to the program.
+    const auto empty_dummy = non_minimal_push({}, "1");
+    BOOST_REQUIRE(!template_matches_program(new_multisig_spend(empty_dummy, endorsements, embedded_data), 0, p2sh));
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__uncompressed_and_hybrid_keys__matches_program)
+{
+    const ec_secret secret{ { 1 } };
+    const ec_secret other{ { 2 } };
+    ec_uncompressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+
+    // A hybrid key is uncompressed with the y parity in its prefix.
+    auto hybrid_point = point;
+    hybrid_point[0] = (point.back() & 0x01) == 0 ? 0x06 : 0x07;
+    const data_stack keys{ to_chunk(point), to_chunk(hybrid_point) };
+
+    for (const auto& key: keys)
+    {
+        const script p2pk(operation::list{ { key }, { opcode::checksig } });
+        const script p2pkh(script::to_pay_key_hash_pattern(bitcoin_short_hash(key)));
+        auto tx = new_spend({});
+
+        tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, p2pk, { secret })[0] } });
+        template_matches_program(tx, 0, p2pk);
+
+        tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, p2pk, { other })[0] } });
+        template_matches_program(tx, 0, p2pk);
+
+        tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, p2pkh, { secret })[0] }, { key } });
+        template_matches_program(tx, 0, p2pkh);
+
+        tx.inputs()[0].set_script(operation::list{ { new_endorsements(tx, p2pkh, { other })[0] }, { key } });
+        template_matches_program(tx, 0, p2pkh);
+    }
+
+    // A 2 of 3 multisig of compressed, uncompressed and hybrid keys.
+    ec_compressed compressed;
+    BOOST_REQUIRE(secret_to_public(compressed, other));
+    const script embedded(operation::list
+    {
+        { opcode::push_positive_2 }, { to_chunk(compressed) }, { keys[0] },
+        { keys[1] }, { opcode::push_positive_3 }, { opcode::checkmultisig }
+    });
+
+    const auto embedded_data = embedded.to_data(false);
+    const script p2sh(script::to_pay_script_hash_pattern(bitcoin_short_hash(embedded_data)));
+    const operation dummy{ opcode::push_size_0 };
+    auto tx = new_spend({});
+    const auto endorsements = new_endorsements(tx, embedded, { other, secret });
+    template_matches_program(new_multisig_spend(dummy, endorsements, embedded_data), 0, p2sh);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__nulldummy__matches_program)
+{
+    const std::vector<ec_secret> secrets{ { { 1 } }, { { 2 } } };
+    point_list points(secrets.size());
+    BOOST_REQUIRE(secret_to_public(points[0], secrets[0]));
+    BOOST_REQUIRE(secret_to_public(points[1], secrets[1]));
+    const script embedded(script::to_pay_multisig_pattern(1, points));
+    const auto embedded_data = embedded.to_data(false);
+    const script p2sh(script::to_pay_script_hash_pattern(bitcoin_short_hash(embedded_data)));
+    const auto endorsements = new_endorsements(new_spend({}), embedded, { secrets[1] });
+
+    const operation null_dummy{ opcode::push_size_0 };
+    BOOST_REQUIRE(template_matches_program(new_multisig_spend(null_dummy, endorsements, embedded_data), 0, p2sh));
+
+    // Non-null dummies are left to the program (bip147).
+    const operation one_dummy{ opcode::push_positive_1 };
+    const operation zero_dummy{ data_chunk{ 0x00 }, false };
+    BOOST_REQUIRE(!template_matches_program(new_multisig_spend(one_dummy, endorsements, embedded_data), 0, p2sh));
+    BOOST_REQUIRE(!template_matches_program(new_multisig_spend(zero_dummy, endorsements, embedded_data), 0, p2sh));
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__nullfail__matches_program)
+{
+    const std::vector<ec_secret> secrets{ { { 1 } }, { { 2 } } };
+    point_list points(secrets.size());
+    BOOST_REQUIRE(secret_to_public(points[0], secrets[0]));
+    BOOST_REQUIRE(secret_to_public(points[1], secrets[1]));
+
+    // A failed check with an empty endorsement or a non-empty endorsement.
+    const script p2pk(script::to_pay_public_key_pattern(points[0]));
+    auto tx = new_spend({});
+    const auto wrong = new_endorsements(tx, p2pk, { secrets[1] })[0];
+
+    tx.inputs()[0].set_script(operation::list{ { data_chunk{} } });
+    template_matches_program(tx, 0, p2pk);
+
+    tx.inputs()[0].set_script(operation::list{ { wrong } });
+    BOOST_REQUIRE(template_matches_program(tx, 0, p2pk));
+
+    const script embedded(script::to_pay_multisig_pattern(2, points));
+    const auto embedded_data = embedded.to_data(false);
+    const script p2sh(script::to_pay_script_hash_pattern(bitcoin_short_hash(embedded_data)));
+    const auto valid = new_endorsements(tx, embedded, secrets);
+    const auto swapped = new_endorsements(tx, embedded, { secrets[1], secrets[1] });
+    const operation dummy{ opcode::push_size_0 };
+
+    BOOST_REQUIRE(template_matches_program(new_multisig_spend(dummy, valid, embedded_data), 0, p2sh));
+    BOOST_REQUIRE(template_matches_program(new_multisig_spend(dummy, swapped, embedded_data), 0, p2sh));
+    template_matches_program(new_multisig_spend(dummy, { valid[0], {} }, embedded_data), 0, p2sh);
+    template_matches_program(new_multisig_spend(dummy, { {}, {} }, embedded_data), 0, p2sh);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_template__multisig_counts__matches_program)
+{
+    static const auto forks = rule_fork::bip16_rule | rule_fork::bip66_rule |
+        rule_fork::bip147_rule;
+
+    std::vector<ec_secret> secrets(17);
+    data_stack keys(secrets.size());
+
+    for (size_t index = 0; index < secrets.size(); ++index)
+    {
+        ec_compressed point;
+        secrets[index] = ec_secret{ { static_cast<uint8_t>(index + 1) } };
+        BOOST_REQUIRE(secret_to_public(point, secrets[index]));
+        keys[index] = to_chunk(point);
+    }
+
+    const operation dummy{ opcode::push_size_0 };
+
+    // Returns the template result if templated, otherwise the program result.
+    const auto verify = [&](const operation::list& embedded_ops,
+        const std::vector<ec_secret>& signers)
+    {
+        const script embedded(embedded_ops);
+        const auto embedded_data = embedded.to_data(false);
+        const script p2sh(script::to_pay_script_hash_pattern(bitcoin_short_hash(embedded_data)));
+        const auto endorsements = new_endorsements(new_spend({}), embedded, signers);
+        const auto tx = new_multisig_spend(dummy, endorsements, embedded_data);
+        const auto& input = tx.inputs()[0];
+
+        BOOST_REQUIRE(!template_matches_program(tx, 0, p2sh));
+        return script::verify(tx, 0, forks, input.script(), input.witness(), p2sh, 0).value();
+    };
+
+    // m = 0 of n = 1.
+    BOOST_REQUIRE_EQUAL(verify(operation::list
+    {
+        { opcode::push_size_0 }, { keys[0] }, { opcode::push_positive_1 }, { opcode::checkmultisig }
+    }, {}), error::success);
+
+    // m = 2 of n = 3, both counts pushed as data.
+    BOOST_REQUIRE_EQUAL(verify(operation::list
+    {
+        { data_chunk{ 0x02 }, false }, { keys[0] }, { keys[1] }, { keys[2] },
+        { data_chunk{ 0x03 }, false }, { opcode::checkmultisig }
+    }, { secrets[0], secrets[2] }), error::success);
+
+    // m = 1 of n = 17, so n is pushed as data. The script exceeds the push
+    // size limit of an embedded script, so it is spent as a bare multisig.
+    operation::list prevout_ops{ { opcode::push_positive_1 } };
+    for (const auto& key: keys)
+        prevout_ops.emplace_back(key);
+
+    prevout_ops.emplace_back(data_chunk{ 0x11 }, false);
+    prevout_ops.emplace_back(opcode::checkmultisig);
+    const script prevout_script(prevout_ops);
+
+    auto tx = new_spend({});
+    const auto endorsements = new_endorsements(tx, prevout_script, { secrets[16] });
+    tx.inputs()[0].set_script(operation::list{ dummy, { endorsements[0] } });
+    const auto& input = tx.inputs()[0];
+
+    BOOST_REQUIRE(!template_matches_program(tx, 0, prevout_script));
+    BOOST_REQUIRE_EQUAL(script::verify(tx, 0, forks, input.script(), input.witness(), prevout_script, 0).value(), error::success);
+}
+
+// Deferred signature tests.
+//------------------------------------------------------------------------------
+
+static transaction new_spends(size_t count)
+{
+    input::list inputs;
+
+    for (uint32_t index = 0; index < count; ++index)
+        inputs.push_back({ output_point{ null_hash, index }, script{}, 0 });
+
+    return transaction{ 1, 0, std::move(inputs), output::list{ { 42, script{} } } };
+}
+
+static endorsement new_endorsement(const transaction& tx, uint32_t index,
+    const script& prevout_script, const ec_secret& secret)
+{
+    endorsement out;
+    BOOST_REQUIRE(script::create_endorsement(out, secret, prevout_script, tx,
+        index, sighash_algorithm::all));
+    return out;
+}
+
+static code verify_spend(const transaction& tx, uint32_t index,
+    const script& prevout_script)
+{
+    const auto& input = tx.inputs()[index];
+    return script::verify_program(tx, index, rule_fork::bip66_rule,
+        input.script(), input.witness(), prevout_script, 0);
+}
+
+// Returns the index of the first input that fails, or the input count.
+static uint32_t first_failure(code& ec, const transaction& tx,
+    const script& prevout_script)
+{
+    const auto count = static_cast<uint32_t>(tx.inputs().size());
+
+    for (uint32_t index = 0; index < count; ++index)
+        if ((ec = verify_spend(tx, index, prevout_script)))
+            return index;
+
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_program__deferred_checksigverify__success)
+{
+    const ec_secret secret{ { 1 } };
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    const script prevout_script(operation::list
+    {
+        { to_chunk(point) }, { opcode::checksigverify }, { opcode::push_positive_1 }
+    });
+
+    auto tx = new_spends(2);
+    const auto endorsement0 = new_endorsement(tx, 0, prevout_script, secret);
+    const auto endorsement1 = new_endorsement(tx, 1, prevout_script, secret);
+    tx.inputs()[0].set_script(operation::list{ { endorsement0 } });
+    tx.inputs()[1].set_script(operation::list{ { endorsement1 } });
+
+    code ec;
+    BOOST_REQUIRE_EQUAL(first_failure(ec, tx, prevout_script), 2u);
+    BOOST_REQUIRE_EQUAL(ec.value(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_program__deferred_checksigverify_wrong_key__incorrect_signature_at_input)
+{
+    const ec_secret secret{ { 1 } };
+    const ec_secret other{ { 2 } };
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    const script prevout_script(operation::list
+    {
+        { to_chunk(point) }, { opcode::checksigverify }, { opcode::push_positive_1 }
+    });
+
+    // Input one is signed by a key other than the one the script checks.
+    auto tx = new_spends(3);
+    const auto endorsement0 = new_endorsement(tx, 0, prevout_script, secret);
+    const auto endorsement1 = new_endorsement(tx, 1, prevout_script, other);
+    const auto endorsement2 = new_endorsement(tx, 2, prevout_script, secret);
+    tx.inputs()[0].set_script(operation::list{ { endorsement0 } });
+    tx.inputs()[1].set_script(operation::list{ { endorsement1 } });
+    tx.inputs()[2].set_script(operation::list{ { endorsement2 } });
+
+    code ec;
+    BOOST_REQUIRE_EQUAL(first_failure(ec, tx, prevout_script), 1u);
+    BOOST_REQUIRE_EQUAL(ec.value(), error::incorrect_signature);
+    BOOST_REQUIRE_EQUAL(verify_spend(tx, 2, prevout_script).value(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_program__deferred_and_immediate_checksig__expected)
+{
+    const ec_secret secret{ { 1 } };
+    const ec_secret other{ { 2 } };
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    const auto key = to_chunk(point);
+
+    // The checksigverify is deferred, the checksig is evaluated immediately.
+    const script prevout_script(operation::list
+    {
+        { key }, { opcode::checksigverify }, { key }, { opcode::checksig }
+    });
+
+    auto tx = new_spends(1);
+    const auto valid = new_endorsement(tx, 0, prevout_script, secret);
+    const auto invalid = new_endorsement(tx, 0, prevout_script, other);
+
+    // The checksig endorsement is pushed first, so is consumed last.
+    const auto spend = [&](const endorsement& deferred,
+        const endorsement& immediate)
+    {
+        tx.inputs()[0].set_script(operation::list{ { immediate }, { deferred } });
+        return verify_spend(tx, 0, prevout_script).value();
+    };
+
+    BOOST_REQUIRE_EQUAL(spend(valid, valid), error::success);
+    BOOST_REQUIRE_EQUAL(spend(invalid, valid), error::incorrect_signature);
+    BOOST_REQUIRE_EQUAL(spend(valid, invalid), error::stack_false);
+    BOOST_REQUIRE_EQUAL(spend(invalid, invalid), error::stack_false);
+}
+
+BOOST_AUTO_TEST_CASE(script__verify_program__deferred_checksigverify_then_stack_false__stack_false)
+{
+    const ec_secret secret{ { 1 } };
+    const ec_secret other{ { 2 } };
+    ec_compressed point;
+    BOOST_REQUIRE(secret_to_public(point, secret));
+    const script prevout_script(operation::list
+    {
+        { to_chunk(point) }, { opcode::checksigverify }, { opcode::push_size_0 }
+    });
+
+    auto tx = new_spends(1);
+    tx.inputs()[0].set_script(operation::list{ { new_endorsement(tx, 0, prevout_script, other) } });
+
+    // Evaluated in place the checksigverify would fail with incorrect_signature,
+    // but deferred signatures are verified after all other script rules.
+    BOOST_REQUIRE_EQUAL(verify_spend(tx, 0, prevout_script).value(), error::stack_false);
 }
 
 // Checksig tests.
@@ -735,6 +1416,103 @@ BOOST_AUTO_TEST_CASE(script__generate_signature_hash__all__expected)
     BOOST_REQUIRE_EQUAL(result, expected);
 }
 
+// Serialize the modified transaction as the unversioned algorithm defines it.
+static hash_digest rebuilt_signature_hash(const transaction& tx,
+    uint32_t input_index, const script& script_code, uint8_t sighash_type)
+{
+    const auto algorithm = sighash_type & sighash_algorithm::mask;
+    const auto single = algorithm == sighash_algorithm::single;
+    const auto none = algorithm == sighash_algorithm::none;
+    const auto any = (sighash_type & sighash_algorithm::anyone_can_pay) != 0;
+
+    if (input_index >= tx.inputs().size() ||
+        (single && input_index >= tx.outputs().size()))
+        return hash_literal("0000000000000000000000000000000000000000000000000000000000000001");
+
+    operation::list ops;
+    for (const auto& op: script_code)
+        if (op.code() != opcode::codeseparator)
+            ops.push_back(op);
+
+    const script stripped(std::move(ops));
+    const auto& self = tx.inputs()[input_index];
+    input::list ins;
+
+    if (any)
+        ins.emplace_back(self.previous_output(), stripped, self.sequence());
+    else
+        for (const auto& input: tx.inputs())
+            ins.emplace_back(input.previous_output(),
+                &input == &self ? stripped : script{},
+                &input == &self || !(single || none) ? input.sequence() : 0);
+
+    output::list outs;
+    if (single)
+    {
+        outs.resize(input_index + 1);
+        outs.back() = tx.outputs()[input_index];
+    }
+    else if (!none)
+    {
+        outs = tx.outputs();
+    }
+
+    const transaction out(tx.version(), tx.locktime(), ins, outs);
+    auto serialized = out.to_data(true, false);
+    extend_data(serialized, to_little_endian<uint32_t>(sighash_type));
+    return bitcoin_hash(serialized);
+}
+
+BOOST_AUTO_TEST_CASE(script__generate_signature_hash__unversioned_all_types__matches_rebuilt_transaction)
+{
+    input::list inputs;
+    for (uint32_t index = 0; index < 5; ++index)
+    {
+        const hash_digest hash{ { static_cast<uint8_t>(index + 1) } };
+        inputs.emplace_back(output_point{ hash, index * 3 },
+            script{ script::to_null_data_pattern(to_chunk(hash)) },
+            0xfffffff0 + index);
+    }
+
+    output::list outputs;
+    for (uint32_t index = 0; index < 3; ++index)
+        outputs.emplace_back(1000 * (index + 1),
+            script{ script::to_pay_key_hash_pattern(short_hash{ { static_cast<uint8_t>(index) } }) });
+
+    const transaction tx(1, 42, inputs, outputs);
+
+    script script_code;
+    BOOST_REQUIRE(script_code.from_string("dup codeseparator hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] equalverify checksig"));
+
+    for (size_t type = 0; type <= max_uint8; ++type)
+    {
+        for (uint32_t index = 0; index <= inputs.size(); ++index)
+        {
+            const auto sighash_type = static_cast<uint8_t>(type);
+            const auto expected = rebuilt_signature_hash(tx, index, script_code, sighash_type);
+            const auto sighash = script::generate_signature_hash(tx, index, script_code, sighash_type);
+            BOOST_REQUIRE_EQUAL(encode_base16(sighash), encode_base16(expected));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(script__generate_signature_hash__outputs_changed__context_refreshed)
+{
+    data_chunk tx_data;
+    decode_base16(tx_data, "0100000001b3807042c92f449bbf79b33ca59d7dfec7f4cc71096704a9c526dddf496ee0970000000000ffffffff0000000000");
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(tx_data));
+
+    script prevout_script;
+    BOOST_REQUIRE(prevout_script.from_string("dup hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] equalverify checksig"));
+
+    const auto before = script::generate_signature_hash(tx, 0, prevout_script, sighash_algorithm::all);
+    tx.set_outputs(output::list{ { 1, script{} } });
+    const auto after = script::generate_signature_hash(tx, 0, prevout_script, sighash_algorithm::all);
+    BOOST_REQUIRE(before != after);
+    BOOST_REQUIRE_EQUAL(encode_base16(after), encode_base16(rebuilt_signature_hash(tx, 0, prevout_script, sighash_algorithm::all)));
+}
+
 // Ad-hoc test cases.
 //-----------------------------------------------------------------------------
 
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+BOOST_AUTO_TEST_SUITE(script_cache_tests)
+
+#define PREVOUT_SCRIPT "a914faa558780a5767f9e3be14992a578fc1cbcf483087"
+#define TRANSACTION "0100000001a06bf74cc36eac395188b06850c5a01d00b355065c589d14036e89e075d7518e000000009d483045022100ba555ac17a084e2a1b621c2171fa563bc4fb75cd5c0968153f44ba7203cb876f022036626f4579de16e3ad160df01f649ffb8dbf47b504ee56dc3ad7260af24ca0db0101004c50632102768e47607c52e581595711e27faffa7cb646b4f481fe269bd49691b2fbc12106ad6704355e2658b1756821028a5af8284a12848d69a25a0ac5cea20be905848eb645fd03d3b065df88a9117cacfeffffff0158920100000000001976a9149d86f66406d316d44d58cbf90d71179dd8162dd388ac355e2658"
+
+static const uint32_t forks = 62;
+
+static transaction make_transaction(uint64_t value)
+{
+    data_chunk decoded_tx;
+    BOOST_REQUIRE(decode_base16(decoded_tx, TRANSACTION));
+
+    data_chunk decoded_script;
+    BOOST_REQUIRE(decode_base16(decoded_script, PREVOUT_SCRIPT));
+
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(decoded_tx));
+
+    auto& prevout = tx.inputs()[0].previous_output().validation.cache;
+    prevout.set_script(script::factory_from_data(decoded_script, false));
+    prevout.set_value(value);
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__empty__false_and_miss)
+{
+    script_cache instance;
+    const auto tx = make_transaction(42);
+    BOOST_REQUIRE(!instance.contains(tx, 0, forks));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__stored__true_and_hit)
+{
+    script_cache instance;
+    const auto tx = make_transaction(42);
+    instance.store(tx, 0, forks);
+    BOOST_REQUIRE(instance.contains(tx, 0, forks));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__different_forks__false)
+{
+    script_cache instance;
+    const auto tx = make_transaction(42);
+    instance.store(tx, 0, forks);
+    BOOST_REQUIRE(!instance.contains(tx, 0, forks | machine::rule_fork::bip112_rule));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__contains__different_prevout_value__false)
+{
+    script_cache instance;
+    instance.store(make_transaction(42), 0, forks);
+    BOOST_REQUIRE(!instance.contains(make_transaction(43), 0, forks));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__clear__stored__false)
+{
+    script_cache instance;
+    const auto tx = make_transaction(42);
+    instance.store(tx, 0, forks);
+    instance.clear();
+    BOOST_REQUIRE(!instance.contains(tx, 0, forks));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
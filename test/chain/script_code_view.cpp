@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+
+BOOST_AUTO_TEST_SUITE(script_code_view_tests)
+
+#define TRANSACTION "0100000001b3807042c92f449bbf79b33ca59d7dfec7f4cc71096704a9c526dddf496ee0970000000000ffffffff0000000000"
+
+static script make_script(const std::string& mnemonic)
+{
+    script out;
+    BOOST_REQUIRE(out.from_string(mnemonic));
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__constructor__default__empty)
+{
+    const script_code_view instance;
+    BOOST_REQUIRE(instance.data().empty());
+    BOOST_REQUIRE_EQUAL(instance.separators(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(true), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__constructor__script__views_script_bytes)
+{
+    const auto value = make_script("dup hash160 [0102030405] equalverify checksig");
+    const script_code_view instance(value);
+    BOOST_REQUIRE(instance.to_data(true) == value.to_data(true));
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(true), value.serialized_size(true));
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__constructor__offset__views_script_tail)
+{
+    const auto value = make_script("[0102] codeseparator dup checksig");
+    const auto expected = make_script("dup checksig");
+
+    // The push is three bytes, the separator one.
+    const script_code_view instance(value, 4);
+    BOOST_REQUIRE(instance.to_data(false) == expected.to_data(false));
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__to_data__without_separators__stripped)
+{
+    const auto value = make_script("codeseparator [ab] codeseparator dup codeseparator");
+    const auto expected = make_script("[ab] dup");
+    const script_code_view instance(value);
+    BOOST_REQUIRE_EQUAL(instance.separators(), 3u);
+    BOOST_REQUIRE(instance.to_data(false) == value.to_data(false));
+    BOOST_REQUIRE(instance.to_data(true, false) == expected.to_data(true));
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(true, false), expected.serialized_size(true));
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__find_and_delete__not_found__unchanged)
+{
+    const auto value = make_script("[0102] dup checksig");
+    script_code_view instance(value);
+    instance.find_and_delete(data_chunk{ 0x01 });
+    instance.find_and_delete(data_chunk{ 0x02 });
+    BOOST_REQUIRE(instance.to_data(false) == value.to_data(false));
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__find_and_delete__found__deleted_without_changing_script)
+{
+    const auto value = make_script("[0102] dup [0102] [0102] checksig [0102]");
+    const auto expected = make_script("dup checksig");
+    const auto original = value.to_data(false);
+
+    script_code_view instance(value);
+    instance.find_and_delete(data_chunk{ 0x01, 0x02 });
+    BOOST_REQUIRE(instance.to_data(false) == expected.to_data(false));
+    BOOST_REQUIRE(value.to_data(false) == original);
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__find_and_delete__non_minimal_push__not_deleted)
+{
+    // A value is matched only by its nominal (single byte size) push.
+    const auto value = make_script("[1.0102] dup");
+    script_code_view instance(value);
+    instance.find_and_delete(data_chunk{ 0x01, 0x02 });
+    BOOST_REQUIRE(instance.to_data(false) == value.to_data(false));
+}
+
+// Expected bytes are those of the baseline stream based script::find_and_delete.
+BOOST_AUTO_TEST_CASE(script_code_view__find_and_delete__stack__expected_bytes)
+{
+    const data_stack endorsements{ { 0xaa, 0xbb }, { 0xcc } };
+    auto value = make_script("[aabb] codeseparator [cc] [aabb] dup [cc] checksig");
+    BOOST_REQUIRE_EQUAL(encode_base16(value.to_data(false)), "02aabbab01cc02aabb7601ccac");
+
+    script_code_view instance(value);
+    instance.find_and_delete(endorsements);
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.to_data(false)), "ab76ac");
+    BOOST_REQUIRE_EQUAL(instance.separators(), 1u);
+
+    value.find_and_delete(endorsements);
+    BOOST_REQUIRE_EQUAL(encode_base16(value.to_data(false)), "ab76ac");
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__find_and_delete__within_push__expected_bytes)
+{
+    // The value is matched only at operation boundaries, not within a push.
+    const auto value = make_script("[02aabb] [aabb] [aabb02aabb]");
+    BOOST_REQUIRE_EQUAL(encode_base16(value.to_data(false)), "0302aabb02aabb05aabb02aabb");
+
+    script_code_view instance(value);
+    instance.find_and_delete(data_chunk{ 0xaa, 0xbb });
+    BOOST_REQUIRE_EQUAL(encode_base16(instance.to_data(false)), "0302aabb05aabb02aabb");
+}
+
+BOOST_AUTO_TEST_CASE(script_code_view__generate_signature_hash__separators__matches_stripped_script)
+{
+    data_chunk decoded_tx;
+    BOOST_REQUIRE(decode_base16(decoded_tx, TRANSACTION));
+    transaction tx;
+    BOOST_REQUIRE(tx.from_data(decoded_tx));
+
+    const auto value = make_script("dup hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] codeseparator equalverify checksig");
+    const auto stripped = make_script("dup hash160 [88350574280395ad2c3e2ee20e322073d94e5e40] equalverify checksig");
+
+    const script_code_view instance(value);
+    const auto sighash = script::generate_signature_hash(tx, 0, instance, sighash_algorithm::all);
+    BOOST_REQUIRE(sighash == script::generate_signature_hash(tx, 0, stripped, sighash_algorithm::all));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -610,6 +610,76 @@ BOOST_AUTO_TEST_CASE(transaction__factory_data_3__case_2__success)
     BOOST_REQUIRE(resave == raw_tx);
 }
 
+BOOST_AUTO_TEST_CASE(transaction__from_data__deserializer__matches_reader)
+{
+    static const data_chunk raw_tx = to_chunk(base16_literal(TX4));
+
+    auto deserial = make_safe_deserializer(raw_tx.begin(), raw_tx.end());
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(deserial));
+    BOOST_REQUIRE(deserial.is_exhausted());
+
+    data_source stream(raw_tx);
+    istream_reader source(stream);
+    chain::transaction expected;
+    BOOST_REQUIRE(expected.from_data(static_cast<reader&>(source)));
+    BOOST_REQUIRE(tx == expected);
+    BOOST_REQUIRE(tx.hash() == hash_literal(TX4_HASH));
+}
+
+BOOST_AUTO_TEST_CASE(transaction__from_data__consecutive_deserializer__hashes_each_span)
+{
+    const auto raw_tx1 = to_chunk(base16_literal(TX1));
+    const auto raw_tx4 = to_chunk(base16_literal(TX4));
+    const auto raw = build_chunk({ raw_tx1, raw_tx4 });
+
+    // Reuse one instance to also cover replacement of the prior hash.
+    auto deserial = make_safe_deserializer(raw.begin(), raw.end());
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(deserial));
+    BOOST_REQUIRE(tx.hash() == hash_literal(TX1_HASH));
+    BOOST_REQUIRE(tx.from_data(deserial));
+    BOOST_REQUIRE(deserial.is_exhausted());
+    BOOST_REQUIRE(tx.hash() == hash_literal(TX4_HASH));
+    BOOST_REQUIRE(tx.hash() == bitcoin_hash(tx.to_data()));
+}
+
+BOOST_AUTO_TEST_CASE(transaction__from_data__non_minimal_input_count__hashes_canonical)
+{
+    // TX1 with its input count (01) encoded as the non-minimal fd0100.
+    auto raw_tx = to_chunk(base16_literal(TX1));
+    BOOST_REQUIRE_EQUAL(raw_tx[4], 0x01);
+    raw_tx[4] = 0xfd;
+    raw_tx.insert(raw_tx.begin() + 5, { 0x01, 0x00 });
+
+    auto deserial = make_safe_deserializer(raw_tx.begin(), raw_tx.end());
+    chain::transaction tx;
+    BOOST_REQUIRE(tx.from_data(deserial));
+    BOOST_REQUIRE(deserial.is_exhausted());
+    BOOST_REQUIRE_EQUAL(tx.serialized_size(), raw_tx.size() - 2u);
+    BOOST_REQUIRE(tx.hash() == hash_literal(TX1_HASH));
+    BOOST_REQUIRE(tx.hash() == bitcoin_hash(tx.to_data()));
+    BOOST_REQUIRE(tx.hash() != bitcoin_hash(raw_tx));
+}
+
+BOOST_AUTO_TEST_CASE(transaction__to_data__serializer__matches_writer)
+{
+    static const data_chunk raw_tx = to_chunk(base16_literal(TX4));
+    const auto tx = chain::transaction::factory_from_data(raw_tx);
+
+    data_chunk resave(raw_tx.size());
+    auto serial = make_unsafe_serializer(resave.begin());
+    tx.to_data(serial);
+    BOOST_REQUIRE(resave == raw_tx);
+
+    data_chunk expected;
+    data_sink stream(expected);
+    ostream_writer sink(stream);
+    tx.to_data(static_cast<writer&>(sink));
+    stream.flush();
+    BOOST_REQUIRE(expected == raw_tx);
+}
+
 BOOST_AUTO_TEST_CASE(transaction__version__roundtrip__success)
 {
     uint32_t version = 1254u;
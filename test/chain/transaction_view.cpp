@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(transaction_view_tests)
+
+#define TX1 \
+"0100000001f08e44a96bfb5ae63eda1a6620adae37ee37ee4777fb0336e1bbbc" \
+"4de65310fc010000006a473044022050d8368cacf9bf1b8fb1f7cfd9aff63294" \
+"789eb1760139e7ef41f083726dadc4022067796354aba8f2e02363c5e510aa7e" \
+"2830b115472fb31de67d16972867f13945012103e589480b2f746381fca01a9b" \
+"12c517b7a482a203c8b2742985da0ac72cc078f2ffffffff02f0c9c467000000" \
+"001976a914d9d78e26df4e4601cf9b26d09c7b280ee764469f88ac80c4600f00" \
+"0000001976a9141ee32412020a324b93b1a1acfdfff6ab9ca8fac288ac000000" \
+"00"
+
+#define TX1_HASH \
+"bf7c3f5a69a78edd81f3eff7e93a37fb2d7da394d48db4d85e7e5353b9b8e270"
+
+BOOST_AUTO_TEST_CASE(transaction_view__constructor__empty__invalid)
+{
+    const data_chunk data;
+    const chain::transaction_view instance(data);
+    BOOST_REQUIRE(!instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(), 0u);
+    BOOST_REQUIRE_EQUAL(chain::transaction_view::serialized_size(data), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_view__constructor__valid__matches_transaction)
+{
+    const auto raw_tx = to_chunk(base16_literal(TX1));
+    chain::transaction expected;
+    BOOST_REQUIRE(expected.from_data(raw_tx));
+
+    const chain::transaction_view instance(raw_tx);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(!instance.is_segregated());
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(), raw_tx.size());
+    BOOST_REQUIRE_EQUAL(chain::transaction_view::serialized_size(raw_tx), raw_tx.size());
+    BOOST_REQUIRE_EQUAL(instance.version(), expected.version());
+    BOOST_REQUIRE_EQUAL(instance.locktime(), expected.locktime());
+    BOOST_REQUIRE_EQUAL(instance.inputs().size(), expected.inputs().size());
+    BOOST_REQUIRE_EQUAL(instance.outputs().size(), expected.outputs().size());
+
+    const auto& input = instance.inputs().front();
+    const auto& prevout = expected.inputs().front().previous_output();
+    BOOST_REQUIRE(input.previous_output_hash() == prevout.hash());
+    BOOST_REQUIRE_EQUAL(input.previous_output_index(), prevout.index());
+    BOOST_REQUIRE_EQUAL(input.sequence, expected.inputs().front().sequence());
+    BOOST_REQUIRE(to_chunk(input.script) == expected.inputs().front().script().to_data(false));
+    BOOST_REQUIRE(input.witness.empty());
+
+    for (size_t index = 0; index < expected.outputs().size(); ++index)
+    {
+        const auto& output = instance.outputs()[index];
+        BOOST_REQUIRE_EQUAL(output.value, expected.outputs()[index].value());
+        BOOST_REQUIRE(to_chunk(output.script) == expected.outputs()[index].script().to_data(false));
+    }
+
+    BOOST_REQUIRE(instance.hash() == hash_literal(TX1_HASH));
+    BOOST_REQUIRE(instance.to_transaction() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_view__constructor__trailing_bytes__excluded)
+{
+    auto raw_tx = to_chunk(base16_literal(TX1));
+    const auto size = raw_tx.size();
+    raw_tx.push_back(0x42);
+
+    const chain::transaction_view instance(raw_tx);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(), size);
+    BOOST_REQUIRE_EQUAL(instance.data().size(), size);
+    BOOST_REQUIRE(instance.hash() == hash_literal(TX1_HASH));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_view__constructor__truncated__invalid)
+{
+    const auto raw_tx = to_chunk(base16_literal(TX1));
+
+    for (size_t size = 0; size < raw_tx.size(); ++size)
+    {
+        const data_slice truncated(raw_tx.data(), raw_tx.data() + size);
+        BOOST_REQUIRE(!chain::transaction_view(truncated).is_valid());
+        BOOST_REQUIRE_EQUAL(chain::transaction_view::serialized_size(truncated), 0u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transaction_view__inputs_outputs__concurrent__mapped_once)
+{
+    const auto raw_tx = to_chunk(base16_literal(TX1));
+    const chain::transaction_view instance(raw_tx);
+    std::vector<const chain::transaction_view::input_view::list*> inputs(4);
+    std::vector<const chain::transaction_view::output_view::list*> outputs(4);
+    std::vector<std::thread> threads;
+
+    for (size_t index = 0; index < inputs.size(); ++index)
+    {
+        threads.emplace_back([&, index]()
+        {
+            inputs[index] = &instance.inputs();
+            outputs[index] = &instance.outputs();
+        });
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    for (size_t index = 0; index < inputs.size(); ++index)
+    {
+        BOOST_REQUIRE(inputs[index] == &instance.inputs());
+        BOOST_REQUIRE(outputs[index] == &instance.outputs());
+    }
+
+    BOOST_REQUIRE_EQUAL(instance.inputs().size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.outputs().size(), 2u);
+}
+
+#ifndef BITPRIM_CURRENCY_BCH
+BOOST_AUTO_TEST_CASE(transaction_view__constructor__segregated__hash_excludes_witness)
+{
+    chain::transaction expected;
+    BOOST_REQUIRE(expected.from_data(to_chunk(base16_literal(TX1))));
+    expected.inputs().front().set_witness(chain::witness(data_stack{ { 0x01, 0x02 }, {} }));
+    const auto raw_tx = expected.to_data(true, true);
+
+    const chain::transaction_view instance(raw_tx);
+    BOOST_REQUIRE(instance.is_valid());
+    BOOST_REQUIRE(instance.is_segregated());
+    BOOST_REQUIRE_EQUAL(instance.serialized_size(), raw_tx.size());
+    BOOST_REQUIRE(to_chunk(instance.inputs().front().witness) ==
+        expected.inputs().front().witness().to_data(true));
+    BOOST_REQUIRE(instance.hash() == hash_literal(TX1_HASH));
+    BOOST_REQUIRE(instance.to_transaction(true) == expected);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
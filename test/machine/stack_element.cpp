@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::machine;
+
+BOOST_AUTO_TEST_SUITE(stack_element_tests)
+
+BOOST_AUTO_TEST_CASE(stack_element__inline_and_extended__round_trips)
+{
+    const data_chunk small(stack_element::inline_size, 0x42);
+    const data_chunk large(stack_element::inline_size + 1, 0x24);
+    const stack_element inline_item(small);
+    const stack_element extended_item(large);
+    BOOST_REQUIRE_EQUAL(inline_item.size(), small.size());
+    BOOST_REQUIRE_EQUAL(extended_item.size(), large.size());
+    BOOST_REQUIRE(data_chunk(inline_item) == small);
+    BOOST_REQUIRE(data_chunk(extended_item) == large);
+    BOOST_REQUIRE(inline_item != extended_item);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__move__source_empty)
+{
+    const data_chunk large(stack_element::inline_size * 2, 0x24);
+    stack_element source(large);
+    const stack_element moved(std::move(source));
+    BOOST_REQUIRE(source.empty());
+    BOOST_REQUIRE(data_chunk(moved) == large);
+
+    stack_element assigned{ 0x01, 0x02 };
+    BOOST_REQUIRE_EQUAL(assigned.size(), 2u);
+    assigned = stack_element(large);
+    BOOST_REQUIRE(assigned == moved);
+}
+
+BOOST_AUTO_TEST_CASE(stack_element__hash__equals_chunk)
+{
+    const auto hash = bitcoin_short_hash(data_chunk{ 0x2a });
+    const stack_element item(hash);
+    BOOST_REQUIRE_EQUAL(item.size(), short_hash_size);
+    BOOST_REQUIRE(data_chunk(item) == to_chunk(hash));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
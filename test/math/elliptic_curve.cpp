@@ -128,6 +128,70 @@ BOOST_AUTO_TEST_CASE(elliptic_curve__verify_signature__negative__test)
     BOOST_REQUIRE(!verify_signature(point, sighash, signature));
 }
 
+static ec_verification::list batch_of_three()
+{
+    ec_signature signature;
+    der_signature distinguished;
+    BOOST_REQUIRE(decode_base16(distinguished, SIGNATURE2));
+    BOOST_REQUIRE(parse_signature(signature, distinguished, false));
+    const auto point = to_chunk(base16_literal(COMPRESSED2));
+    const ec_verification item{ point, hash_literal(SIGHASH2), signature };
+    return { item, item, item };
+}
+
+BOOST_AUTO_TEST_CASE(elliptic_curve__verify_signatures__valid__all_true)
+{
+    std::vector<bool> out;
+    BOOST_REQUIRE(verify_signatures(out, batch_of_three()));
+    BOOST_REQUIRE_EQUAL(out.size(), 3u);
+    BOOST_REQUIRE(out[0] && out[1] && out[2]);
+}
+
+BOOST_AUTO_TEST_CASE(elliptic_curve__verify_signatures__invalid__expected_flags)
+{
+    auto batch = batch_of_three();
+    batch[1].signature[10] = 110;
+    batch[2].point.clear();
+
+    std::vector<bool> out;
+    BOOST_REQUIRE(!verify_signatures(out, batch));
+    BOOST_REQUIRE_EQUAL(out.size(), 3u);
+    BOOST_REQUIRE(out[0]);
+    BOOST_REQUIRE(!out[1]);
+    BOOST_REQUIRE(!out[2]);
+}
+
+BOOST_AUTO_TEST_CASE(elliptic_curve__verify_signatures__first_failure__expected_index)
+{
+    auto batch = batch_of_three();
+    BOOST_REQUIRE_EQUAL(verify_signatures(batch), 3u);
+
+    batch[2].hash[0] = 0;
+    BOOST_REQUIRE_EQUAL(verify_signatures(batch), 2u);
+
+    batch[1].hash[0] = 0;
+    BOOST_REQUIRE_EQUAL(verify_signatures(batch), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(elliptic_curve__verify_signatures__dispatcher__expected_index)
+{
+    threadpool pool(3);
+    dispatcher dispatch(pool, "test");
+    const auto three = batch_of_three();
+    auto batch = three;
+    batch.insert(batch.end(), three.begin(), three.end());
+    BOOST_REQUIRE_EQUAL(verify_signatures(batch, dispatch), 6u);
+
+    batch[4].hash[0] = 0;
+    BOOST_REQUIRE_EQUAL(verify_signatures(batch, dispatch), 4u);
+
+    batch[1].hash[0] = 0;
+    BOOST_REQUIRE_EQUAL(verify_signatures(batch, dispatch), 1u);
+
+    pool.shutdown();
+    pool.join();
+}
+
 BOOST_AUTO_TEST_CASE(elliptic_curve__ec_add__positive__test)
 {
     ec_secret secret1{ { 1, 2, 3 } };
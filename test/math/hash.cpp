@@ -18,6 +18,8 @@
  */
 #include "hash.hpp"
 
+#include <atomic>
+#include <thread>
 #include <boost/test/unit_test.hpp>
 #include <bitcoin/bitcoin.hpp>
 
@@ -65,6 +67,177 @@ BOOST_AUTO_TEST_CASE(sha512_hash_test)
     BOOST_REQUIRE_EQUAL(encode_base16(long_hash), "77c7ce9a5d86bb386d443bb96390faa120633158699c8844c30b13ab0bf92760b7e4416aea397db91b4ac0e5dd56b8ef7e4b066162ab1fdc088319ce6defc876");
 }
 
+static const std::vector<sha256_implementation> sha256_implementations
+{
+    sha256_implementation::automatic,
+    sha256_implementation::scalar,
+    sha256_implementation::shani,
+    sha256_implementation::sse41,
+    sha256_implementation::avx2
+};
+
+BOOST_AUTO_TEST_CASE(sha256_hash__every_implementation__expected)
+{
+    const auto original = get_sha256_implementation();
+
+    for (const auto value: sha256_implementations)
+    {
+        if (!set_sha256_implementation(value))
+        {
+            BOOST_REQUIRE(!sha256_supported(value));
+            continue;
+        }
+
+        BOOST_REQUIRE(get_sha256_implementation() == value);
+
+        for (const auto& result: sha256_tests)
+        {
+            data_chunk data;
+            BOOST_REQUIRE(decode_base16(data, result.input));
+            BOOST_REQUIRE_EQUAL(encode_base16(sha256_hash(data)), result.result);
+        }
+
+        // Spans multiple blocks in a single update.
+        const data_chunk million(1000000, 'a');
+        BOOST_REQUIRE_EQUAL(encode_base16(sha256_hash(million)), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+
+    BOOST_REQUIRE(set_sha256_implementation(original));
+}
+
+BOOST_AUTO_TEST_CASE(sha256_hash__every_implementation__matches_scalar)
+{
+    const auto original = get_sha256_implementation();
+
+    data_chunk data(1024);
+    for (size_t index = 0; index < data.size(); ++index)
+        data[index] = static_cast<uint8_t>(index * 7 + 3);
+
+    // Every length across the 64 byte block and 80 byte header boundaries.
+    for (size_t length = 0; length <= data.size(); ++length)
+    {
+        const data_slice slice(data.data(), data.data() + length);
+        BOOST_REQUIRE(set_sha256_implementation(sha256_implementation::scalar));
+        const auto expected = sha256_hash(slice);
+        const auto expected_split = sha256_hash(slice, slice);
+
+        for (const auto value: sha256_implementations)
+        {
+            if (!set_sha256_implementation(value))
+                continue;
+
+            BOOST_REQUIRE(sha256_hash(slice) == expected);
+            BOOST_REQUIRE(sha256_hash(slice, slice) == expected_split);
+        }
+    }
+
+    BOOST_REQUIRE(set_sha256_implementation(original));
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hashes__every_implementation__matches_bitcoin_hash)
+{
+    const auto original = get_sha256_implementation();
+
+    data_chunk data(17 * 80);
+    for (size_t index = 0; index < data.size(); ++index)
+        data[index] = static_cast<uint8_t>(index * 13 + 5);
+
+    // Merkle pairs, headers and sizes around the padding boundaries, with
+    // counts that leave partial batches of vector lanes.
+    for (const size_t size: { 32, 55, 56, 64, 80 })
+    {
+        for (const auto value: sha256_implementations)
+        {
+            if (!set_sha256_implementation(value))
+                continue;
+
+            for (size_t count = 0; count <= 17; ++count)
+            {
+                const data_slice slice(data.data(), data.data() + count * size);
+                hash_list hashes(count);
+                bitcoin_hashes(hashes.data(), slice, size);
+
+                for (size_t index = 0; index < count; ++index)
+                {
+                    const auto input = data.data() + index * size;
+                    BOOST_REQUIRE(hashes[index] == bitcoin_hash({ input, input + size }));
+                }
+            }
+        }
+    }
+
+    BOOST_REQUIRE(set_sha256_implementation(original));
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hashes__aliased_pairs__matches_bitcoin_hash)
+{
+    const auto original = get_sha256_implementation();
+
+    for (const auto value: sha256_implementations)
+    {
+        if (!set_sha256_implementation(value))
+            continue;
+
+        hash_list pairs(18);
+        for (size_t index = 0; index < pairs.size(); ++index)
+            pairs[index] = sha256_hash(to_little_endian(static_cast<uint32_t>(index)));
+
+        hash_list expected;
+        for (size_t index = 0; index < pairs.size(); index += 2)
+            expected.push_back(bitcoin_hash(build_chunk({ pairs[index], pairs[index + 1] })));
+
+        const auto begin = pairs.front().data();
+        bitcoin_hashes(pairs.data(), { begin, begin + pairs.size() * hash_size }, 2 * hash_size);
+        pairs.resize(expected.size());
+        BOOST_REQUIRE(pairs == expected);
+    }
+
+    BOOST_REQUIRE(set_sha256_implementation(original));
+}
+
+BOOST_AUTO_TEST_CASE(sha256_hash__unsupported_implementation__false)
+{
+    const auto original = get_sha256_implementation();
+    BOOST_REQUIRE(sha256_supported(sha256_implementation::scalar));
+    BOOST_REQUIRE_EQUAL(set_sha256_implementation(sha256_implementation::shani), sha256_supported(sha256_implementation::shani));
+    BOOST_REQUIRE(set_sha256_implementation(original));
+}
+
+BOOST_AUTO_TEST_CASE(bitcoin_hashes__concurrent_selection__matches_expected)
+{
+    const auto original = get_sha256_implementation();
+
+    data_chunk data(16 * 80);
+    for (size_t index = 0; index < data.size(); ++index)
+        data[index] = static_cast<uint8_t>(index * 7 + 3);
+
+    hash_list expected(16);
+    bitcoin_hashes(expected.data(), data, 80);
+    const auto whole = bitcoin_hash(data);
+
+    std::atomic<bool> done(false);
+    std::thread selector([&done]()
+    {
+        while (!done.load())
+            for (const auto value: sha256_implementations)
+                set_sha256_implementation(value);
+    });
+
+    auto matched = true;
+    for (size_t round = 0; round < 1000; ++round)
+    {
+        hash_list hashes(16);
+        bitcoin_hashes(hashes.data(), data, 80);
+        matched &= (hashes == expected);
+        matched &= (bitcoin_hash(data) == whole);
+    }
+
+    done.store(true);
+    selector.join();
+    BOOST_REQUIRE(matched);
+    BOOST_REQUIRE(set_sha256_implementation(original));
+}
+
 BOOST_AUTO_TEST_CASE(hmac_sha256_hash_test)
 {
     const data_chunk chunk{ 'd', 'a', 't', 'a' };
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(public_key_cache_tests)
+
+#define COMPRESSED "03bc88a1bd6ebac38e9a9ed58eda735352ad10650e235499b7318315cc26c9b55b"
+#define SIGHASH "ed8f9b40c2d349c8a7e58cebe79faa25c21b6bb85b874901f72a1b3f1ad0a67f"
+#define SIGNATURE "3045022100bc494fbd09a8e77d8266e2abdea9aef08b9e71b451c7d8de9f63cda33a62437802206b93edd6af7c659db42c579eb34a3a4cb60c28b5a6bc86fd5266d42f6b8bb67d"
+
+static public_key_cache::parsed_key make_parsed(uint8_t fill)
+{
+    public_key_cache::parsed_key parsed;
+    parsed.fill(fill);
+    return parsed;
+}
+
+BOOST_AUTO_TEST_CASE(public_key_cache__find__empty__false_and_miss)
+{
+    public_key_cache instance;
+    public_key_cache::parsed_key out;
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    BOOST_REQUIRE(!instance.find(out, point));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(public_key_cache__find__stored__true_expected_and_hit)
+{
+    public_key_cache instance;
+    public_key_cache::parsed_key out;
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    instance.store(point, make_parsed(42));
+    BOOST_REQUIRE(instance.find(out, point));
+    BOOST_REQUIRE(out == make_parsed(42));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(public_key_cache__find__truncated_point__false)
+{
+    public_key_cache instance;
+    public_key_cache::parsed_key out;
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    instance.store(point, make_parsed(42));
+    const data_chunk truncated(point.begin(), point.end() - 1);
+    BOOST_REQUIRE(!instance.find(out, truncated));
+}
+
+BOOST_AUTO_TEST_CASE(public_key_cache__store__bounded__capacity_not_exceeded)
+{
+    public_key_cache instance(1, 1);
+    BOOST_REQUIRE_EQUAL(instance.capacity(), 4u);
+
+    data_chunk point(ec_compressed_size, 0x02);
+    public_key_cache::parsed_key out;
+    size_t found = 0;
+
+    for (size_t index = 0; index < 16; ++index)
+    {
+        point[1] = static_cast<uint8_t>(index);
+        instance.store(point, make_parsed(static_cast<uint8_t>(index)));
+    }
+
+    for (size_t index = 0; index < 16; ++index)
+    {
+        point[1] = static_cast<uint8_t>(index);
+        if (instance.find(out, point))
+        {
+            BOOST_REQUIRE(out == make_parsed(static_cast<uint8_t>(index)));
+            ++found;
+        }
+    }
+
+    BOOST_REQUIRE(found > 0u);
+    BOOST_REQUIRE(found <= instance.capacity());
+}
+
+BOOST_AUTO_TEST_CASE(public_key_cache__clear__stored__false_and_counters_reset)
+{
+    public_key_cache instance;
+    public_key_cache::parsed_key out;
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    instance.store(point, make_parsed(42));
+    BOOST_REQUIRE(instance.find(out, point));
+    instance.clear();
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE(!instance.find(out, point));
+}
+
+BOOST_AUTO_TEST_CASE(public_key_cache__verify_signature__installed__parsed_once)
+{
+    ec_signature signature;
+    const hash_digest sighash = hash_literal(SIGHASH);
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    der_signature distinguished;
+    BOOST_REQUIRE(decode_base16(distinguished, SIGNATURE));
+    BOOST_REQUIRE(parse_signature(signature, distinguished, false));
+
+    public_key_cache instance;
+    set_public_key_cache(&instance);
+    const auto first = verify_signature(point, sighash, signature);
+    const auto second = verify_signature(point, sighash, signature);
+    const auto batch = verify_signatures({ { point, sighash, signature } });
+
+    // Invalidate the signature, the cached key must not validate it.
+    signature[10] = 110;
+    const auto invalid = verify_signature(point, sighash, signature);
+    set_public_key_cache(nullptr);
+
+    BOOST_REQUIRE(first);
+    BOOST_REQUIRE(second);
+    BOOST_REQUIRE_EQUAL(batch, 1u);
+    BOOST_REQUIRE(!invalid);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.hits(), 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(signature_cache_tests)
+
+#define COMPRESSED "03bc88a1bd6ebac38e9a9ed58eda735352ad10650e235499b7318315cc26c9b55b"
+#define SIGHASH "ed8f9b40c2d349c8a7e58cebe79faa25c21b6bb85b874901f72a1b3f1ad0a67f"
+#define EC_SIGNATURE "4832febef8b31c7c922a15cb4063a43ab69b099bba765e24facef50dfbb4d057928ed5c6b6886562c2fe6972fd7c7f462e557129067542cce6b37d72e5ea5037"
+
+BOOST_AUTO_TEST_CASE(signature_cache__contains__empty__false_and_miss)
+{
+    signature_cache instance;
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    BOOST_REQUIRE(!instance.contains(hash_literal(SIGHASH), point, base16_literal(EC_SIGNATURE)));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(signature_cache__contains__stored__true_and_hit)
+{
+    signature_cache instance;
+    const hash_digest sighash = hash_literal(SIGHASH);
+    const ec_signature signature = base16_literal(EC_SIGNATURE);
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    instance.store(sighash, point, signature);
+    BOOST_REQUIRE(instance.contains(sighash, point, signature));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(signature_cache__contains__different_sighash__false)
+{
+    signature_cache instance;
+    const ec_signature signature = base16_literal(EC_SIGNATURE);
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    instance.store(hash_literal(SIGHASH), point, signature);
+    BOOST_REQUIRE(!instance.contains(null_hash, point, signature));
+}
+
+BOOST_AUTO_TEST_CASE(signature_cache__clear__stored__false_and_counters_reset)
+{
+    signature_cache instance;
+    const hash_digest sighash = hash_literal(SIGHASH);
+    const ec_signature signature = base16_literal(EC_SIGNATURE);
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    instance.store(sighash, point, signature);
+    BOOST_REQUIRE(instance.contains(sighash, point, signature));
+    instance.clear();
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE(!instance.contains(sighash, point, signature));
+}
+
+BOOST_AUTO_TEST_CASE(signature_cache__capacity__small_budget__bounded)
+{
+    static const size_t shards = 2;
+    signature_cache instance(0, shards);
+    BOOST_REQUIRE_EQUAL(instance.capacity(), shards * 4u);
+
+    const ec_signature signature = base16_literal(EC_SIGNATURE);
+    const auto point = to_chunk(base16_literal(COMPRESSED));
+    hash_digest sighash = null_hash;
+
+    for (uint8_t index = 0; index < 64; ++index)
+    {
+        sighash[0] = index;
+        instance.store(sighash, point, signature);
+    }
+
+    size_t found = 0;
+    for (uint8_t index = 0; index < 64; ++index)
+    {
+        sighash[0] = index;
+        found += instance.contains(sighash, point, signature) ? 1 : 0;
+    }
+
+    BOOST_REQUIRE(found <= instance.capacity());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::message;
+
+BOOST_AUTO_TEST_SUITE(header_batch_tests)
+
+// Regtest proof of work, which any nonce satisfies half of the time.
+static const uint32_t easy_bits = 0x207fffff;
+
+// Headers at the invalid index have zero bits, which fails proof of work.
+static headers make_headers(size_t count, const hash_digest& previous,
+    size_t invalid=max_size_t)
+{
+    headers instance;
+    auto& elements = instance.elements();
+    auto link = previous;
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        header element(1u, link, null_hash, index, easy_bits, 0);
+
+        if (index == invalid)
+            element.set_bits(0);
+        else
+            while (!element.is_valid_proof_of_work(false))
+                element.set_nonce(element.nonce() + 1);
+
+        elements.push_back(element);
+        link = element.hash();
+    }
+
+    return instance;
+}
+
+static header_batch make_batch(const headers& message)
+{
+    header_batch batch;
+    BOOST_REQUIRE(batch.from_data(version::level::maximum,
+        message.to_data(version::level::maximum)));
+    return batch;
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__from_data__empty__valid_empty)
+{
+    const auto batch = make_batch(headers{});
+    BOOST_REQUIRE(batch.empty());
+    BOOST_REQUIRE_EQUAL(batch.check(null_hash, false), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__from_data__headers__expected_hashes)
+{
+    const auto message = make_headers(10, null_hash);
+    const auto batch = make_batch(message);
+    BOOST_REQUIRE_EQUAL(batch.size(), 10u);
+
+    for (size_t index = 0; index < batch.size(); ++index)
+    {
+        const auto& element = message.elements()[index];
+        BOOST_REQUIRE(batch.hashes()[index] == element.hash());
+        BOOST_REQUIRE(batch.get(index) == element);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__from_data__insufficient_bytes__failure)
+{
+    auto data = make_headers(2, null_hash).to_data(version::level::maximum);
+    data.pop_back();
+    header_batch batch;
+    BOOST_REQUIRE(!batch.from_data(version::level::maximum, data));
+    BOOST_REQUIRE(batch.empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__from_data__nonzero_transaction_count__failure)
+{
+    auto data = make_headers(1, null_hash).to_data(version::level::maximum);
+    data.back() = 0x01;
+    header_batch batch;
+    BOOST_REQUIRE(!batch.from_data(version::level::maximum, data));
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__check__valid_chain__size)
+{
+    const auto previous = bitcoin_hash(to_chunk("previous"));
+    const auto batch = make_batch(make_headers(20, previous));
+    BOOST_REQUIRE_EQUAL(batch.check(previous, false), 20u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__check__first_unlinked__zero)
+{
+    const auto batch = make_batch(make_headers(20, null_hash));
+    BOOST_REQUIRE_EQUAL(batch.check(bitcoin_hash(to_chunk("other")), false), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__check__broken_link__index)
+{
+    auto message = make_headers(20, null_hash);
+    auto& elements = message.elements();
+    elements[12].set_previous_block_hash(null_hash);
+    BOOST_REQUIRE_EQUAL(make_batch(message).check(null_hash, false), 12u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__check__retarget_limit__first_header)
+{
+    // Regtest bits exceed the mainnet proof of work limit.
+    const auto batch = make_batch(make_headers(5, null_hash));
+    BOOST_REQUIRE_EQUAL(batch.check(null_hash, true), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__check__dispatch_valid_chain__size)
+{
+    const auto batch = make_batch(make_headers(2000, null_hash));
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    BOOST_REQUIRE_EQUAL(batch.check(null_hash, dispatch, false), 2000u);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(header_batch__check__dispatch__lowest_failure)
+{
+    const auto message = make_headers(2000, null_hash, 700);
+    const auto batch = make_batch(message);
+    threadpool pool(4);
+    dispatcher dispatch(pool, "test");
+    BOOST_REQUIRE_EQUAL(batch.check(null_hash, dispatch, false), 700u);
+    BOOST_REQUIRE_EQUAL(batch.check(null_hash, false), 700u);
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -593,6 +593,58 @@ BOOST_AUTO_TEST_CASE(headers__to_hashes__non_empty__returns_header_hash_list)
     BOOST_REQUIRE(result == expected);
 }
 
+BOOST_AUTO_TEST_CASE(headers__to_hashes__partially_cached__returns_header_hash_list)
+{
+    const hash_list expected
+    {
+        hash_literal("108127a4f5955a546b78807166d8cb9cd3eee1ed530c14d51095bc798685f4d6"),
+        hash_literal("37ec64a548b6419769b152d70efc4c356f74c7fda567711d98cac3c55c34a890"),
+        hash_literal("d9bbb4b47ca45ec8477cba125262b07b17daae944b54d1780e0a6373d2eed879")
+    };
+
+    const message::headers instance(
+    {
+        header
+        {
+            1u,
+            hash_literal("f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0"),
+            hash_literal("0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f"),
+            10u,
+            100u,
+            1000u
+        },
+        header
+        {
+            2u,
+            hash_literal("abababababababababababababababababababababababababababababababab"),
+            hash_literal("babababababababababababababababababababababababababababababababa"),
+            20u,
+            200u,
+            2000u
+        },
+        header
+        {
+            3u,
+            hash_literal("e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2e2"),
+            hash_literal("7373737373737373737373737373737373737373737373737373737373737373"),
+            30u,
+            300u,
+            3000u
+        }
+    });
+
+    // Only the middle header hash is cached before the batch.
+    BOOST_REQUIRE(instance.elements()[1].hash() == expected[1]);
+    BOOST_REQUIRE(!instance.elements()[0].is_hashed());
+    BOOST_REQUIRE(instance.elements()[1].is_hashed());
+    BOOST_REQUIRE(!instance.elements()[2].is_hashed());
+
+    hash_list result;
+    instance.to_hashes(result);
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    BOOST_REQUIRE(result == expected);
+}
+
 BOOST_AUTO_TEST_CASE(headers__to_inventory__empty__returns_empty_list)
 {
     message::headers instance;
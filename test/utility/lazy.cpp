@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(lazy_tests)
+
+BOOST_AUTO_TEST_CASE(lazy__get__repeated__computes_once)
+{
+    size_t calls = 0;
+    const auto compute = [&calls](uint32_t& value)
+    {
+        value = 42;
+        ++calls;
+    };
+
+    const lazy<uint32_t> instance;
+    BOOST_REQUIRE(!instance.cached());
+    BOOST_REQUIRE_EQUAL(instance.get(compute), 42u);
+    BOOST_REQUIRE_EQUAL(instance.get(compute), 42u);
+    BOOST_REQUIRE(instance.cached());
+    BOOST_REQUIRE_EQUAL(calls, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(lazy__reset__retained_storage__recomputes)
+{
+    lazy<data_chunk> instance;
+    instance.store({ 1, 2, 3 });
+    instance.reset();
+    BOOST_REQUIRE(!instance.cached());
+
+    const auto& result = instance.get([](data_chunk& value)
+    {
+        BOOST_REQUIRE_EQUAL(value.size(), 3u);
+        value.push_back(4);
+    });
+
+    BOOST_REQUIRE_EQUAL(result.size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(lazy__copy__published__copies_value)
+{
+    lazy<uint32_t> instance;
+    instance.store(42);
+    const auto copy = instance;
+    BOOST_REQUIRE(copy.cached());
+    BOOST_REQUIRE_EQUAL(copy.get([](uint32_t& value) { value = 0; }), 42u);
+}
+
+BOOST_AUTO_TEST_CASE(lazy__copy__unpublished__empty)
+{
+    lazy<data_chunk> instance;
+    instance.store({ 1, 2, 3 });
+    instance.reset();
+    const auto copy = instance;
+    BOOST_REQUIRE(!copy.cached());
+}
+
+BOOST_AUTO_TEST_CASE(lazy__get__concurrent__computes_once)
+{
+    static const size_t readers = 8;
+    std::atomic<size_t> calls(0);
+    const lazy<hash_digest> instance;
+    std::vector<std::thread> threads;
+    std::vector<hash_digest> results(readers);
+
+    for (size_t index = 0; index < readers; ++index)
+    {
+        threads.emplace_back([&, index]()
+        {
+            results[index] = instance.get([&calls](hash_digest& value)
+            {
+                std::this_thread::yield();
+                value = bitcoin_hash(to_chunk(base16_literal("42")));
+                ++calls;
+            });
+        });
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    const auto expected = bitcoin_hash(to_chunk(base16_literal("42")));
+    BOOST_REQUIRE_EQUAL(calls.load(), 1u);
+
+    for (const auto& result: results)
+        BOOST_REQUIRE(result == expected);
+}
+
+BOOST_AUTO_TEST_CASE(lazy__get__concurrent_compute_throws__waiter_computes)
+{
+    std::atomic<bool> claimed(false);
+    std::atomic<bool> waiting(false);
+    const lazy<uint32_t> instance;
+    auto thrown = false;
+
+    std::thread first([&]()
+    {
+        try
+        {
+            instance.get([&](uint32_t&)
+            {
+                claimed.store(true);
+
+                while (!waiting.load())
+                    std::this_thread::yield();
+
+                // Give the waiter time to observe the claim.
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                throw std::runtime_error("compute");
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+    });
+
+    while (!claimed.load())
+        std::this_thread::yield();
+
+    uint32_t result = 0;
+    std::thread second([&]()
+    {
+        waiting.store(true);
+        result = instance.get([](uint32_t& value)
+        {
+            value = 42;
+        });
+    });
+
+    first.join();
+    second.join();
+    BOOST_REQUIRE(thrown);
+    BOOST_REQUIRE(instance.cached());
+    BOOST_REQUIRE_EQUAL(result, 42u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
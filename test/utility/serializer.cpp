@@ -49,6 +49,45 @@ BOOST_AUTO_TEST_CASE(roundtrip_serialize_deserialize)
     BOOST_REQUIRE(reader.is_exhausted());
 }
 
+BOOST_AUTO_TEST_CASE(hash_writer__writes__hashes_serialization)
+{
+    data_chunk data(1 + 2 + 4 + 8 + 4 + 4 + 3 + 6 + 8 + 5);
+    auto writer = make_unsafe_serializer(data.begin());
+    hash_writer sink;
+
+    const auto write = [](bc::writer& out)
+    {
+        out.write_byte(0x80);
+        out.write_2_bytes_little_endian(0x8040);
+        out.write_4_bytes_little_endian(0x80402010);
+        out.write_8_bytes_little_endian(0x8040201011223344);
+        out.write_4_bytes_big_endian(0x80402010);
+        out.write_variable_little_endian(1234);
+        out.write_bytes(to_chunk(to_little_endian<uint32_t>(0xbadf00d)));
+        out.write_string("hello");
+        out.write_string("world", 8);
+        out.skip(5);
+    };
+
+    write(writer);
+    write(sink);
+
+    // A copy continues from the same state.
+    auto copy = sink;
+    BOOST_REQUIRE(copy.sha256_hash() == sha256_hash(data));
+
+    // As does an assigned copy, and a move.
+    copy = sink;
+    const auto moved = std::move(copy);
+    auto assigned = hash_writer{};
+    assigned = moved;
+    BOOST_REQUIRE(assigned.sha256_hash() == sha256_hash(data));
+    BOOST_REQUIRE(sink.bitcoin_hash() == bitcoin_hash(data));
+
+    // Hashing resets the writer.
+    BOOST_REQUIRE(sink.sha256_hash() == sha256_hash(data_chunk{}));
+}
+
 BOOST_AUTO_TEST_CASE(deserializer_exhaustion)
 {
     data_chunk data(42);
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(sliding_window_tests)
+
+typedef sliding_window<uint32_t> window;
+
+static std::vector<uint32_t> to_vector(const window& values)
+{
+    return std::vector<uint32_t>(values.begin(), values.end());
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__construct__default__empty)
+{
+    const window instance;
+    BOOST_REQUIRE(instance.empty());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.begin() == instance.end());
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__construct__initializer_list__expected)
+{
+    const window instance{ 1, 2, 3 };
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.front(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.back(), 3u);
+    BOOST_REQUIRE_EQUAL(instance[1], 2u);
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__push_back_pop_front__many__keeps_window)
+{
+    window instance;
+
+    for (uint32_t value = 0; value < 1000; ++value)
+    {
+        instance.push_back(value);
+
+        if (instance.size() > 11)
+            instance.pop_front();
+    }
+
+    BOOST_REQUIRE_EQUAL(instance.size(), 11u);
+    BOOST_REQUIRE_EQUAL(instance.front(), 989u);
+    BOOST_REQUIRE_EQUAL(instance.back(), 999u);
+    BOOST_REQUIRE_EQUAL(*instance.rbegin(), 999u);
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__push_back__copies__values_independent)
+{
+    window parent{ 1, 2, 3 };
+    auto first = parent;
+    auto second = parent;
+
+    // The first child appends in place, the second must relocate.
+    first.push_back(4);
+    second.push_back(5);
+    first.pop_front();
+
+    BOOST_REQUIRE(to_vector(parent) == (std::vector<uint32_t>{ 1, 2, 3 }));
+    BOOST_REQUIRE(to_vector(first) == (std::vector<uint32_t>{ 2, 3, 4 }));
+    BOOST_REQUIRE(to_vector(second) == (std::vector<uint32_t>{ 1, 2, 3, 5 }));
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__push_back__chain_of_copies__ancestors_unchanged)
+{
+    std::vector<window> states{ window{ 0 } };
+
+    for (uint32_t value = 1; value < 200; ++value)
+    {
+        auto next = states.back();
+        next.push_back(value);
+
+        if (next.size() > 5)
+            next.pop_front();
+
+        states.push_back(next);
+    }
+
+    for (uint32_t height = 0; height < states.size(); ++height)
+    {
+        const auto& state = states[height];
+        BOOST_REQUIRE_EQUAL(state.back(), height);
+        BOOST_REQUIRE_EQUAL(state.size(), std::min(height + 1u, 5u));
+        BOOST_REQUIRE_EQUAL(state.front(), height + 1u - state.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__mutable_access__shared__copy_unchanged)
+{
+    window original{ 1, 2, 3 };
+    auto copy = original;
+    copy[0] = 42;
+    *copy.rbegin() = 43;
+
+    BOOST_REQUIRE(to_vector(original) == (std::vector<uint32_t>{ 1, 2, 3 }));
+    BOOST_REQUIRE(to_vector(copy) == (std::vector<uint32_t>{ 42, 2, 43 }));
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__resize__grow_and_shrink__expected)
+{
+    window instance{ 1, 2, 3 };
+    instance.resize(5);
+    BOOST_REQUIRE(to_vector(instance) == (std::vector<uint32_t>{ 1, 2, 3, 0, 0 }));
+    instance.resize(2);
+    BOOST_REQUIRE(to_vector(instance) == (std::vector<uint32_t>{ 1, 2 }));
+    instance.push_back(7);
+    BOOST_REQUIRE(to_vector(instance) == (std::vector<uint32_t>{ 1, 2, 7 }));
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__clear__populated__empty)
+{
+    window instance{ 1, 2, 3 };
+    instance.clear();
+    BOOST_REQUIRE(instance.empty());
+    instance.push_back(4);
+    BOOST_REQUIRE_EQUAL(instance.front(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(sliding_window__push_back__concurrent_copies__each_keeps_own_value)
+{
+    const window parent{ 1, 2, 3 };
+    std::vector<window> children(8, parent);
+    std::vector<std::thread> threads;
+
+    for (uint32_t index = 0; index < children.size(); ++index)
+        threads.emplace_back([&children, index]()
+        {
+            children[index].push_back(index);
+        });
+
+    for (auto& thread: threads)
+        thread.join();
+
+    for (uint32_t index = 0; index < children.size(); ++index)
+        BOOST_REQUIRE(to_vector(children[index]) ==
+            (std::vector<uint32_t>{ 1, 2, 3, index }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()